@@ -7,11 +7,21 @@ int main()
     else
         printf("-DLIN ");
 
-    printf("-DSIZEOF_VOID_P=%d -DSIZEOF_LONG=%d -DSIZEOF_INT=%d\n",
+    printf("-DSIZEOF_VOID_P=%d -DSIZEOF_LONG=%d -DSIZEOF_INT=%d",
            (int)sizeof(void*),
            (int)sizeof(long),
            (int)sizeof(int) );
 
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    // vector kernels of the TL simulator ( src/threshold/threSim.c )
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2"))
+        printf(" -DABC_USE_SSE2");
+    if (__builtin_cpu_supports("avx2"))
+        printf(" -DABC_USE_AVX2");
+#endif
+
+    printf("\n");
 
     return 0;
 }
@@ -17,7 +17,7 @@ for n_input in a:
       M = 'exp_TCAD/dnn_mnist/benchmark/binarized_dnn_%d_%d_16.th' % (n_input, n_layer)
       f = 'exp_TCAD/dnn_mnist/opb/%d_%d.opb' % (n_input, n_layer)
       g = 'exp_TCAD/dnn_mnist/log/%d_%d.log' % (n_input, n_layer)
-      cmd = './bin/abc -c \"thverify ' + N + ' ' + M + '\"'
+      cmd = './bin/abc -c \"thverify -w -s ' + N + ' ' + M + '\"'
       sp.run(cmd, shell=True)
       cmd = 'mv compTH.opb ' + f
       sp.run(cmd, shell=True)
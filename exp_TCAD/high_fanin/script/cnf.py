@@ -22,7 +22,7 @@ size_df = pd.DataFrame(np.zeros(shape=(N, len(a))), columns=a)
 for n_input in a:
    for i in range(N):
       v = 'exp_TCAD/high_fanin/rand_tl/%d_%d.th' % (n_input, i)
-      cmd = './bin/abc -c \"thverify -V 1 ' + v + ' ' + v + '\"'
+      cmd = './bin/abc -c \"thverify -V 1 -w -s ' + v + ' ' + v + '\"'
       try:
          start = time.time()
          sp.call(cmd, shell=True, timeout=TO)
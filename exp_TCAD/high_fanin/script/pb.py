@@ -20,7 +20,7 @@ size_df = pd.DataFrame(np.zeros(shape=(N, len(a))), columns=a)
 for n_input in a:
    for i in range(N):
       v = 'exp_TCAD/high_fanin/rand_tl/%d_%d.th' % (n_input, i)
-      cmd = './bin/abc -c \"thverify ' + v + ' ' + v + '\"'
+      cmd = './bin/abc -c \"thverify -w -s ' + v + ' ' + v + '\"'
       start = time.time()
       sp.run(cmd, shell=True)
       elapsed = time.time()-start
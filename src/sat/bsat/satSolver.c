@@ -477,28 +477,28 @@ static inline int sat_solver_enqueue(sat_solver* s, lit l, int from)
 #endif
     if (var_value(s, v) != varX)
         return var_value(s, v) == lit_sign(l);
-    else{
-/*
-        if ( s->pCnfFunc )
-        {
-            if ( lit_sign(l) )
-            {
-                if ( (s->loads[v] & 1) == 0 )
-                {
-                    s->loads[v] ^= 1;
-                    s->pCnfFunc( s->pCnfMan, l );
-                }
-            }
-            else
-            {
-                if ( (s->loads[v] & 2) == 0 )
-                {
-                    s->loads[v] ^= 2;
-                    s->pCnfFunc( s->pCnfMan, l );
-                }
-            }
-        }
-*/
+    else{
+/*
+        if ( s->pCnfFunc )
+        {
+            if ( lit_sign(l) )
+            {
+                if ( (s->loads[v] & 1) == 0 )
+                {
+                    s->loads[v] ^= 1;
+                    s->pCnfFunc( s->pCnfMan, l );
+                }
+            }
+            else
+            {
+                if ( (s->loads[v] & 2) == 0 )
+                {
+                    s->loads[v] ^= 2;
+                    s->pCnfFunc( s->pCnfMan, l );
+                }
+            }
+        }
+*/
         // New fact -- store it.
 #ifdef VERBOSEDEBUG
         printf(L_IND"bind("L_LIT")\n", L_ind, L_lit(l));
@@ -525,6 +525,133 @@ static inline int sat_solver_assume(sat_solver* s, lit l){
 }
 
 
+//=================================================================================================
+// Pseudo-Boolean constraints:
+//
+// Constraint i is  w_0*l_0 + ... + w_n-1*l_n-1 >= bound  with bound >= w_0 >= ... >= w_n-1 > 0.
+// Its slack is the weight of the literals not yet false minus the bound. A literal counts as
+// false once its negation is taken from the propagation queue, and counts again when that
+// assignment is cancelled. The constraint is violated when the slack is negative and implies
+// each unassigned literal heavier than the slack. The reasons are the heaviest false literals
+// that suffice; they are kept in pb_expl under negative even handles, and dropped on
+// backtracking, so they never enter the clause database.
+
+static inline int* sat_solver_pb_read(sat_solver* s, int i) { return veci_begin(&s->pb_data) + veci_begin(&s->pb_starts)[i]; }
+static inline int  sat_solver_pb_lit (int* pPb, int k)      { return pPb[2+2*k]; }
+static inline int  sat_solver_pb_w   (int* pPb, int k)      { return pPb[3+2*k]; }
+
+// returns the reason of Implied of weight w, or the conflict if Implied is lit_Undef
+static int sat_solver_pb_reason(sat_solver* s, int i, lit Implied, int w)
+{
+    int*  pPb  = sat_solver_pb_read(s, i);
+    veci* expl = &s->pb_expl;
+    int   off  = veci_size(expl);
+    lit*  lits, tmp, l;
+    int   k, j, n, iMax, need = pPb[1] - w;
+
+    if (Implied != lit_Undef && sat_solver_dl(s) == 0)
+        return 0;
+    // the false literals must outweigh the initial slack less the weight of Implied
+    veci_push(expl,0);
+    if (Implied != lit_Undef)
+        veci_push(expl,Implied);
+    for (k = 0; k < pPb[0] && need >= 0; k++){
+        l = sat_solver_pb_lit(pPb,k);
+        if (var_value(s, lit_var(l)) == !lit_sign(l)){
+            veci_push(expl,l);
+            need -= sat_solver_pb_w(pPb,k);
+        }
+    }
+    assert(need < 0);
+    lits = veci_begin(expl) + off + 1;
+    n    = veci_size(expl) - off - 1;
+    veci_begin(expl)[off] = n;
+
+    if (Implied != lit_Undef){
+        assert(n > 1);
+        if (n == 2){
+            veci_resize(expl,off);
+            return clause_from_lit(lit_neg(lits[1]));
+        }
+    }else{
+        // a conflict is analyzed right away, in order
+        for (k = 0; k < 2 && k < n; k++){
+            for (iMax = k, j = k+1; j < n; j++)
+                if (var_level(s, lit_var(lits[j])) > var_level(s, lit_var(lits[iMax])))
+                    iMax = j;
+            tmp = lits[k]; lits[k] = lits[iMax]; lits[iMax] = tmp;
+        }
+        s->pb_confl = off;
+    }
+    return -2*(off+1);
+}
+
+// literals of a clause or explanation ; the first one is the implied literal
+static inline lit* sat_solver_reason_lits(sat_solver* s, int h, int* pnLits)
+{
+    clause* c;
+    if (h < 0){
+        int* pExpl = veci_begin(&s->pb_expl) - h/2 - 1;
+        *pnLits = pExpl[0];
+        return pExpl + 1;
+    }
+    c = clause_read(s, h);
+    *pnLits = clause_size(c);
+    return clause_begin(c);
+}
+
+// updates the constraints falsified by p ; returns the conflict, if any
+static int sat_solver_pb_propagate(sat_solver* s, lit p)
+{
+    veci* occs   = &s->pb_occs[p];
+    int*  pOccs  = veci_begin(occs);
+    int*  pSlack = veci_begin(&s->pb_slack);
+    int   i, k, iPb, * pPb, hConfl = 0;
+
+    for (i = 0; i < veci_size(occs); i += 2){
+        iPb = pOccs[i];
+        pPb = sat_solver_pb_read(s, iPb);
+        pSlack[iPb] -= sat_solver_pb_w(pPb, pOccs[i+1]);
+        // keep the slacks exact for the undo even after a conflict
+        if (hConfl)
+            continue;
+        if (pSlack[iPb] < 0){
+            hConfl = sat_solver_pb_reason(s, iPb, lit_Undef, 0);
+            continue;
+        }
+        for (k = 0; k < pPb[0] && sat_solver_pb_w(pPb,k) > pSlack[iPb]; k++)
+            if (var_value(s, lit_var(sat_solver_pb_lit(pPb,k))) == varX)
+                sat_solver_enqueue(s, sat_solver_pb_lit(pPb,k), sat_solver_pb_reason(s, iPb, sat_solver_pb_lit(pPb,k), sat_solver_pb_w(pPb,k)));
+    }
+    return hConfl;
+}
+
+// restores the slacks of the literals taken from the queue at bound or later
+// and drops the explanations of the assignments at bound or later
+static void sat_solver_pb_undo(sat_solver* s, int bound)
+{
+    int*  pSlack = veci_begin(&s->pb_slack);
+    int   c, i, h, * pOccs, size = veci_size(&s->pb_expl);
+    veci* occs;
+
+    for (c = s->qhead-1; c >= bound; c--){
+        occs  = &s->pb_occs[s->trail[c]];
+        pOccs = veci_begin(occs);
+        for (i = 0; i < veci_size(occs); i += 2)
+            pSlack[pOccs[i]] += sat_solver_pb_w(sat_solver_pb_read(s, pOccs[i]), pOccs[i+1]);
+    }
+    // the explanations follow the trail, the last conflict comes after them
+    if (s->pb_confl >= 0)
+        size = s->pb_confl;
+    for (c = bound; c < s->qtail; c++)
+        if ((h = s->reasons[lit_var(s->trail[c])]) < 0){
+            size = Abc_MinInt(size, -h/2 - 1);
+            break;
+        }
+    veci_resize(&s->pb_expl, size);
+    s->pb_confl = -1;
+}
+
 static void sat_solver_canceluntil(sat_solver* s, int level) {
     int      bound;
     int      lastLev;
@@ -543,6 +670,8 @@ static void sat_solver_canceluntil(sat_solver* s, int level) {
 //        bound = 0;
     ////////////////////////////////////////
 
+    if ( s->pb_occs )
+        sat_solver_pb_undo(s, bound);
     for (c = s->qtail-1; c >= bound; c--) {
         int     x  = lit_var(s->trail[c]);
         var_set_value(s, x, varX);
@@ -555,9 +684,9 @@ static void sat_solver_canceluntil(sat_solver* s, int level) {
         order_unassigned(s,lit_var(s->trail[c]));
 
     s->qhead = s->qtail = bound;
-    veci_resize(&s->trail_lim,level);
-    // update decision level
-    s->iDeciVar = level;
+    veci_resize(&s->trail_lim,level);
+    // update decision level
+    s->iDeciVar = level;
 }
 
 static void sat_solver_canceluntil_rollback(sat_solver* s, int NewBound) {
@@ -567,6 +696,8 @@ static void sat_solver_canceluntil_rollback(sat_solver* s, int NewBound) {
     assert( s->qtail == s->qhead );
     assert( s->qtail >= NewBound );
 
+    if ( s->pb_occs )
+        sat_solver_pb_undo(s, NewBound);
     for (c = s->qtail-1; c >= NewBound; c--) 
     {
         x = lit_var(s->trail[c]);
@@ -656,10 +787,9 @@ static int sat_solver_lit_removable(sat_solver* s, int x, int minl)
                 }
             }
         }else{
-            clause* c = clause_read(s, s->reasons[v]);
-            lit* lits = clause_begin(c);
-            int  i;
-            for (i = 1; i < clause_size(c); i++){
+            int  i, nLits;
+            lit* lits = sat_solver_reason_lits(s, s->reasons[v], &nLits);
+            for (i = 1; i < nLits; i++){
                 int v = lit_var(lits[i]);
                 if (!var_tag(s,v) && var_level(s, v)){
                     if (s->reasons[v] != 0 && ((1 << (var_level(s, v) & 31)) & minl)){
@@ -730,7 +860,7 @@ void Solver::analyzeFinal(Clause* confl, bool skip_first)
 
 static void sat_solver_analyze_final(sat_solver* s, int hConf, int skip_first)
 {
-    clause* conf = clause_read(s, hConf);
+    int nConf, * pConf = sat_solver_reason_lits(s, hConf, &nConf);
     int i, j, start;
     veci_resize(&s->conf_final,0);
     if ( s->root_level == 0 )
@@ -738,9 +868,9 @@ static void sat_solver_analyze_final(sat_solver* s, int hConf, int skip_first)
     assert( veci_size(&s->tagged) == 0 );
 //    assert( s->tags[lit_var(p)] == l_Undef );
 //    s->tags[lit_var(p)] = l_True;
-    for (i = skip_first ? 1 : 0; i < clause_size(conf); i++)
+    for (i = skip_first ? 1 : 0; i < nConf; i++)
     {
-        int x = lit_var(clause_begin(conf)[i]);
+        int x = lit_var(pConf[i]);
         if (var_level(s, x) > 0)
             var_set_tag(s, x, 1);
     }
@@ -760,9 +890,8 @@ static void sat_solver_analyze_final(sat_solver* s, int hConf, int skip_first)
                         var_set_tag(s, lit_var(q), 1);
                 }
                 else{
-                    clause* c = clause_read(s, s->reasons[x]);
-                    int* lits = clause_begin(c);
-                    for (j = 1; j < clause_size(c); j++)
+                    int nLits, * lits = sat_solver_reason_lits(s, s->reasons[x], &nLits);
+                    for (j = 1; j < nLits; j++)
                         if (var_level(s, lit_var(lits[j])) > 0)
                             var_set_tag(s, lit_var(lits[j]), 1);
                 }
@@ -796,12 +925,12 @@ static void sat_solver_analyze(sat_solver* s, int h, veci* learnt)
                     veci_push(learnt,clause_read_lit(h));
             }
         }else{
-            clause* c = clause_read(s, h);
-            if (clause_learnt(c))
-                act_clause_bump(s,c);
-            lits = clause_begin(c);
-            //printlits(lits,lits+clause_size(c)); printf("\n");
-            for (j = (p == lit_Undef ? 0 : 1); j < clause_size(c); j++){
+            int nLits;
+            if (h > 0 && clause_learnt(clause_read(s, h)))
+                act_clause_bump(s,clause_read(s, h));
+            lits = sat_solver_reason_lits(s, h, &nLits);
+            //printlits(lits,lits+nLits); printf("\n");
+            for (j = (p == lit_Undef ? 0 : 1); j < nLits; j++){
                 int x = lit_var(lits[j]);
                 if (var_tag(s, x) == 0 && var_level(s, x) > 0){
                     var_set_tag(s, x, 1);
@@ -879,8 +1008,8 @@ static void sat_solver_analyze(sat_solver* s, int h, veci* learnt)
     }
 #endif
 }
-
-//#define TEST_CNF_LOAD
+
+//#define TEST_CNF_LOAD
 
 int sat_solver_propagate(sat_solver* s)
 {
@@ -890,32 +1019,36 @@ int sat_solver_propagate(sat_solver* s)
 
     //printf("sat_solver_propagate\n");
     while (hConfl == 0 && s->qtail - s->qhead > 0){
-        lit p = s->trail[s->qhead++];
-
-#ifdef TEST_CNF_LOAD
-        int v = lit_var(p);
-        if ( s->pCnfFunc )
-        {
-            if ( lit_sign(p) )
-            {
-                if ( (s->loads[v] & 1) == 0 )
-                {
-                    s->loads[v] ^= 1;
-                    s->pCnfFunc( s->pCnfMan, p );
-                }
-            }
-            else
-            {
-                if ( (s->loads[v] & 2) == 0 )
-                {
-                    s->loads[v] ^= 2;
-                    s->pCnfFunc( s->pCnfMan, p );
-                }
-            }
-        }
+        lit p = s->trail[s->qhead++];
+
+        // the constraints first, so that their slacks follow the trail exactly
+        if ( s->pb_occs && (hConfl = sat_solver_pb_propagate(s, p)) )
+            break;
+
+#ifdef TEST_CNF_LOAD
+        int v = lit_var(p);
+        if ( s->pCnfFunc )
         {
-#endif
-
+            if ( lit_sign(p) )
+            {
+                if ( (s->loads[v] & 1) == 0 )
+                {
+                    s->loads[v] ^= 1;
+                    s->pCnfFunc( s->pCnfMan, p );
+                }
+            }
+            else
+            {
+                if ( (s->loads[v] & 2) == 0 )
+                {
+                    s->loads[v] ^= 2;
+                    s->pCnfFunc( s->pCnfMan, p );
+                }
+            }
+        }
+        {
+#endif
+
         veci* ws    = sat_solver_read_wlist(s,p);
         int*  begin = veci_begin(ws);
         int*  end   = begin + veci_size(ws);
@@ -988,10 +1121,10 @@ int sat_solver_propagate(sat_solver* s)
         }
 
         s->stats.inspects += j - veci_begin(ws);
-        veci_resize(ws,j - veci_begin(ws));
-#ifdef TEST_CNF_LOAD
+        veci_resize(ws,j - veci_begin(ws));
+#ifdef TEST_CNF_LOAD
         }
-#endif
+#endif
     }
 
     return hConfl;
@@ -1027,6 +1160,11 @@ sat_solver* sat_solver_new(void)
     veci_new(&s->unit_lits);
     veci_new(&s->temp_clause);
     veci_new(&s->conf_final);
+    veci_new(&s->pb_starts);
+    veci_new(&s->pb_data);
+    veci_new(&s->pb_slack);
+    veci_new(&s->pb_expl);
+    s->pb_confl = -1;
 
     // initialize arrays
     s->wlists    = 0;
@@ -1077,8 +1215,8 @@ void sat_solver_setnvars(sat_solver* s,int n)
 
     if (s->cap < n){
         int old_cap = s->cap;
-        while (s->cap < n) s->cap = s->cap*2+1;
-        if ( s->cap < 50000 )
+        while (s->cap < n) s->cap = s->cap*2+1;
+        if ( s->cap < 50000 )
             s->cap = 50000;
 
         s->wlists    = ABC_REALLOC(veci,   s->wlists,   s->cap*2);
@@ -1086,8 +1224,8 @@ void sat_solver_setnvars(sat_solver* s,int n)
         s->levels    = ABC_REALLOC(int,    s->levels,   s->cap);
         s->assigns   = ABC_REALLOC(char,   s->assigns,  s->cap);
         s->polarity  = ABC_REALLOC(char,   s->polarity, s->cap);
-        s->tags      = ABC_REALLOC(char,   s->tags,     s->cap);
-        s->loads     = ABC_REALLOC(char,   s->loads,    s->cap);
+        s->tags      = ABC_REALLOC(char,   s->tags,     s->cap);
+        s->loads     = ABC_REALLOC(char,   s->loads,    s->cap);
 #ifdef USE_FLOAT_ACTIVITY
         s->activity  = ABC_REALLOC(double,   s->activity, s->cap);
 #else
@@ -1103,6 +1241,11 @@ void sat_solver_setnvars(sat_solver* s,int n)
         s->trail     = ABC_REALLOC(lit,    s->trail,    s->cap);
         s->model     = ABC_REALLOC(int,    s->model,    s->cap);
         memset( s->wlists + 2*old_cap, 0, 2*(s->cap-old_cap)*sizeof(veci) );
+        if ( s->pb_occs )
+        {
+            s->pb_occs = ABC_REALLOC(veci, s->pb_occs,  s->cap*2);
+            memset( s->pb_occs + 2*old_cap, 0, 2*(s->cap-old_cap)*sizeof(veci) );
+        }
     } 
 
     for (var = s->size; var < n; var++){
@@ -1124,8 +1267,8 @@ void sat_solver_setnvars(sat_solver* s,int n)
         s->levels  [var] = 0;
         s->assigns [var] = varX;
         s->polarity[var] = 0;
-        s->tags    [var] = 0;
-        s->loads   [var] = 0;
+        s->tags    [var] = 0;
+        s->loads   [var] = 0;
         s->orderpos[var] = veci_size(&s->order);
         s->reasons [var] = 0;
         s->model   [var] = 0; 
@@ -1155,10 +1298,21 @@ void sat_solver_delete(sat_solver* s)
 //    veci_delete(&s->model);
     veci_delete(&s->act_vars);
     veci_delete(&s->unit_lits);
-    veci_delete(&s->pivot_vars);
+    veci_delete(&s->pivot_vars);
     veci_delete(&s->temp_clause);
-    veci_delete(&s->conf_final);
+    veci_delete(&s->conf_final);
     veci_delete(&s->vDeciVars);    
+    veci_delete(&s->pb_starts);
+    veci_delete(&s->pb_data);
+    veci_delete(&s->pb_slack);
+    veci_delete(&s->pb_expl);
+    if ( s->pb_occs )
+    {
+        int i;
+        for (i = 0; i < s->cap*2; i++)
+            veci_delete(&s->pb_occs[i]);
+        ABC_FREE(s->pb_occs);
+    }
 
     // delete arrays
     if (s->reasons != 0){
@@ -1170,8 +1324,8 @@ void sat_solver_delete(sat_solver* s)
         ABC_FREE(s->levels   );
         ABC_FREE(s->assigns  );
         ABC_FREE(s->polarity );
-        ABC_FREE(s->tags     );
-        ABC_FREE(s->loads    );
+        ABC_FREE(s->tags     );
+        ABC_FREE(s->loads    );
         ABC_FREE(s->activity );
         ABC_FREE(s->activity2);
         ABC_FREE(s->pFreqs   );
@@ -1199,6 +1353,14 @@ void sat_solver_restart( sat_solver* s )
     veci_resize(&s->order, 0);
     for ( i = 0; i < s->size*2; i++ )
         s->wlists[i].size = 0;
+    veci_resize(&s->pb_starts, 0);
+    veci_resize(&s->pb_data, 0);
+    veci_resize(&s->pb_slack, 0);
+    veci_resize(&s->pb_expl, 0);
+    s->pb_confl = -1;
+    if ( s->pb_occs )
+        for ( i = 0; i < s->size*2; i++ )
+            s->pb_occs[i].size = 0;
 
     s->nDBreduces = 0;
 
@@ -1246,8 +1408,8 @@ double sat_solver_memory( sat_solver* s )
     Mem += s->cap * sizeof(int);      // ABC_FREE(s->levels   );
     Mem += s->cap * sizeof(char);     // ABC_FREE(s->assigns  );
     Mem += s->cap * sizeof(char);     // ABC_FREE(s->polarity );
-    Mem += s->cap * sizeof(char);     // ABC_FREE(s->tags     );
-    Mem += s->cap * sizeof(char);     // ABC_FREE(s->loads    );
+    Mem += s->cap * sizeof(char);     // ABC_FREE(s->tags     );
+    Mem += s->cap * sizeof(char);     // ABC_FREE(s->loads    );
 #ifdef USE_FLOAT_ACTIVITY
     Mem += s->cap * sizeof(double);   // ABC_FREE(s->activity );
 #else
@@ -1272,6 +1434,16 @@ double sat_solver_memory( sat_solver* s )
     Mem += s->act_clas.cap * sizeof(int);
     Mem += s->temp_clause.cap * sizeof(int);
     Mem += s->conf_final.cap * sizeof(int);
+    Mem += s->pb_starts.cap * sizeof(int);
+    Mem += s->pb_data.cap * sizeof(int);
+    Mem += s->pb_slack.cap * sizeof(int);
+    Mem += s->pb_expl.cap * sizeof(int);
+    if ( s->pb_occs )
+    {
+        Mem += s->cap * 2 * sizeof(veci);
+        for (i = 0; i < s->cap*2; i++)
+            Mem += s->pb_occs[i].cap * sizeof(int);
+    }
     Mem += Sat_MemMemoryAll( &s->Mem );
     return Mem;
 }
@@ -1356,6 +1528,8 @@ void sat_solver_reducedb(sat_solver* s)
     {
         if ( !s->reasons[i] ) // no reason
             continue;
+        if ( s->reasons[i] < 0 ) // explanation of a PB constraint
+            continue;
         if ( clause_is_lit(s->reasons[i]) ) // 2-lit clause
             continue;
         if ( !clause_learnt_h(pMem, s->reasons[i]) ) // problem clause
@@ -1451,6 +1625,23 @@ void sat_solver_rollback( sat_solver* s )
     // resize learned arrays
     veci_resize(&s->act_clas,  s->stats.learnts);
 
+    // rollback PB constraints (each occurrence list is in constraint order)
+    if ( s->pb_occs )
+    {
+        for ( i = 0; i < s->iVarPivot*2; i++ )
+        {
+            veci* occs = &s->pb_occs[i];
+            while ( veci_size(occs) > 0 && veci_begin(occs)[veci_size(occs)-2] >= s->iPbPivot )
+                veci_resize(occs, veci_size(occs)-2);
+        }
+        for ( i = 2*s->iVarPivot; i < 2*s->size; i++ )
+            s->pb_occs[i].size = 0;
+        if ( s->iPbPivot < veci_size(&s->pb_starts) )
+            veci_resize(&s->pb_data, veci_begin(&s->pb_starts)[s->iPbPivot]);
+        veci_resize(&s->pb_starts, s->iPbPivot);
+        veci_resize(&s->pb_slack,  s->iPbPivot);
+    }
+
     // initialize other vars
     s->size = s->iVarPivot;
     if ( s->size == 0 )
@@ -1487,24 +1678,25 @@ void sat_solver_rollback( sat_solver* s )
         // initialize rollback
         s->iVarPivot              =  0; // the pivot for variables
         s->iTrailPivot            =  0; // the pivot for trail
+        s->iPbPivot               =  0; // the pivot for PB constraints
         s->hProofPivot            =  1; // the pivot for proof records
     }
 }
 
 
 int sat_solver_addclause(sat_solver* s, lit* begin, lit* end)
-{
+{
     int fVerbose = 0;
     lit *i,*j;
     int maxvar;
     lit last;
-    assert( begin < end );
-    if ( fVerbose )
-    {
-        for ( i = begin; i < end; i++ )
-            printf( "%s%d ", (*i)&1 ? "!":"", (*i)>>1 );
-        printf( "\n" );
-    }
+    assert( begin < end );
+    if ( fVerbose )
+    {
+        for ( i = begin; i < end; i++ )
+            printf( "%s%d ", (*i)&1 ? "!":"", (*i)>>1 );
+        printf( "\n" );
+    }
 
     veci_resize( &s->temp_clause, 0 );
     for ( i = begin; i < end; i++ )
@@ -1555,6 +1747,92 @@ int sat_solver_addclause(sat_solver* s, lit* begin, lit* end)
     return true;
 }
 
+/* pre: no variable occurs twice
+ * adds  weights[0]*begin[0] + ... >= bound  ; weights may be negative
+ */
+int sat_solver_addpb(sat_solver* s, lit* begin, lit* end, int* weights, int bound)
+{
+    veci* cls = &s->temp_clause;
+    lit*  pairs, l;
+    int   i, j, k, n, w, maxvar, iPb, slack;
+    ABC_INT64_T sum = 0;
+
+    assert( sat_solver_dl(s) == 0 );
+    for ( maxvar = 0, i = 0; i < end - begin; i++ )
+        maxvar = lit_var(begin[i]) > maxvar ? lit_var(begin[i]) : maxvar;
+    sat_solver_setnvars(s,maxvar+1);
+    // take every top-level assignment into account
+    if ( sat_solver_propagate(s) != 0 )
+        return false;
+
+    // make the weights positive and drop the assigned literals
+    veci_resize( cls, 0 );
+    for ( i = 0; i < end - begin; i++ )
+    {
+        l = begin[i];
+        w = weights[i];
+        assert( !var_tag(s, lit_var(l)) );
+        var_set_tag(s, lit_var(l), 1);
+        if ( w < 0 )
+            l = lit_neg(l), w = -w, bound += w;
+        if ( w == 0 || var_value(s, lit_var(l)) == !lit_sign(l) )
+            continue;
+        if ( var_value(s, lit_var(l)) == lit_sign(l) )
+            bound -= w;
+        else
+            veci_push( cls, l ), veci_push( cls, w );
+    }
+    solver2_clear_tags(s,0);
+    if ( bound <= 0 )
+        return true;
+
+    // sort by decreasing weight and saturate the weights at the bound
+    pairs = veci_begin( cls );
+    n     = veci_size( cls ) / 2;
+    for ( i = 1; i < n; i++ )
+    {
+        l = pairs[2*i];
+        w = pairs[2*i+1];
+        for ( j = i; j > 0 && pairs[2*j-1] < w; j-- )
+            pairs[2*j] = pairs[2*j-2], pairs[2*j+1] = pairs[2*j-1];
+        pairs[2*j] = l;
+        pairs[2*j+1] = w;
+    }
+    for ( k = 0; k < n; k++ )
+    {
+        if ( pairs[2*k+1] > bound )
+            pairs[2*k+1] = bound;
+        sum += pairs[2*k+1];
+    }
+    if ( sum < bound )
+        return false;
+    assert( sum - bound < ABC_INFINITY );
+    slack = (int)(sum - bound);
+
+    // record the constraint
+    iPb = veci_size(&s->pb_starts);
+    veci_push(&s->pb_starts, veci_size(&s->pb_data));
+    veci_push(&s->pb_data, n);
+    veci_push(&s->pb_data, slack);
+    for ( k = 0; k < 2*n; k++ )
+        veci_push(&s->pb_data, pairs[k]);
+    veci_push(&s->pb_slack, slack);
+    if ( s->pb_occs == NULL )
+        s->pb_occs = ABC_CALLOC(veci, s->cap*2);
+    for ( k = 0; k < n; k++ )
+    {
+        veci* occs = &s->pb_occs[lit_neg(pairs[2*k])];
+        if ( occs->ptr == NULL )
+            veci_new(occs);
+        veci_push(occs, iPb);
+        veci_push(occs, k);
+    }
+    // the heaviest literals may be implied already
+    for ( k = 0; k < n && pairs[2*k+1] > slack; k++ )
+        sat_solver_enqueue(s,pairs[2*k],0);
+    return true;
+}
+
 double luby(double y, int x)
 {
     int size, seq;
@@ -1579,12 +1857,12 @@ static lbool sat_solver_search(sat_solver* s, ABC_INT64_T nof_conflicts)
 {
 //    double  var_decay       = 0.95;
 //    double  clause_decay    = 0.999;
-    double  random_var_freq = s->fNotUseRandom ? 0.0 : 0.02;
+    double  random_var_freq = s->fNotUseRandom ? 0.0 : 0.02;
     int fGuided = (veci_size(&s->vDeciVars) > 0);
     ABC_INT64_T  conflictC  = 0;
     veci    learnt_clause;
-    int     i;
-
+    int     i;
+
     assert(s->root_level == sat_solver_dl(s));
 
     s->nRestarts++;
@@ -1592,16 +1870,16 @@ static lbool sat_solver_search(sat_solver* s, ABC_INT64_T nof_conflicts)
 //    s->var_decay = (float)(1 / var_decay   );  // move this to sat_solver_new()
 //    s->cla_decay = (float)(1 / clause_decay);  // move this to sat_solver_new()
 //    veci_resize(&s->model,0);
-    veci_new(&learnt_clause);
-
-    // update variable polarity
-    if ( fGuided )
-    {
-        int * pVars = veci_begin(&s->vDeciVars);
-        for ( i = 0; i < veci_size(&s->vDeciVars); i++ )
-            var_set_polar( s, pVars[i], 0 );
-        s->iDeciVar = 0;
-    }
+    veci_new(&learnt_clause);
+
+    // update variable polarity
+    if ( fGuided )
+    {
+        int * pVars = veci_begin(&s->vDeciVars);
+        for ( i = 0; i < veci_size(&s->vDeciVars); i++ )
+            var_set_polar( s, pVars[i], 0 );
+        s->iDeciVar = 0;
+    }
 
     // use activity factors in every even restart
     if ( (s->nRestarts & 1) && veci_size(&s->act_vars) > 0 )
@@ -1650,14 +1928,14 @@ static lbool sat_solver_search(sat_solver* s, ABC_INT64_T nof_conflicts)
             // NO CONFLICT
             int next;
  
-            // Reached bound on number of conflicts:
-            if ( !fGuided )
+            // Reached bound on number of conflicts:
+            if ( !fGuided )
             {
                 if ((nof_conflicts >= 0 && conflictC >= nof_conflicts) || (s->nRuntimeLimit && (s->stats.conflicts & 63) == 0 && Abc_Clock() > s->nRuntimeLimit)){
                     s->progress_estimate = sat_solver_progress(s);
                     sat_solver_canceluntil(s,s->root_level);
                     veci_delete(&learnt_clause);
-                    return l_Undef; }
+                    return l_Undef; }
             }
 
             // Reached bound on number of conflicts:
@@ -1680,33 +1958,33 @@ static lbool sat_solver_search(sat_solver* s, ABC_INT64_T nof_conflicts)
                 sat_solver_reducedb(s);
 
             // New variable decision:
-            s->stats.decisions++;
-            if ( fGuided )
-            {
-                int nVars = veci_size(&s->vDeciVars);
-                int * pVars = veci_begin(&s->vDeciVars);
-                next = var_Undef;
-                assert( s->iDeciVar <= nVars );
-                while ( s->iDeciVar < nVars )
-                {
-                    int iVar = pVars[s->iDeciVar++];
-                    if ( var_value(s, iVar) == varX )
-                    {
-                        next = iVar;
-                        break;
-                    }
-                }
-            }
-            else
+            s->stats.decisions++;
+            if ( fGuided )
+            {
+                int nVars = veci_size(&s->vDeciVars);
+                int * pVars = veci_begin(&s->vDeciVars);
+                next = var_Undef;
+                assert( s->iDeciVar <= nVars );
+                while ( s->iDeciVar < nVars )
+                {
+                    int iVar = pVars[s->iDeciVar++];
+                    if ( var_value(s, iVar) == varX )
+                    {
+                        next = iVar;
+                        break;
+                    }
+                }
+            }
+            else
                 next = order_select(s,(float)random_var_freq);
 
             if (next == var_Undef){
                 // Model found:
                 int i;
                 for (i = 0; i < s->size; i++)
-                    s->model[i] = (var_value(s,i)==var1 ? l_True : l_False);
+                    s->model[i] = (var_value(s,i)==var1 ? l_True : l_False);
                 sat_solver_canceluntil(s,s->root_level);
-                veci_delete(&learnt_clause);
+                veci_delete(&learnt_clause);
 
                 /*
                 veci apa; veci_new(&apa);
@@ -1937,6 +2215,12 @@ int sat_solver_nclauses(sat_solver* s)
 }
 
 
+int sat_solver_npbs(sat_solver* s)
+{
+    return veci_size(&s->pb_starts);
+}
+
+
 int sat_solver_nconflicts(sat_solver* s)
 {
     return (int)s->stats.conflicts;
@@ -44,8 +44,9 @@ typedef struct sat_solver_t sat_solver;
 extern sat_solver* sat_solver_new(void);
 extern void        sat_solver_delete(sat_solver* s);
 
-extern int         sat_solver_addclause(sat_solver* s, lit* begin, lit* end);
-extern int         sat_solver_clause_new(sat_solver* s, lit* begin, lit* end, int learnt);
+extern int         sat_solver_addclause(sat_solver* s, lit* begin, lit* end);
+extern int         sat_solver_addpb(sat_solver* s, lit* begin, lit* end, int* weights, int bound);
+extern int         sat_solver_clause_new(sat_solver* s, lit* begin, lit* end, int learnt);
 extern int         sat_solver_simplify(sat_solver* s);
 extern int         sat_solver_solve(sat_solver* s, lit* begin, lit* end, ABC_INT64_T nConfLimit, ABC_INT64_T nInsLimit, ABC_INT64_T nConfLimitGlobal, ABC_INT64_T nInsLimitGlobal);
 extern void        sat_solver_restart( sat_solver* s );
@@ -53,6 +54,7 @@ extern void        sat_solver_rollback( sat_solver* s );
 
 extern int         sat_solver_nvars(sat_solver* s);
 extern int         sat_solver_nclauses(sat_solver* s);
+extern int         sat_solver_npbs(sat_solver* s);
 extern int         sat_solver_nconflicts(sat_solver* s);
 extern double      sat_solver_memory(sat_solver* s);
 extern int         sat_solver_count_assigned(sat_solver* s);
@@ -103,9 +105,18 @@ struct sat_solver_t
     veci*       wlists;        // watcher lists
     veci        act_clas;      // contain clause activities
 
+    // pseudo-Boolean constraints
+    veci        pb_starts;     // the beginning of each constraint in pb_data
+    veci        pb_data;       // size, initial slack, then (lit, weight) pairs by decreasing weight
+    veci        pb_slack;      // weight of the literals not yet false minus the bound
+    veci*       pb_occs;       // (constraint, position) pairs of the negation of each literal
+    veci        pb_expl;       // explanations (size, lits) of the implications in trail order
+    int         pb_confl;      // the explanation of the last conflict or -1
+
     // rollback
     int         iVarPivot;     // the pivot for variables
     int         iTrailPivot;   // the pivot for trail
+    int         iPbPivot;      // the pivot for PB constraints
     int         hProofPivot;   // the pivot for proof records
 
     // activities
@@ -129,8 +140,8 @@ struct sat_solver_t
     int*        levels;        //
     char*       assigns;       // Current values of variables.
     char*       polarity;      //
-    char*       tags;          //
-    char*       loads;         //
+    char*       tags;          //
+    char*       loads;         //
 
     int*        orderpos;      // Index in variable order.
     int*        reasons;       //
@@ -170,7 +181,7 @@ struct sat_solver_t
     int         nCalls;        // the number of local restarts
     int         nCalls2;       // the number of local restarts
     veci        unit_lits;     // variables whose activity has changed
-    veci        pivot_vars;    // pivot variables
+    veci        pivot_vars;    // pivot variables
 
     int         fSkipSimplify; // set to one to skip simplification of the clause database
     int         fNotUseRandom; // do not allow random decisions with a fixed probability
@@ -178,21 +189,21 @@ struct sat_solver_t
     int *       pGlobalVars;   // for experiments with global vars during interpolation
     // clause store
     void *      pStore;
-    int         fSolved;
+    int         fSolved;
     // decision variables
-    veci        vDeciVars;
-    int         iDeciVar;
+    veci        vDeciVars;
+    int         iDeciVar;
 
     // trace recording
     FILE *      pFile;
     int         nClauses;
     int         nRoots;
 
-    veci        temp_clause;    // temporary storage for a CNF clause
-
-    // CNF loading
-    void *      pCnfMan;           // external CNF manager
-    int(*pCnfFunc)(void * p, int); // external callback
+    veci        temp_clause;    // temporary storage for a CNF clause
+
+    // CNF loading
+    void *      pCnfMan;           // external CNF manager
+    int(*pCnfFunc)(void * p, int); // external callback
 };
 
 static inline clause * clause_read( sat_solver * s, cla h )          
@@ -226,21 +237,21 @@ static void sat_solver_compress(sat_solver* s)
         (void) RetValue;
     }
 }
-static void sat_solver_prepare_enum(sat_solver* s, int * pVars, int nVars )
-{
-    int v;
-    assert( veci_size(&s->vDeciVars) == 0 );
-    veci_new(&s->vDeciVars);
-    for ( v = 0; v < nVars; v++ )
-        veci_push(&s->vDeciVars,pVars[v]);
-}
-static void sat_solver_clean_polarity(sat_solver* s, int * pVars, int nVars )
-{
-    int i;
-    assert( veci_size(&s->vDeciVars) == 0 );
-    for ( i = 0; i < nVars; i++ )
-        s->polarity[pVars[i]] = 0;
-}
+static void sat_solver_prepare_enum(sat_solver* s, int * pVars, int nVars )
+{
+    int v;
+    assert( veci_size(&s->vDeciVars) == 0 );
+    veci_new(&s->vDeciVars);
+    for ( v = 0; v < nVars; v++ )
+        veci_push(&s->vDeciVars,pVars[v]);
+}
+static void sat_solver_clean_polarity(sat_solver* s, int * pVars, int nVars )
+{
+    int i;
+    assert( veci_size(&s->vDeciVars) == 0 );
+    for ( i = 0; i < nVars; i++ )
+        s->polarity[pVars[i]] = 0;
+}
 
 static int sat_solver_final(sat_solver* s, int ** ppArray)
 {
@@ -267,6 +278,7 @@ static inline void sat_solver_bookmark(sat_solver* s)
     assert( s->qhead == s->qtail );
     s->iVarPivot    = s->size;
     s->iTrailPivot  = s->qhead;
+    s->iPbPivot     = veci_size(&s->pb_starts);
     Sat_MemBookMark( &s->Mem );
     if ( s->activity2 )
     {
@@ -274,11 +286,11 @@ static inline void sat_solver_bookmark(sat_solver* s)
         memcpy( s->activity2, s->activity, sizeof(unsigned) * s->iVarPivot );
     }
 }
-static inline void sat_solver_set_pivot_variables( sat_solver* s, int * pPivots, int nPivots )
-{
-    s->pivot_vars.cap = nPivots;
-    s->pivot_vars.size = nPivots;
-    s->pivot_vars.ptr = pPivots;
+static inline void sat_solver_set_pivot_variables( sat_solver* s, int * pPivots, int nPivots )
+{
+    s->pivot_vars.cap = nPivots;
+    s->pivot_vars.size = nPivots;
+    s->pivot_vars.ptr = pPivots;
 }
 static inline int sat_solver_count_usedvars(sat_solver* s)
 {
@@ -303,46 +315,46 @@ static inline int sat_solver_add_const( sat_solver * pSat, int iVar, int fCompl
     assert( Cid );
     return 1;
 }
-static inline int sat_solver_add_buffer( sat_solver * pSat, int iVarA, int iVarB, int fCompl )
-{
-    lit Lits[2];
-    int Cid;
-    assert( iVarA >= 0 && iVarB >= 0 );
-
-    Lits[0] = toLitCond( iVarA, 0 );
-    Lits[1] = toLitCond( iVarB, !fCompl );
-    Cid = sat_solver_addclause( pSat, Lits, Lits + 2 );
-    if ( Cid == 0 )
-        return 0;
-    assert( Cid );
-
-    Lits[0] = toLitCond( iVarA, 1 );
-    Lits[1] = toLitCond( iVarB, fCompl );
-    Cid = sat_solver_addclause( pSat, Lits, Lits + 2 );
-    if ( Cid == 0 )
-        return 0;
-    assert( Cid );
-    return 2;
-}
-static inline int sat_solver_add_buffer_enable( sat_solver * pSat, int iVarA, int iVarB, int iVarEn, int fCompl )
-{
-    lit Lits[3];
-    int Cid;
-    assert( iVarA >= 0 && iVarB >= 0 && iVarEn >= 0 );
-
-    Lits[0] = toLitCond( iVarA, 0 );
-    Lits[1] = toLitCond( iVarB, !fCompl );
-    Lits[2] = toLitCond( iVarEn, 1 );
-    Cid = sat_solver_addclause( pSat, Lits, Lits + 3 );
-    assert( Cid );
-
-    Lits[0] = toLitCond( iVarA, 1 );
-    Lits[1] = toLitCond( iVarB, fCompl );
-    Lits[2] = toLitCond( iVarEn, 1 );
-    Cid = sat_solver_addclause( pSat, Lits, Lits + 3 );
-    assert( Cid );
-    return 2;
-}
+static inline int sat_solver_add_buffer( sat_solver * pSat, int iVarA, int iVarB, int fCompl )
+{
+    lit Lits[2];
+    int Cid;
+    assert( iVarA >= 0 && iVarB >= 0 );
+
+    Lits[0] = toLitCond( iVarA, 0 );
+    Lits[1] = toLitCond( iVarB, !fCompl );
+    Cid = sat_solver_addclause( pSat, Lits, Lits + 2 );
+    if ( Cid == 0 )
+        return 0;
+    assert( Cid );
+
+    Lits[0] = toLitCond( iVarA, 1 );
+    Lits[1] = toLitCond( iVarB, fCompl );
+    Cid = sat_solver_addclause( pSat, Lits, Lits + 2 );
+    if ( Cid == 0 )
+        return 0;
+    assert( Cid );
+    return 2;
+}
+static inline int sat_solver_add_buffer_enable( sat_solver * pSat, int iVarA, int iVarB, int iVarEn, int fCompl )
+{
+    lit Lits[3];
+    int Cid;
+    assert( iVarA >= 0 && iVarB >= 0 && iVarEn >= 0 );
+
+    Lits[0] = toLitCond( iVarA, 0 );
+    Lits[1] = toLitCond( iVarB, !fCompl );
+    Lits[2] = toLitCond( iVarEn, 1 );
+    Cid = sat_solver_addclause( pSat, Lits, Lits + 3 );
+    assert( Cid );
+
+    Lits[0] = toLitCond( iVarA, 1 );
+    Lits[1] = toLitCond( iVarB, fCompl );
+    Lits[2] = toLitCond( iVarEn, 1 );
+    Cid = sat_solver_addclause( pSat, Lits, Lits + 3 );
+    assert( Cid );
+    return 2;
+}
 static inline int sat_solver_add_and( sat_solver * pSat, int iVar, int iVar0, int iVar1, int fCompl0, int fCompl1, int fCompl )
 {
     lit Lits[3];
@@ -365,186 +377,186 @@ static inline int sat_solver_add_and( sat_solver * pSat, int iVar, int iVar0, in
     assert( Cid );
     return 3;
 }
-static inline int sat_solver_add_xor( sat_solver * pSat, int iVarA, int iVarB, int iVarC, int fCompl )
-{
-    lit Lits[3];
-    int Cid;
-    assert( iVarA >= 0 && iVarB >= 0 && iVarC >= 0 );
-
-    Lits[0] = toLitCond( iVarA, !fCompl );
-    Lits[1] = toLitCond( iVarB, 1 );
-    Lits[2] = toLitCond( iVarC, 1 );
-    Cid = sat_solver_addclause( pSat, Lits, Lits + 3 );
-    assert( Cid );
-
-    Lits[0] = toLitCond( iVarA, !fCompl );
-    Lits[1] = toLitCond( iVarB, 0 );
-    Lits[2] = toLitCond( iVarC, 0 );
-    Cid = sat_solver_addclause( pSat, Lits, Lits + 3 );
-    assert( Cid );
-
-    Lits[0] = toLitCond( iVarA, fCompl );
-    Lits[1] = toLitCond( iVarB, 1 );
-    Lits[2] = toLitCond( iVarC, 0 );
-    Cid = sat_solver_addclause( pSat, Lits, Lits + 3 );
-    assert( Cid );
-
-    Lits[0] = toLitCond( iVarA, fCompl );
-    Lits[1] = toLitCond( iVarB, 0 );
-    Lits[2] = toLitCond( iVarC, 1 );
-    Cid = sat_solver_addclause( pSat, Lits, Lits + 3 );
-    assert( Cid );
-    return 4;
-}
-static inline int sat_solver_add_mux( sat_solver * pSat, int iVarZ, int iVarC, int iVarT, int iVarE, int iComplC, int iComplT, int iComplE, int iComplZ )
-{
-    lit Lits[3];
-    int Cid;
-    assert( iVarC >= 0 && iVarT >= 0 && iVarE >= 0 && iVarZ >= 0 );
-
-    Lits[0] = toLitCond( iVarC, 1 ^ iComplC );
-    Lits[1] = toLitCond( iVarT, 1 ^ iComplT );
-    Lits[2] = toLitCond( iVarZ, 0 );
-    Cid = sat_solver_addclause( pSat, Lits, Lits + 3 );
-    assert( Cid );
-
-    Lits[0] = toLitCond( iVarC, 1 ^ iComplC );
-    Lits[1] = toLitCond( iVarT, 0 ^ iComplT );
-    Lits[2] = toLitCond( iVarZ, 1 ^ iComplZ );
-    Cid = sat_solver_addclause( pSat, Lits, Lits + 3 );
-    assert( Cid );
-
-    Lits[0] = toLitCond( iVarC, 0 ^ iComplC );
-    Lits[1] = toLitCond( iVarE, 1 ^ iComplE );
-    Lits[2] = toLitCond( iVarZ, 0 ^ iComplZ );
-    Cid = sat_solver_addclause( pSat, Lits, Lits + 3 );
-    assert( Cid );
-
-    Lits[0] = toLitCond( iVarC, 0 ^ iComplC );
-    Lits[1] = toLitCond( iVarE, 0 ^ iComplE );
-    Lits[2] = toLitCond( iVarZ, 1 ^ iComplZ );
-    Cid = sat_solver_addclause( pSat, Lits, Lits + 3 );
-    assert( Cid );
-
-    if ( iVarT == iVarE )
-        return 4;
-
-    Lits[0] = toLitCond( iVarT, 0 ^ iComplT );
-    Lits[1] = toLitCond( iVarE, 0 ^ iComplE );
-    Lits[2] = toLitCond( iVarZ, 1 ^ iComplZ );
-    Cid = sat_solver_addclause( pSat, Lits, Lits + 3 );
-    assert( Cid );
-
-    Lits[0] = toLitCond( iVarT, 1 ^ iComplT );
-    Lits[1] = toLitCond( iVarE, 1 ^ iComplE );
-    Lits[2] = toLitCond( iVarZ, 0 ^ iComplZ );
-    Cid = sat_solver_addclause( pSat, Lits, Lits + 3 );
-    assert( Cid );
-    return 6;
-}
-static inline int sat_solver_add_mux41( sat_solver * pSat, int iVarZ, int iVarC0, int iVarC1, int iVarD0, int iVarD1, int iVarD2, int iVarD3 )
-{
-    lit Lits[4];
-    int Cid;
-    assert( iVarC0 >= 0 && iVarC1 >= 0 && iVarD0 >= 0 && iVarD1 >= 0 && iVarD2 >= 0 && iVarD3 >= 0 && iVarZ >= 0 );
-
-    Lits[0] = toLitCond( iVarD0, 1 );
-    Lits[1] = toLitCond( iVarC0, 0 );
-    Lits[2] = toLitCond( iVarC1, 0 );
-    Lits[3] = toLitCond( iVarZ,  0 );
-    Cid = sat_solver_addclause( pSat, Lits, Lits + 4 );
-    assert( Cid );
-
-    Lits[0] = toLitCond( iVarD1, 1 );
-    Lits[1] = toLitCond( iVarC0, 1 );
-    Lits[2] = toLitCond( iVarC1, 0 );
-    Lits[3] = toLitCond( iVarZ,  0 );
-    Cid = sat_solver_addclause( pSat, Lits, Lits + 4 );
-    assert( Cid );
-
-    Lits[0] = toLitCond( iVarD2, 1 );
-    Lits[1] = toLitCond( iVarC0, 0 );
-    Lits[2] = toLitCond( iVarC1, 1 );
-    Lits[3] = toLitCond( iVarZ,  0 );
-    Cid = sat_solver_addclause( pSat, Lits, Lits + 4 );
-    assert( Cid );
-
-    Lits[0] = toLitCond( iVarD3, 1 );
-    Lits[1] = toLitCond( iVarC0, 1 );
-    Lits[2] = toLitCond( iVarC1, 1 );
-    Lits[3] = toLitCond( iVarZ,  0 );
-    Cid = sat_solver_addclause( pSat, Lits, Lits + 4 );
-    assert( Cid );
-
-
-    Lits[0] = toLitCond( iVarD0, 0 );
-    Lits[1] = toLitCond( iVarC0, 0 );
-    Lits[2] = toLitCond( iVarC1, 0 );
-    Lits[3] = toLitCond( iVarZ,  1 );
-    Cid = sat_solver_addclause( pSat, Lits, Lits + 4 );
-    assert( Cid );
-
-    Lits[0] = toLitCond( iVarD1, 0 );
-    Lits[1] = toLitCond( iVarC0, 1 );
-    Lits[2] = toLitCond( iVarC1, 0 );
-    Lits[3] = toLitCond( iVarZ,  1 );
-    Cid = sat_solver_addclause( pSat, Lits, Lits + 4 );
-    assert( Cid );
-
-    Lits[0] = toLitCond( iVarD2, 0 );
-    Lits[1] = toLitCond( iVarC0, 0 );
-    Lits[2] = toLitCond( iVarC1, 1 );
-    Lits[3] = toLitCond( iVarZ,  1 );
-    Cid = sat_solver_addclause( pSat, Lits, Lits + 4 );
-    assert( Cid );
-
-    Lits[0] = toLitCond( iVarD3, 0 );
-    Lits[1] = toLitCond( iVarC0, 1 );
-    Lits[2] = toLitCond( iVarC1, 1 );
-    Lits[3] = toLitCond( iVarZ,  1 );
-    Cid = sat_solver_addclause( pSat, Lits, Lits + 4 );
-    assert( Cid );
-    return 8;
-}
-static inline int sat_solver_add_xor_and( sat_solver * pSat, int iVarF, int iVarA, int iVarB, int iVarC )
-{
-    // F = (a (+) b) * c
-    lit Lits[4];
-    int Cid;
-    assert( iVarF >= 0 && iVarA >= 0 && iVarB >= 0 && iVarC >= 0 );
-
-    Lits[0] = toLitCond( iVarF, 1 );
-    Lits[1] = toLitCond( iVarA, 1 );
-    Lits[2] = toLitCond( iVarB, 1 );
-    Cid = sat_solver_addclause( pSat, Lits, Lits + 3 );
-    assert( Cid );
-
-    Lits[0] = toLitCond( iVarF, 1 );
-    Lits[1] = toLitCond( iVarA, 0 );
-    Lits[2] = toLitCond( iVarB, 0 );
-    Cid = sat_solver_addclause( pSat, Lits, Lits + 3 );
-    assert( Cid );
-
-    Lits[0] = toLitCond( iVarF, 1 );
-    Lits[1] = toLitCond( iVarC, 0 );
-    Cid = sat_solver_addclause( pSat, Lits, Lits + 2 );
-    assert( Cid );
-
-    Lits[0] = toLitCond( iVarF, 0 );
-    Lits[1] = toLitCond( iVarA, 1 );
-    Lits[2] = toLitCond( iVarB, 0 );
-    Lits[3] = toLitCond( iVarC, 1 );
-    Cid = sat_solver_addclause( pSat, Lits, Lits + 4 );
-    assert( Cid );
-
-    Lits[0] = toLitCond( iVarF, 0 );
-    Lits[1] = toLitCond( iVarA, 0 );
-    Lits[2] = toLitCond( iVarB, 1 );
-    Lits[3] = toLitCond( iVarC, 1 );
-    Cid = sat_solver_addclause( pSat, Lits, Lits + 4 );
-    assert( Cid );
-    return 5;
-}
+static inline int sat_solver_add_xor( sat_solver * pSat, int iVarA, int iVarB, int iVarC, int fCompl )
+{
+    lit Lits[3];
+    int Cid;
+    assert( iVarA >= 0 && iVarB >= 0 && iVarC >= 0 );
+
+    Lits[0] = toLitCond( iVarA, !fCompl );
+    Lits[1] = toLitCond( iVarB, 1 );
+    Lits[2] = toLitCond( iVarC, 1 );
+    Cid = sat_solver_addclause( pSat, Lits, Lits + 3 );
+    assert( Cid );
+
+    Lits[0] = toLitCond( iVarA, !fCompl );
+    Lits[1] = toLitCond( iVarB, 0 );
+    Lits[2] = toLitCond( iVarC, 0 );
+    Cid = sat_solver_addclause( pSat, Lits, Lits + 3 );
+    assert( Cid );
+
+    Lits[0] = toLitCond( iVarA, fCompl );
+    Lits[1] = toLitCond( iVarB, 1 );
+    Lits[2] = toLitCond( iVarC, 0 );
+    Cid = sat_solver_addclause( pSat, Lits, Lits + 3 );
+    assert( Cid );
+
+    Lits[0] = toLitCond( iVarA, fCompl );
+    Lits[1] = toLitCond( iVarB, 0 );
+    Lits[2] = toLitCond( iVarC, 1 );
+    Cid = sat_solver_addclause( pSat, Lits, Lits + 3 );
+    assert( Cid );
+    return 4;
+}
+static inline int sat_solver_add_mux( sat_solver * pSat, int iVarZ, int iVarC, int iVarT, int iVarE, int iComplC, int iComplT, int iComplE, int iComplZ )
+{
+    lit Lits[3];
+    int Cid;
+    assert( iVarC >= 0 && iVarT >= 0 && iVarE >= 0 && iVarZ >= 0 );
+
+    Lits[0] = toLitCond( iVarC, 1 ^ iComplC );
+    Lits[1] = toLitCond( iVarT, 1 ^ iComplT );
+    Lits[2] = toLitCond( iVarZ, 0 );
+    Cid = sat_solver_addclause( pSat, Lits, Lits + 3 );
+    assert( Cid );
+
+    Lits[0] = toLitCond( iVarC, 1 ^ iComplC );
+    Lits[1] = toLitCond( iVarT, 0 ^ iComplT );
+    Lits[2] = toLitCond( iVarZ, 1 ^ iComplZ );
+    Cid = sat_solver_addclause( pSat, Lits, Lits + 3 );
+    assert( Cid );
+
+    Lits[0] = toLitCond( iVarC, 0 ^ iComplC );
+    Lits[1] = toLitCond( iVarE, 1 ^ iComplE );
+    Lits[2] = toLitCond( iVarZ, 0 ^ iComplZ );
+    Cid = sat_solver_addclause( pSat, Lits, Lits + 3 );
+    assert( Cid );
+
+    Lits[0] = toLitCond( iVarC, 0 ^ iComplC );
+    Lits[1] = toLitCond( iVarE, 0 ^ iComplE );
+    Lits[2] = toLitCond( iVarZ, 1 ^ iComplZ );
+    Cid = sat_solver_addclause( pSat, Lits, Lits + 3 );
+    assert( Cid );
+
+    if ( iVarT == iVarE )
+        return 4;
+
+    Lits[0] = toLitCond( iVarT, 0 ^ iComplT );
+    Lits[1] = toLitCond( iVarE, 0 ^ iComplE );
+    Lits[2] = toLitCond( iVarZ, 1 ^ iComplZ );
+    Cid = sat_solver_addclause( pSat, Lits, Lits + 3 );
+    assert( Cid );
+
+    Lits[0] = toLitCond( iVarT, 1 ^ iComplT );
+    Lits[1] = toLitCond( iVarE, 1 ^ iComplE );
+    Lits[2] = toLitCond( iVarZ, 0 ^ iComplZ );
+    Cid = sat_solver_addclause( pSat, Lits, Lits + 3 );
+    assert( Cid );
+    return 6;
+}
+static inline int sat_solver_add_mux41( sat_solver * pSat, int iVarZ, int iVarC0, int iVarC1, int iVarD0, int iVarD1, int iVarD2, int iVarD3 )
+{
+    lit Lits[4];
+    int Cid;
+    assert( iVarC0 >= 0 && iVarC1 >= 0 && iVarD0 >= 0 && iVarD1 >= 0 && iVarD2 >= 0 && iVarD3 >= 0 && iVarZ >= 0 );
+
+    Lits[0] = toLitCond( iVarD0, 1 );
+    Lits[1] = toLitCond( iVarC0, 0 );
+    Lits[2] = toLitCond( iVarC1, 0 );
+    Lits[3] = toLitCond( iVarZ,  0 );
+    Cid = sat_solver_addclause( pSat, Lits, Lits + 4 );
+    assert( Cid );
+
+    Lits[0] = toLitCond( iVarD1, 1 );
+    Lits[1] = toLitCond( iVarC0, 1 );
+    Lits[2] = toLitCond( iVarC1, 0 );
+    Lits[3] = toLitCond( iVarZ,  0 );
+    Cid = sat_solver_addclause( pSat, Lits, Lits + 4 );
+    assert( Cid );
+
+    Lits[0] = toLitCond( iVarD2, 1 );
+    Lits[1] = toLitCond( iVarC0, 0 );
+    Lits[2] = toLitCond( iVarC1, 1 );
+    Lits[3] = toLitCond( iVarZ,  0 );
+    Cid = sat_solver_addclause( pSat, Lits, Lits + 4 );
+    assert( Cid );
+
+    Lits[0] = toLitCond( iVarD3, 1 );
+    Lits[1] = toLitCond( iVarC0, 1 );
+    Lits[2] = toLitCond( iVarC1, 1 );
+    Lits[3] = toLitCond( iVarZ,  0 );
+    Cid = sat_solver_addclause( pSat, Lits, Lits + 4 );
+    assert( Cid );
+
+
+    Lits[0] = toLitCond( iVarD0, 0 );
+    Lits[1] = toLitCond( iVarC0, 0 );
+    Lits[2] = toLitCond( iVarC1, 0 );
+    Lits[3] = toLitCond( iVarZ,  1 );
+    Cid = sat_solver_addclause( pSat, Lits, Lits + 4 );
+    assert( Cid );
+
+    Lits[0] = toLitCond( iVarD1, 0 );
+    Lits[1] = toLitCond( iVarC0, 1 );
+    Lits[2] = toLitCond( iVarC1, 0 );
+    Lits[3] = toLitCond( iVarZ,  1 );
+    Cid = sat_solver_addclause( pSat, Lits, Lits + 4 );
+    assert( Cid );
+
+    Lits[0] = toLitCond( iVarD2, 0 );
+    Lits[1] = toLitCond( iVarC0, 0 );
+    Lits[2] = toLitCond( iVarC1, 1 );
+    Lits[3] = toLitCond( iVarZ,  1 );
+    Cid = sat_solver_addclause( pSat, Lits, Lits + 4 );
+    assert( Cid );
+
+    Lits[0] = toLitCond( iVarD3, 0 );
+    Lits[1] = toLitCond( iVarC0, 1 );
+    Lits[2] = toLitCond( iVarC1, 1 );
+    Lits[3] = toLitCond( iVarZ,  1 );
+    Cid = sat_solver_addclause( pSat, Lits, Lits + 4 );
+    assert( Cid );
+    return 8;
+}
+static inline int sat_solver_add_xor_and( sat_solver * pSat, int iVarF, int iVarA, int iVarB, int iVarC )
+{
+    // F = (a (+) b) * c
+    lit Lits[4];
+    int Cid;
+    assert( iVarF >= 0 && iVarA >= 0 && iVarB >= 0 && iVarC >= 0 );
+
+    Lits[0] = toLitCond( iVarF, 1 );
+    Lits[1] = toLitCond( iVarA, 1 );
+    Lits[2] = toLitCond( iVarB, 1 );
+    Cid = sat_solver_addclause( pSat, Lits, Lits + 3 );
+    assert( Cid );
+
+    Lits[0] = toLitCond( iVarF, 1 );
+    Lits[1] = toLitCond( iVarA, 0 );
+    Lits[2] = toLitCond( iVarB, 0 );
+    Cid = sat_solver_addclause( pSat, Lits, Lits + 3 );
+    assert( Cid );
+
+    Lits[0] = toLitCond( iVarF, 1 );
+    Lits[1] = toLitCond( iVarC, 0 );
+    Cid = sat_solver_addclause( pSat, Lits, Lits + 2 );
+    assert( Cid );
+
+    Lits[0] = toLitCond( iVarF, 0 );
+    Lits[1] = toLitCond( iVarA, 1 );
+    Lits[2] = toLitCond( iVarB, 0 );
+    Lits[3] = toLitCond( iVarC, 1 );
+    Cid = sat_solver_addclause( pSat, Lits, Lits + 4 );
+    assert( Cid );
+
+    Lits[0] = toLitCond( iVarF, 0 );
+    Lits[1] = toLitCond( iVarA, 0 );
+    Lits[2] = toLitCond( iVarB, 1 );
+    Lits[3] = toLitCond( iVarC, 1 );
+    Cid = sat_solver_addclause( pSat, Lits, Lits + 4 );
+    assert( Cid );
+    return 5;
+}
 static inline int sat_solver_add_constraint( sat_solver * pSat, int iVar, int iVar2, int fCompl )
 {
     lit Lits[2];
@@ -56,11 +56,113 @@ void       aigThConnectFanout      ( Abc_Ntk_t * , Vec_Ptr_t * , Vec_Int_t * );
 Thre_S*    Th_CreateObj            ( Vec_Ptr_t * , Th_Gate_Type );
 void       Th_DeleteObj            ( Thre_S * );
 Thre_S*    Th_GetObjById           ( Vec_Ptr_t * , int );
+// memory manager for Thre_S
+Thre_S*    Th_ObjAlloc             ();
+void       Th_ObjRecycle           ( Thre_S * );
+Vec_Int_t* Th_VecIntFetch          ();
+void       Th_VecIntRecycle        ( Vec_Int_t * );
+void       Th_ObjManStop           ();
+
+static Mem_Fixed_t * thObjMan  = NULL; // fixed-size entries for Thre_S
+static Vec_Ptr_t   * thVecPool = NULL; // recycled (empty) integer vectors
+static int           thObjLive = 0;    // objects fetched and not yet recycled
 
 //////////////////////////////////
 //Threshold object constructor  //
 //////////////////////////////////
 
+/**Function*************************************************************
+
+  Synopsis    [Memory manager for Thre_S.]
+
+  Description [Objects are fetched from a fixed-size entry manager and
+               their integer vectors from a pool of recycled vectors,
+               which keep their capacity. Deleting an object gives both
+               back, so collapsing (which deletes and creates objects at
+               the same rate) stops calling malloc()/free() once the pool
+               is warm. Vectors that are freed or replaced by the caller
+               are simply not returned to the pool.
+               The manager is shared by all lists rather than owned by
+               one : the lists are bare Vec_Ptr_t's , objects are created
+               before the list holding them is known (newThre() of the
+               readers) and DeleteTList() recycles whatever list they
+               ended up in. It is still released with the networks : it
+               counts the live objects and stops when the last one is
+               recycled , e.g. when the last of current_TList/cut_TList
+               is deleted , instead of being held until quit.
+               The manager is unlocked , so objects may only be created
+               and deleted by the main thread ; the worker threads of
+               Th_SplitCompare() only read the networks.]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+Vec_Int_t*
+Th_VecIntFetch()
+{
+	Vec_Int_t * vVec;
+	if ( thVecPool == NULL || Vec_PtrSize( thVecPool ) == 0 ) return Vec_IntAlloc(16);
+	vVec = (Vec_Int_t*)Vec_PtrPop( thVecPool );
+	assert( Vec_IntSize( vVec ) == 0 );
+	return vVec;
+}
+
+void
+Th_VecIntRecycle( Vec_Int_t * vVec )
+{
+	if ( vVec == NULL ) return;
+	if ( thVecPool == NULL ) thVecPool = Vec_PtrAlloc( 1000 );
+	Vec_IntClear( vVec );
+	Vec_PtrPush( thVecPool , vVec );
+}
+
+Thre_S*
+Th_ObjAlloc()
+{
+	Thre_S * tObj;
+	if ( thObjMan == NULL ) thObjMan = Mem_FixedStart( sizeof(Thre_S) );
+	tObj = (Thre_S*)Mem_FixedEntryFetch( thObjMan );
+	memset( tObj , 0 , sizeof(Thre_S) );
+	++thObjLive;
+	tObj->weights = Th_VecIntFetch();
+	tObj->Fanins  = Th_VecIntFetch();
+	tObj->Fanouts = Th_VecIntFetch();
+	return tObj;
+}
+
+void
+Th_ObjRecycle( Thre_S * tObj )
+{
+	if ( tObj->pName ) ABC_FREE( tObj->pName );
+	Th_VecIntRecycle( tObj->weights );
+	Th_VecIntRecycle( tObj->Fanins  );
+	Th_VecIntRecycle( tObj->Fanouts );
+	Th_ObjFreeFanioIndex( tObj );
+	Th_VecIntRecycle( tObj->vSumPos );
+	Th_VecIntRecycle( tObj->vSumNeg );
+	Mem_FixedEntryRecycle( thObjMan , (char*)tObj );
+	// the last object is gone : give the memory back with its network
+	if ( --thObjLive == 0 ) Th_ObjManStop();
+}
+
+void
+Th_ObjManStop()
+{
+	Vec_Int_t * vVec;
+	int i;
+	if ( thVecPool ) {
+		Vec_PtrForEachEntry( Vec_Int_t * , thVecPool , vVec , i )
+			Vec_IntFree( vVec );
+		Vec_PtrFree( thVecPool );
+		thVecPool = NULL;
+	}
+	if ( thObjMan )  { Mem_FixedStop( thObjMan , 0 ); thObjMan = NULL; }
+	thObjLive = 0;
+}
+
 /**Function*************************************************************
 
   Synopsis    [Thre_S constructor/destructor/find object in list by Id.]
@@ -76,20 +178,9 @@ Thre_S*    Th_GetObjById           ( Vec_Ptr_t * , int );
 Thre_S* 
 Th_CreateObj( Vec_Ptr_t * TList , Th_Gate_Type Type )
 {
-   Thre_S * tObj    = ABC_ALLOC( Thre_S , 1 );
-	tObj->thre       = 0;
+   Thre_S * tObj    = Th_ObjAlloc();
 	tObj->Type       = Type;
-	tObj->Ischoose   = 0;
    tObj->Id         = Vec_PtrSize( TList );
-	tObj->oId        = 0;
-	tObj->nId        = 0;
-	tObj->cost       = 0;
-	tObj->level      = 0;
-	tObj->pName      = NULL;
-	tObj->weights    = Vec_IntAlloc(16);
-	tObj->Fanins     = Vec_IntAlloc(16);
-	tObj->Fanouts    = Vec_IntAlloc(16);
-	tObj->pCopy      = NULL;
 
    Vec_PtrPush( TList , tObj );
 
@@ -100,11 +191,7 @@ void
 Th_DeleteObj( Thre_S * tObj )
 {
 	Vec_PtrWriteEntry( current_TList , tObj->Id , NULL );
-	ABC_FREE( tObj->pName );
-   Vec_IntFree( tObj->weights );
-   Vec_IntFree( tObj->Fanins  );
-   Vec_IntFree( tObj->Fanouts );
-   ABC_FREE( tObj );
+   Th_ObjRecycle( tObj );
 }
 
 Thre_S* 
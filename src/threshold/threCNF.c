@@ -3,38 +3,72 @@
 #include "base/abc/abc.h"
 #include "threshold.h"
 
-extern void func_EC_writeCNF(Abc_Ntk_t*, Vec_Ptr_t*, char*);
+extern int  func_EC_writeCNF(Abc_Ntk_t*, Vec_Ptr_t*, char*, int, int, int, int);
 void        my_Vec_StrPrintNum( Vec_Str_t *, int );
-Vec_Ptr_t*  alan_CNF(FILE*, Abc_Ntk_t *);
-Vec_Ptr_t*  thre_CNF(FILE*, Vec_Ptr_t *);
-void        miter_CNF(FILE*, Vec_Ptr_t *, Vec_Ptr_t *);
+Vec_Ptr_t*  alan_CNF(Th_CnfMan_t*, Abc_Ntk_t *);
+Vec_Ptr_t*  thre_CNF(Vec_Ptr_t *, Th_CnfMan_t *);
+int         miter_CNF(Th_CnfMan_t*, Vec_Ptr_t *, Vec_Ptr_t *);
 ///
 Thre_S*     slow_sortByWeights(Thre_S*);
 void        delete_sortedNode(Thre_S*);
-void        Recurrsive_CNF(FILE*,Thre_S*, Vec_Str_t*, int, int);
 int         Thre_LocalMax(Thre_S*, int);
 int         Thre_LocalMin(Thre_S*, int);
 ///
 
-void func_EC_writeCNF(Abc_Ntk_t * pNtk, Vec_Ptr_t* TList, char* fileName)
+// returns 1 if not equivalent , 0 if equivalent , -1 if undecided or not solved
+int func_EC_writeCNF(Abc_Ntk_t * pNtk, Vec_Ptr_t* TList, char* fileName, int nEncoding, int fSolve, int nConfLimit, int nTimeLimit)
 {
-    //char* fileName = "EC.cnf";
-    FILE* oFile = fopen(fileName, "w");
+    Th_Out_t* oFile = NULL;
+    Abc_Obj_t* pObj = NULL;
+    int i, RetValue = -1;
+    abctime clk;
     printf("\tchecking Equalivance of ABC_ntk and threshold_ntk...\n");
-    printf("\tOutputFile: %s\n", fileName);
-    fprintf(oFile, "c CNF file for aig<->th equiv checking\n");
+    if ( fileName ) {
+        oFile = Th_OutStart(fileName, Th_OutFileMode(fileName));
+        if ( oFile == NULL ) {
+            printf("\tCannot open output file \"%s\".\n", fileName);
+            return -1;
+        }
+        printf("\tOutputFile: %s\n", fileName);
+        Th_OutStr(oFile, "c CNF file for aig<->th equiv checking\n");
+    }
     
-    Vec_Ptr_t* aigPO = alan_CNF( oFile, pNtk );
-    Vec_Ptr_t* thPO  = thre_CNF( oFile, TList );
-    miter_CNF( oFile, aigPO, thPO );
+    // auxiliary variables of the threshold gate encodings follow all named ones
+    Th_CnfMan_t* pCnf = Th_CnfManStart( oFile, 3 * Abc_MaxInt( Abc_NtkObjNumMax(pNtk), Vec_PtrSize(TList) ) + 2, nEncoding, fSolve );
+    Vec_Ptr_t* aigPO = alan_CNF( pCnf, pNtk );
+    Vec_Ptr_t* thPO  = thre_CNF( TList, pCnf );
+    int fMiter = miter_CNF( pCnf, aigPO, thPO );
 
+    Th_CnfManPrintStats(pCnf);
+    if ( fMiter && fSolve ) {
+        clk = Abc_Clock();
+        RetValue = Th_CnfManSolve( pCnf, nConfLimit, nTimeLimit );
+        if ( RetValue == 0 )
+            printf("\tNetworks are EQUIVALENT.\n");
+        else if ( RetValue == -1 )
+            printf("\tNetworks are UNDECIDED (resource limit reached).\n");
+        else {
+            Vec_PtrForEachEntry( Abc_Obj_t*, aigPO, pObj, i )
+                if ( Th_CnfManVarValue( pCnf, 3*i+2 ) )
+                    break;
+            // the miter OR forces one differing output
+            assert( i < Vec_PtrSize(aigPO) );
+            printf("\tNetworks are NOT EQUIVALENT. Output \"%s\" differs under the input pattern:\n\t", Abc_ObjName(pObj) );
+            Abc_NtkForEachPi( pNtk, pObj, i )
+                printf("%d", Th_CnfManVarValue( pCnf, 3*Abc_ObjId(pObj) ) );
+            printf("\n");
+        }
+        Abc_PrintTime( 1, "\tSAT solving time", Abc_Clock() - clk );
+    }
+    Th_CnfManStop(pCnf);
     Vec_PtrFree(aigPO);
     Vec_PtrFree(thPO);
-    fclose(oFile);
+    if ( oFile ) Th_OutStop(oFile);
+    return RetValue;
 }
 /////////////////////////////////////////////////////
 
-void miter_CNF(FILE* oFile, Vec_Ptr_t* aig, Vec_Ptr_t * th){
+int miter_CNF(Th_CnfMan_t* pCnf, Vec_Ptr_t* aig, Vec_Ptr_t * th){
     // VAR naming:
     // aig_PO    : 3*id+1
     // th_PO     : 3*id
@@ -43,60 +77,32 @@ void miter_CNF(FILE* oFile, Vec_Ptr_t* aig, Vec_Ptr_t * th){
     if(Vec_PtrSize(aig) != Vec_PtrSize(th)){
         printf("\tERROR: two network have different # of POs\n");
         printf("\tEC_check : stopped\n");
-        return;
+        return 0;
     }
-    int i;
+    int i, pLits[3];
     Thre_S      *tObj;
     Abc_Obj_t   *aObj;
-    Vec_Str_t * sAig = Vec_StrAlloc(5);
-    Vec_Str_t * sTh  = Vec_StrAlloc(5);
-    Vec_Str_t * sMit = Vec_StrAlloc(5);
-    Vec_Str_t * sOR  = Vec_StrAlloc(5);
+    int PO_size = Vec_PtrSize(aig);
+    Vec_Int_t * vOr = Vec_IntAlloc( PO_size + 1 );
     
     Vec_PtrForEachEntry( Abc_Obj_t*, aig, aObj, i){
         tObj = (Thre_S*)Vec_PtrEntry( th, i );
-        
-        Vec_StrClear(sAig);
-        my_Vec_StrPrintNum( sAig, Abc_ObjId( aObj )*3 +1 );
-        Vec_StrClear(sTh);
-        my_Vec_StrPrintNum( sTh, tObj->Id *3 );
-        Vec_StrClear(sMit);
-        my_Vec_StrPrintNum( sMit, i*3 + 2 );
-        
-        fprintf(oFile, "-%s  %s  %s 0\n", 
-               sAig->pArray, sTh->pArray, sMit->pArray);
-        fprintf(oFile, " %s -%s  %s 0\n", 
-               sAig->pArray, sTh->pArray, sMit->pArray);
-        fprintf(oFile, " %s  %s -%s 0\n", 
-               sAig->pArray, sTh->pArray, sMit->pArray);
-        fprintf(oFile, "-%s -%s -%s 0\n", 
-               sAig->pArray, sTh->pArray, sMit->pArray);
+        Th_CnfWriteXor( pCnf, Abc_ObjId( aObj )*3 +1, tObj->Id *3, i*3+2 );
+        // each miter output implies the OR
+        pLits[0] = -(i*3+2); pLits[1] = PO_size*3+2;
+        Th_CnfManAddClause( pCnf, pLits, 2 );
+        Vec_IntPush( vOr, i*3+2 );
     }
-    int PO_size = Vec_PtrSize(aig);
-    Vec_StrPrintStr(sOR, " 2 ");
-    fprintf(oFile, "-2 %d 0\n" , PO_size*3 +2 );
-    for( i = 1; i < PO_size; ++i ){
-        Vec_StrPrintNum(sOR, i*3+2);
-        Vec_StrAppend(sOR, " ");
-        fprintf(oFile, "-%d %d 0\n", i*3+2, PO_size*3+2);
-    }
-    Vec_StrAppend(sOR, "-");
-    Vec_StrPrintNum(sOR, PO_size*3 + 2);
-    Vec_StrAppend(sOR, " 0\n");
-    Vec_StrPush(sOR, '\0');
-    fprintf(oFile,sOR->pArray);
-    fprintf(oFile," %d 0\n", PO_size*3 +2);
+    Vec_IntPush( vOr, -(PO_size*3+2) );
+    Th_CnfManAddClause( pCnf, Vec_IntArray(vOr), Vec_IntSize(vOr) );
+    pLits[0] = PO_size*3+2;
+    Th_CnfManAddClause( pCnf, pLits, 1 );
 
     printf("\tdone\n");
-    Vec_StrFree(sAig);
-    Vec_StrFree(sTh);
-    Vec_StrFree(sMit);
-    Vec_StrFree(sOR);
-    
+    Vec_IntFree(vOr);
+    return 1;
 }
-/////////////////////////////
-
-Vec_Ptr_t* thre_CNF(FILE* oFile, Vec_Ptr_t* TList )
+Vec_Ptr_t* thre_CNF(Vec_Ptr_t* TList, Th_CnfMan_t* pCnf )
 {
     Vec_Ptr_t * thPOList = Vec_PtrAlloc(10);
     /*
@@ -104,141 +110,59 @@ Vec_Ptr_t* thre_CNF(FILE* oFile, Vec_Ptr_t* TList )
      * PI: 3*id
      * PO: 3*id 
      * TH: 3*id 
-     * be care of CONST1 gates (only @ PO)
+     * CONST1 fanins are folded into the threshold
      *
      */
     int i, j, finId;
-    Thre_S *tObj_unsort, *tObj, *finObj;
-    Vec_Str_t * sCNF = Vec_StrAlloc(10);
+    Thre_S *tObj, *finObj;
+    Vec_Int_t * vFanVars = Vec_IntAlloc(10);
 
-    Vec_PtrForEachEntry( Thre_S*, TList, tObj_unsort, i ){
-        if ( tObj_unsort == NULL ) continue;
-        if ( tObj_unsort->Type == 1 || tObj_unsort->Type == 4)
+    Vec_PtrForEachEntry( Thre_S*, TList, tObj, i ){
+        if ( tObj == NULL ) continue;
+        if ( tObj->Type == 1 || tObj->Type == 4)
             continue;
-        if ( tObj_unsort->Type == 2 )
-            Vec_PtrPush( thPOList, tObj_unsort );
-        
+        if ( tObj->Type == 2 )
+            Vec_PtrPush( thPOList, tObj );
 
-        // construst a sorted version of this THnode
-        tObj = slow_sortByWeights( tObj_unsort );
-        Vec_StrClear(sCNF);
-        //printf("--- ID = %d ---\n", tObj->Id);
-        
-        Recurrsive_CNF(oFile, tObj, sCNF, tObj->thre, 0);
-        
-        // delete tObj
-        delete_sortedNode( tObj );
+        Vec_IntClear( vFanVars );
+        Vec_IntForEachEntry( tObj->Fanins, finId, j ){
+            finObj = (Thre_S*)Vec_PtrEntry( TList, finId );
+            Vec_IntPush( vFanVars, finObj->Type == Th_CONST1 ? 0 : 3*finId );
+        }
+        Th_CnfWriteObj( pCnf, tObj, vFanVars, 3*tObj->Id );
     }
-    Vec_StrFree( sCNF );
+    Vec_IntFree( vFanVars );
     return thPOList;
 }
 
-void Recurrsive_CNF(FILE* oFile, Thre_S* t, Vec_Str_t* sCNF, int thre, int lvl)
-{
-    //if (lvl >= Vec_IntSize(t->Fanins))  return;
-    assert(lvl < Vec_IntSize(t->Fanins));
-   
-    Vec_Str_t * pos_cof_CNF = Vec_StrDup( sCNF );
-    Vec_StrAppend( pos_cof_CNF, "-" );
-    // ID X 3
-    Vec_StrPrintNum( pos_cof_CNF, 3 * Vec_IntEntry(t->Fanins, lvl));
-    Vec_StrAppend( pos_cof_CNF, " ");
-
-    Vec_Str_t * neg_cof_CNF = Vec_StrDup( sCNF );
-    // ID X3
-    Vec_StrPrintNum( neg_cof_CNF, 3 * Vec_IntEntry(t->Fanins, lvl));
-    Vec_StrAppend( neg_cof_CNF, " ");
-    
-    
-    int current_w = Vec_IntEntry(t->weights, lvl);
-    int maxF  = Thre_LocalMax(t, lvl);
-    int minF  = Thre_LocalMin(t, lvl);
-    
-    int pos_cof_thre = thre - current_w;
-    if ( pos_cof_thre <= minF) {
-        // on-set
-        Vec_StrPush( pos_cof_CNF, '\0');
-        fprintf(oFile,"%s%d 0\n", pos_cof_CNF->pArray, 3*t->Id);
-    }
-    else if ( maxF < pos_cof_thre ){
-        // off-set
-        Vec_StrPush( pos_cof_CNF, '\0');
-        fprintf(oFile,"%s-%d 0\n", pos_cof_CNF->pArray, 3*t->Id);
-    }
-    else
-        Recurrsive_CNF(oFile, t, pos_cof_CNF, pos_cof_thre, lvl+1);
-    
-    int neg_cof_thre = thre;
-    if( neg_cof_thre <= minF){
-        // on-set
-        Vec_StrPush( neg_cof_CNF, '\0');
-        fprintf(oFile,"%s%d 0\n", neg_cof_CNF->pArray, 3*t->Id);
-    }
-    else if ( maxF < neg_cof_thre ){
-        // off-set
-        Vec_StrPush( neg_cof_CNF, '\0');
-        fprintf(oFile,"%s-%d 0\n", neg_cof_CNF->pArray, 3*t->Id);
-    }
-    else
-        Recurrsive_CNF(oFile, t, neg_cof_CNF, neg_cof_thre, lvl+1);
-    Vec_StrFree(pos_cof_CNF);
-    Vec_StrFree(neg_cof_CNF);
-    
-} 
-
-
+// sums of the fanins after lvl , read from the cached prefix sums
 int Thre_LocalMax(Thre_S* t, int lvl)
 {
-    int max = 0;
-    int i;
-    int size = Vec_IntSize(t->weights);
-    for( i = lvl+1 ; i < size; ++i )
-        if(Vec_IntEntry( t->weights, i) > 0)
-            max += Vec_IntEntry( t->weights, i );
-    return max;
+    return Th_ObjSumPos( t, lvl+1, Vec_IntSize(t->weights)-1 );
 }
 
 int Thre_LocalMin(Thre_S* t, int lvl)
 {
-    int min = 0;
-    int i;
-    int size = Vec_IntSize(t->weights);
-    for( i = lvl+1 ; i < size; ++i )
-        if(Vec_IntEntry( t->weights, i) < 0)
-            min += Vec_IntEntry( t->weights, i );
-    return min;
+    return Th_ObjSumNeg( t, lvl+1, Vec_IntSize(t->weights)-1 );
 }
 
 // NZ : including current level
 int Th_LocalMax( Thre_S * t , int head , int tail )
 {
-    int max = 0;
-    int i;
-    //int size = Vec_IntSize(t->weights);
-    for ( i = head ; i <= tail ; ++i )
-        if ( Vec_IntEntry( t->weights , i ) > 0 )
-            max += Vec_IntEntry( t->weights , i );
-    return max;
+    return ( head > tail ) ? 0 : Th_ObjSumPos( t , head , tail );
 }
 
 int Th_LocalMin( Thre_S * t , int head , int tail )
 {
-    int min = 0;
-    int i;
-    //int size = Vec_IntSize(t->weights);
-    for ( i = head ; i <= tail ; ++i )
-        if ( Vec_IntEntry( t->weights , i) < 0 )
-            min += Vec_IntEntry( t->weights , i );
-    return min;
+    return ( head > tail ) ? 0 : Th_ObjSumNeg( t , head , tail );
 }
 // NZ : including current level
 
 Thre_S* slow_sortByWeights( Thre_S* tObj )
 {
-    Thre_S* newNode = ABC_ALLOC( Thre_S, 1 );
-    newNode-> Fanouts = NULL;
-    newNode-> Fanins  = Vec_IntDup(tObj->Fanins);
-    newNode-> weights = Vec_IntDup(tObj->weights); 
+    Thre_S* newNode = Th_ObjAlloc();
+    Vec_IntAppend( newNode->Fanins  , tObj->Fanins  );
+    Vec_IntAppend( newNode->weights , tObj->weights );
     newNode-> Id      = tObj->Id;
     newNode-> Type    = tObj->Type;
     newNode-> thre    = tObj->thre;
@@ -266,10 +190,9 @@ Thre_S* slow_sortByWeights( Thre_S* tObj )
 
 Thre_S* slow_sortByAbsWeights( Thre_S* tObj )
 {
-    Thre_S* newNode = ABC_ALLOC( Thre_S, 1 );
-    newNode-> Fanouts = NULL;
-    newNode-> Fanins  = Vec_IntDup(tObj->Fanins);
-    newNode-> weights = Vec_IntDup(tObj->weights); 
+    Thre_S* newNode = Th_ObjAlloc();
+    Vec_IntAppend( newNode->Fanins  , tObj->Fanins  );
+    Vec_IntAppend( newNode->weights , tObj->weights );
     newNode-> Id      = tObj->Id;
     newNode-> Type    = tObj->Type;
     newNode-> thre    = tObj->thre;
@@ -297,9 +220,7 @@ Thre_S* slow_sortByAbsWeights( Thre_S* tObj )
 
 void delete_sortedNode( Thre_S* tObj )
 {
-    Vec_IntFree( tObj->Fanins );
-    Vec_IntFree( tObj->weights );
-    ABC_FREE( tObj );
+    Th_ObjRecycle( tObj );
 }
 
 /////////////////////////////////////////////////////
@@ -311,112 +232,55 @@ void my_Vec_StrPrintNum( Vec_Str_t* s, int n)
     Vec_StrPush( s, '\0' );
 }
 
-Vec_Ptr_t* alan_CNF(FILE* oFile, Abc_Ntk_t * pNtk)
+// literal of the fanin of an AIG node in the VAR naming of alan_CNF
+static inline int alan_FaninLit( Abc_Obj_t * pFanin, int fCompl )
+{
+    int Var = Abc_ObjIsPi(pFanin) ? 3*Abc_ObjId(pFanin) : 3*Abc_ObjId(pFanin) +1;
+    return fCompl ? -Var : Var;
+}
+
+Vec_Ptr_t* alan_CNF(Th_CnfMan_t* pCnf, Abc_Ntk_t * pNtk)
 {
     /* VAR naming:
      * PI:  3*id
      * PO:  3*id +1
      * aig: 3*id +1
-     * be care of const fanins (only @ PO)
+     * CONST1: 1 ( 3*0 +1 ) , fixed by a unit clause
      */
 
-    Vec_Str_t * sNode = Vec_StrAlloc(5);
-    Vec_Str_t * sFin0 = Vec_StrAlloc(5);
-    Vec_Str_t * sFin1 = Vec_StrAlloc(5);
     Vec_Ptr_t * aigPOList = Vec_PtrAlloc(10);
-    int i;
+    int i, pLits[3], Node, Fin0, Fin1;
     Abc_Obj_t * pObj;
     Abc_NtkForEachObj( pNtk, pObj, i ){
-        if( pObj->Type == ABC_OBJ_PI || pObj->Type == ABC_OBJ_CONST1 )
+        if( pObj->Type == ABC_OBJ_PI )
+            continue;
+        if( pObj->Type == ABC_OBJ_CONST1 ){
+            assert( Abc_ObjId(pObj) == 0 );
+            pLits[0] = 1;
+            Th_CnfManAddClause( pCnf, pLits, 1 );
             continue;
+        }
 
+        Node = 3*Abc_ObjId(pObj) +1;
+        Fin0 = alan_FaninLit( Abc_ObjFanin0(pObj), Abc_ObjFaninC0(pObj) );
         if( pObj->Type == ABC_OBJ_PO ){
             Vec_PtrPush( aigPOList, pObj);
-            Abc_Obj_t * pFin0 = Abc_ObjFanin0(pObj);
-            int NodeId = Abc_ObjId(pObj);
-            int Fin0Id = Abc_ObjId(pFin0);
-           
-            Vec_StrClear( sNode );
-            my_Vec_StrPrintNum( sNode, NodeId*3 +1);
-
-            //TODO: consider CONST fanins
-            Vec_StrClear( sFin0 );
-            if ( pFin0->Type == ABC_OBJ_PI )
-                my_Vec_StrPrintNum( sFin0, Fin0Id*3 );
-            else
-                my_Vec_StrPrintNum( sFin0, Fin0Id*3 +1);
-
-            if(Abc_ObjFaninC0(pObj)){
-            //    printf( "!%s -> %s\n", sFin0->pArray, sNode->pArray);
-                fprintf(oFile, "-%s -%s 0\n", sFin0->pArray, sNode->pArray);
-                fprintf(oFile, " %s  %s 0\n", sFin0->pArray, sNode->pArray);
-            }
-            else{
-            //    printf( " %s -> %s\n", sFin0->pArray, sNode->pArray);
-                fprintf(oFile, " %s -%s 0\n", sFin0->pArray, sNode->pArray);
-                fprintf(oFile, "-%s  %s 0\n", sFin0->pArray, sNode->pArray);
-            }
-
+            // Node <-> Fin0
+            pLits[0] =  Fin0; pLits[1] = -Node;
+            Th_CnfManAddClause( pCnf, pLits, 2 );
+            pLits[0] = -Fin0; pLits[1] =  Node;
+            Th_CnfManAddClause( pCnf, pLits, 2 );
         }
         else{ 
-            // pObj->Type == ABC_OBJ_NODE
-            Abc_Obj_t * pFin0 = Abc_ObjFanin0(pObj);
-            Abc_Obj_t * pFin1 = Abc_ObjFanin1(pObj);
-            int NodeId = Abc_ObjId(pObj);
-            int Fin0Id = Abc_ObjId(pFin0);
-            int Fin1Id = Abc_ObjId(pFin1);
-            
-            Vec_StrClear( sNode );
-            my_Vec_StrPrintNum( sNode, NodeId*3 +1);
-            
-            // TODO: consider CONST fanins
-            //  need to check faninNode is aig or PI
-            Vec_StrClear( sFin0 );
-            if ( pFin0->Type == ABC_OBJ_PI )
-                my_Vec_StrPrintNum( sFin0, Fin0Id*3 );
-            else
-                my_Vec_StrPrintNum( sFin0, Fin0Id*3 +1);
-            
-            Vec_StrClear( sFin1 );
-            if ( pFin1->Type == ABC_OBJ_PI )
-                my_Vec_StrPrintNum( sFin1, Fin1Id*3 );
-            else
-                my_Vec_StrPrintNum( sFin1, Fin1Id*3 +1);
-            
-            if( Abc_ObjFaninC0(pObj) == 0 && Abc_ObjFaninC1(pObj) == 0){
-                //printf(" %s  &  %s -> %s\n", sFin0->pArray, sFin1->pArray, sNode->pArray);
-                fprintf(oFile," %s -%s 0\n", sFin0->pArray, sNode->pArray);
-                fprintf(oFile," %s -%s 0\n", sFin1->pArray, sNode->pArray);
-                fprintf(oFile,"-%s -%s  %s 0\n",
-                        sFin0->pArray, sFin1->pArray, sNode->pArray);
-
-            }
-            else if( Abc_ObjFaninC0(pObj) == 1 && Abc_ObjFaninC1(pObj) == 0){
-                //printf("!%s  &  %s -> %s\n", sFin0->pArray, sFin1->pArray, sNode->pArray);
-                fprintf(oFile,"-%s -%s 0\n", sFin0->pArray, sNode->pArray);
-                fprintf(oFile," %s -%s 0\n", sFin1->pArray, sNode->pArray);
-                fprintf(oFile," %s -%s  %s 0\n",
-                        sFin0->pArray, sFin1->pArray, sNode->pArray);
-            }
-            else if( Abc_ObjFaninC0(pObj) == 0 && Abc_ObjFaninC1(pObj) == 1){
-                //printf(" %s  & !%s -> %s\n", sFin0->pArray, sFin1->pArray, sNode->pArray);
-                fprintf(oFile," %s -%s 0\n", sFin0->pArray, sNode->pArray);
-                fprintf(oFile,"-%s -%s 0\n", sFin1->pArray, sNode->pArray);
-                fprintf(oFile,"-%s  %s  %s 0\n",
-                        sFin0->pArray, sFin1->pArray, sNode->pArray);
-            }
-            else {
-                //printf("!%s  & !%s -> %s\n", sFin0->pArray, sFin1->pArray, sNode->pArray);
-                fprintf(oFile,"-%s -%s 0\n", sFin0->pArray, sNode->pArray);
-                fprintf(oFile,"-%s -%s 0\n", sFin1->pArray, sNode->pArray);
-                fprintf(oFile," %s  %s  %s 0\n",
-                        sFin0->pArray, sFin1->pArray, sNode->pArray);
-            }
+            // pObj->Type == ABC_OBJ_NODE : Node <-> Fin0 & Fin1
+            Fin1 = alan_FaninLit( Abc_ObjFanin1(pObj), Abc_ObjFaninC1(pObj) );
+            pLits[0] =  Fin0; pLits[1] = -Node;
+            Th_CnfManAddClause( pCnf, pLits, 2 );
+            pLits[0] =  Fin1; pLits[1] = -Node;
+            Th_CnfManAddClause( pCnf, pLits, 2 );
+            pLits[0] = -Fin0; pLits[1] = -Fin1; pLits[2] = Node;
+            Th_CnfManAddClause( pCnf, pLits, 3 );
         }
     }
-    // Destructor
-    Vec_StrFree( sNode );
-    Vec_StrFree( sFin0 );
-    Vec_StrFree( sFin1 );
     return aigPOList;
 }
@@ -45,27 +45,32 @@ extern int   MinF                 ( Vec_Int_t * , int );
 extern void  Th_DumpObj           ( const Thre_S * );
 // main functions
 Pair_S*    Th_CalKLIf             ( const Thre_S * , const Thre_S * , int , int , int );
-Pair_S*    Th_CalKLDP             ( const Thre_S * , const Thre_S * , int , int , int );
+Pair_S*    Th_CalKLDP             ( const Thre_S * , const Thre_S * , int , int , int , Vec_Wrd_t * );
 // helper functions
 void       Th_KLCheckCond         ( const Thre_S * , int , int , int , int * );
+void       Th_KLObjView           ( const Thre_S * , int , int * , int * , int * );
+int        Th_KLObjSubSum         ( const Thre_S * , int , int , Vec_Wrd_t * );
 // if conditions
-void       Th_IfCoeff             ( const Thre_S * , int , int * , int * );
+void       Th_IfCoeff             ( const Thre_S * , int , int , int * , int * );
+void       Th_IfCoeffVal          ( int , int , int , int , int * , int * );
 Pair_S*    Th_IfSolveKL           ( int * , int * , int );
+void       Th_IfSolveKLPair       ( int * , int * , int , Pair_S * );
 int        Th_IfCheckCoeff        ( int * , int * );
 int        Th_IfCheckKL           ( Pair_S * , int * , int * );
 // iff conditions
-void       Th_DPCoeff             ( const Thre_S * , const Thre_S * , int , int , int , int * , int * );
-int        Th_subSum              ( const Thre_S * , int , int , int );
+void       Th_DPCoeff             ( const Thre_S * , const Thre_S * , int , int , int , int * , int * , Vec_Wrd_t * );
+void       Th_DPCoeffVal          ( int , int , int , int , const Thre_S * , int , int , int , int * , int * , Vec_Wrd_t * );
+int        Th_subSum              ( const Thre_S * , int , int , int , Vec_Wrd_t * );
 Vec_Int_t* Th_subSumCollectNum    ( const Thre_S * , int );
-int        Th_subSumSolveDP       ( Vec_Int_t * , int , int );
-int        Th_subSumOptValue      ( int * , int , int , int , int );
-int**      Th_Alloc2DArray        ( int , int );
-void       Th_Free2DArray         ( int ** , int );
+int        Th_subSumSolveDP       ( Vec_Int_t * , int , int , Vec_Wrd_t * );
+int        Th_subSumSolveBits     ( Vec_Int_t * , int , int , int , Vec_Wrd_t * );
+int        Th_subSumOptValue      ( word * , int , int , int , int );
 Pair_S*    Th_DPSolveKL           ( int * , int * , int );
+void       Th_DPSolveKLPair       ( int * , int * , int , Pair_S * );
 int        Th_DPCheckCoeff        ( int * , int * , int );
 int        Th_DPCheckKL           ( Pair_S * , int * , int * );
 int        Th_DPDivRound          ( int , int );
-int        Th_DPFindIntK          ( int , int , int , int , int , int );
+int        Th_DPFindIntK          ( int * , int , int , int , int , int );
 int        Th_ObjIsConst          ( const Thre_S * );
 // dumper functions
 void       Th_dumpCoeff           ( int * , int * );
@@ -79,7 +84,8 @@ void       Th_dumpCond            ( int * );
 
   Synopsis    [Calculate K and L by if conditions.]
 
-  Description []
+  Description [fInvert : the connecting weight w is negative (given as |w|);
+               tObj1 is then read in inverted polarity, see Th_KLObjView().]
                
   SideEffects []
 
@@ -101,7 +107,7 @@ Th_CalKLIf( const Thre_S * tObj1 , const Thre_S * tObj2 , int nFanin , int w , i
 	Th_KLCheckCond( tObj2 , nFanin , w , fInvert , cond );
 	//Th_dumpCond( cond );
 	// 2. compute coefficients
-	Th_IfCoeff( tObj1 , w , cond , n );
+	Th_IfCoeff( tObj1 , w , fInvert , cond , n );
 	//Th_dumpCoeff( cond , n );
 	// 3. compute K and L	
 	pair = Th_IfSolveKL( cond , n , w );
@@ -112,7 +118,8 @@ Th_CalKLIf( const Thre_S * tObj1 , const Thre_S * tObj2 , int nFanin , int w , i
 
   Synopsis    [Calculate K and L by dynamic programming.]
 
-  Description []
+  Description [Polarity of tObj1 as in Th_CalKLIf(). vRow is the subset
+               sum scratch of the caller, see Th_subSumSolveBits().]
                
   SideEffects []
 
@@ -121,7 +128,7 @@ Th_CalKLIf( const Thre_S * tObj1 , const Thre_S * tObj2 , int nFanin , int w , i
 ***********************************************************************/
 
 Pair_S* 
-Th_CalKLDP( const Thre_S * tObj1 , const Thre_S * tObj2 , int nFanin , int w , int fInvert )
+Th_CalKLDP( const Thre_S * tObj1 , const Thre_S * tObj2 , int nFanin , int w , int fInvert , Vec_Wrd_t * vRow )
 {
 	/*printf( "Collapsing id=%d and id =%d\n" , tObj1->Id , tObj2->Id );
 	if ( tObj1->Id == 8272 && tObj2->Id == 8273 ) {
@@ -140,7 +147,7 @@ Th_CalKLDP( const Thre_S * tObj1 , const Thre_S * tObj2 , int nFanin , int w , i
 	Th_KLCheckCond( tObj2 , nFanin , w , fInvert , cond );
 	//Th_dumpCond( cond );
 	// 2. compute coefficients
-	Th_DPCoeff( tObj1 , tObj2 , nFanin , w , fInvert , cond , n );
+	Th_DPCoeff( tObj1 , tObj2 , nFanin , w , fInvert , cond , n , vRow );
 	//Th_dumpCoeff( cond , n );
 	// 3. compute K and L	
 	pair = Th_DPSolveKL( cond , n , w );
@@ -151,8 +158,8 @@ int
 Th_ObjIsConst( const Thre_S * tObj )
 {
 	int max , min;
-	max = MaxF( tObj->weights , Vec_IntSize(tObj->weights) );
-	min = MinF( tObj->weights , Vec_IntSize(tObj->weights) );
+	max = Th_ObjMaxF( tObj , -1 );
+	min = Th_ObjMinF( tObj , -1 );
 	return ( max < tObj->thre || min >= tObj->thre );
 }
 
@@ -175,8 +182,8 @@ Th_KLCheckCond( const Thre_S * tObj2 , int nFanin , int w , int fInvert , int *
    int T2 , minf2 , maxf2 , condition;
 
 	T2        = (fInvert) ? (tObj2->thre + w) : (tObj2->thre);
-	maxf2     = MaxF( tObj2->weights , nFanin );
-	minf2     = MinF( tObj2->weights , nFanin );
+	maxf2     = Th_ObjMaxF( tObj2 , nFanin );
+	minf2     = Th_ObjMinF( tObj2 , nFanin );
 	// assume cond3 must be satisfied, OK?
 	// if cond3 = 0 --> no connection between obj1 and obj2
 	condition  = T2 - w - 1;
@@ -185,11 +192,50 @@ Th_KLCheckCond( const Thre_S * tObj2 , int nFanin , int w , int fInvert , int *
 	if ( maxf2 >= condition ) cond[1] = 1;
 }
 
+/**Function*************************************************************
+
+  Synopsis    [Polarity view of tObj1.]
+
+  Description [With fInvert, tObj1 is read as its complement (weights
+               negated, threshold 1-T1) without building a copy. 
+               Th_KLObjView() returns the threshold and fanin bounds of
+               the view; Th_KLObjSubSum() returns the max subset sum of
+               the viewed weights below T1 (the threshold of the view).]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+void
+Th_KLObjView( const Thre_S * tObj1 , int fInvert , int * pT1 , int * pMaxf1 , int * pMinf1 )
+{
+	if ( fInvert ) {
+		*pT1    = 1 - tObj1->thre;
+		*pMaxf1 = -Th_ObjMinF( tObj1 , -1 );
+		*pMinf1 = -Th_ObjMaxF( tObj1 , -1 );
+	}
+	else {
+		*pT1    = tObj1->thre;
+		*pMaxf1 = Th_ObjMaxF( tObj1 , -1 );
+		*pMinf1 = Th_ObjMinF( tObj1 , -1 );
+	}
+}
+
+int
+Th_KLObjSubSum( const Thre_S * tObj1 , int T1 , int fInvert , Vec_Wrd_t * vRow )
+{
+	// max{ -s : s subset sum , -s <= T1-1 } = -min{ s : s >= 1-T1 }
+	return fInvert ? -Th_subSum( tObj1 , Vec_IntSize(tObj1->weights) , -T1+1 , 0 , vRow ):
+	                  Th_subSum( tObj1 , Vec_IntSize(tObj1->weights) ,  T1-1 , 1 , vRow );
+}
+
 /**Function*************************************************************
 
   Synopsis    [Compute if coefficients based on conditions.]
 
-  Description []
+  Description [Th_IfCoeffVal() works on the threshold and fanin bounds only.]
                
   SideEffects []
 
@@ -198,12 +244,16 @@ Th_KLCheckCond( const Thre_S * tObj2 , int nFanin , int w , int fInvert , int *
 ***********************************************************************/
 
 void
-Th_IfCoeff( const Thre_S * tObj1 , int w , int * cond , int * n )
+Th_IfCoeff( const Thre_S * tObj1 , int w , int fInvert , int * cond , int * n )
 {
 	int T1 , maxf1 , minf1;
-	T1      = tObj1->thre;
-	maxf1   = MaxF( tObj1->weights , Vec_IntSize( tObj1->weights ) ); 
-	minf1   = MinF( tObj1->weights , Vec_IntSize( tObj1->weights ) ); 
+	Th_KLObjView( tObj1 , fInvert , &T1 , &maxf1 , &minf1 );
+	Th_IfCoeffVal( T1 , maxf1 , minf1 , w , cond , n );
+}
+
+void
+Th_IfCoeffVal( int T1 , int maxf1 , int minf1 , int w , int * cond , int * n )
+{
    if ( cond[0] ) n[0] = maxf1 - T1; 
 	if ( cond[1] ) {
 		n[1]  = w;
@@ -217,7 +267,9 @@ Th_IfCoeff( const Thre_S * tObj1 , int w , int * cond , int * n )
 
   Synopsis    [Compute iff coefficients based on conditions.]
 
-  Description []
+  Description [Th_DPCoeffVal() takes tObj1 by its threshold, fanin bounds
+               and max subset sum below T1, so that an inverted view of
+               tObj1 needs no copy.]
                
   SideEffects []
 
@@ -227,28 +279,34 @@ Th_IfCoeff( const Thre_S * tObj1 , int w , int * cond , int * n )
 
 void
 Th_DPCoeff( const Thre_S * tObj1 , const Thre_S * tObj2 , 
-		      int nFanin , int w , int fInvert , int * cond , int * n )
+		      int nFanin , int w , int fInvert , int * cond , int * n , Vec_Wrd_t * vRow )
 {
-	int T1 , T2 , maxf1 , minf1 , sumDP;
-	T1      = tObj1->thre;
+	int T1 , maxf1 , minf1 , sum1;
+	Th_KLObjView( tObj1 , fInvert , &T1 , &maxf1 , &minf1 );
+	sum1    = Th_KLObjSubSum( tObj1 , T1 , fInvert , vRow );
+	Th_DPCoeffVal( T1 , maxf1 , minf1 , sum1 , tObj2 , nFanin , w , fInvert , cond , n , vRow );
+}
+
+void
+Th_DPCoeffVal( int T1 , int maxf1 , int minf1 , int sum1 , const Thre_S * tObj2 , 
+		         int nFanin , int w , int fInvert , int * cond , int * n , Vec_Wrd_t * vRow )
+{
+	int T2 , sumDP;
 	T2      = (fInvert) ? (tObj2->thre + w) : (tObj2->thre);
-	maxf1   = MaxF( tObj1->weights , Vec_IntSize( tObj1->weights ) ); 
-	minf1   = MinF( tObj1->weights , Vec_IntSize( tObj1->weights ) ); 
 	sumDP   = 0; // to be computed by dynamic programming
    if ( cond[0] ) {
-      sumDP = Th_subSum( tObj2 , nFanin , T2-w-1 , 1 );
+      sumDP = Th_subSum( tObj2 , nFanin , T2-w-1 , 1 , vRow );
 		n[0]  = T2 - w - sumDP;
 		n[1]  = maxf1 - T1;
 	}
 	if ( cond[1] ) {
-      sumDP = Th_subSum( tObj2 , nFanin , T2 , 0 );
+      sumDP = Th_subSum( tObj2 , nFanin , T2 , 0 , vRow );
 		n[2]  = sumDP + w - T2;
 		n[3]  = T1 - minf1;
 	}
    // assume 3-rd cond must be satisfied
-	sumDP = Th_subSum( tObj1 , Vec_IntSize(tObj1->weights) , T1-1 , 1 );
-	n[4]  = T1 - sumDP; 
-	sumDP = Th_subSum( tObj2 , nFanin , T2-1 , 1 );
+	n[4]  = T1 - sum1; 
+	sumDP = Th_subSum( tObj2 , nFanin , T2-1 , 1 , vRow );
 	n[5]  = sumDP + w - T2; 
 }
 
@@ -265,15 +323,12 @@ Th_DPCoeff( const Thre_S * tObj1 , const Thre_S * tObj2 ,
 ***********************************************************************/
 
 int
-Th_subSum( const Thre_S * tObj , int nFanin , int bound , int fMax )
+Th_subSum( const Thre_S * tObj , int nFanin , int bound , int fMax , Vec_Wrd_t * vRow )
 {
 	// nFanin : unwanted fanin
 	// fMax   : flag for Max(1) or min(0)
-	Vec_Int_t * numbers;
 	int optValue;
-	numbers   = Th_subSumCollectNum( tObj , nFanin );
-   optValue  = Th_subSumSolveDP( numbers , bound , fMax );
-	Vec_IntFree( numbers );
+   optValue  = Th_subSumSolveBits( tObj->weights , nFanin , bound , fMax , vRow );
 	if ( optValue == TH_MIN ) {
 		printf(" tObj id=%d , nFanin=%d , bound=%d , fMax=%d\n" , tObj->Id , nFanin , bound , fMax);
 		assert(0); // no solutions , something wrong!
@@ -302,7 +357,13 @@ Th_subSumCollectNum( const Thre_S * tObj , int nFanin )
 
   Synopsis    [Using DP to compute subset sum.]
 
-  Description [Core solving process.]
+  Description [Core solving process. The reachable subset sums (the empty
+               subset included, i.e. all fanins at 0) are kept as one row
+               of bits, bit j standing for sum minSum+j; adding a number
+               is a word-parallel shift-or of the row onto itself. The row
+               lives in vRow, a scratch buffer owned by the caller and
+               reused across calls (see Th_CollapseNtk()). The number
+               at position nFanin is skipped (none if out of range).]
                
   SideEffects []
 
@@ -311,75 +372,67 @@ Th_subSumCollectNum( const Thre_S * tObj , int nFanin )
 ***********************************************************************/
 
 int
-Th_subSumSolveDP( Vec_Int_t * numbers , int bound , int fMax )
+Th_subSumSolveDP( Vec_Int_t * numbers , int bound , int fMax , Vec_Wrd_t * vRow )
 {
-	int ** matrix;
-	int num , maxSum , minSum , range , Entry , optValue , i , j;
+	return Th_subSumSolveBits( numbers , Vec_IntSize( numbers ) , bound , fMax , vRow );
+}
+
+int
+Th_subSumSolveBits( Vec_Int_t * numbers , int nFanin , int bound , int fMax , Vec_Wrd_t * vRow )
+{
+	word * pRow , Carry;
+	int maxSum , minSum , range , nWords , Entry , wShift , bShift , i , k;
    
-	// 1. prepare matrix
-	num    = Vec_IntSize( numbers );
-	maxSum = MaxF( numbers , num );
-	minSum = MinF( numbers , num );
+	// 1. prepare the row
+	maxSum = MaxF( numbers , nFanin );
+	minSum = MinF( numbers , nFanin );
 	if ( bound == 0 )     return 0;
 	if ( bound > maxSum ) return fMax ? maxSum : TH_MIN;
 	if ( bound < minSum ) return fMax ? TH_MIN : minSum;
 	range  = maxSum - minSum + 1;
-	matrix = Th_Alloc2DArray( num , range );
+	nWords = (range >> 6) + 1;
+	Vec_WrdFill( vRow , nWords , 0 );
+	pRow   = Vec_WrdArray( vRow );
+	pRow[(-minSum) >> 6] |= (word)1 << ((-minSum) & 63); // empty subset
 
-   // 2. compute matix
-	Entry  = Vec_IntEntry( numbers , 0 );
-	for ( j = 0 ; j < range ; ++j ) {
-		if ( Entry == minSum + j ) matrix[0][j] = 1;
-		else matrix[0][j] = 0;
-	}
-	for ( i = 1 ; i < num ; ++i ) {
-		Entry = Vec_IntEntry( numbers , i );
-	   for ( j = 0 ; j < range ; ++j ) {
-		   if ( matrix[i-1][j] || Entry == minSum + j ) 
-				matrix[i][j] = 1;
-			else if ( j - Entry >= 0 && j - Entry <= range - 1 )
-			   matrix[i][j] = matrix[i-1][j-Entry];
-			else matrix[i][j] = 0;
+   // 2. add numbers one by one : row |= row shifted by Entry
+	Vec_IntForEachEntry( numbers , Entry , i )
+	{
+		if ( i == nFanin || Entry == 0 ) continue;
+		wShift = Abc_AbsInt( Entry ) >> 6;
+		bShift = Abc_AbsInt( Entry ) & 63;
+		if ( Entry > 0 ) { // towards larger sums , high words first
+			for ( k = nWords - 1 ; k >= wShift ; --k ) {
+				Carry = ( bShift && k > wShift ) ? pRow[k-wShift-1] >> (64-bShift) : 0;
+				pRow[k] |= (pRow[k-wShift] << bShift) | Carry;
+			}
+		}
+		else { // towards smaller sums , low words first
+			for ( k = 0 ; k + wShift < nWords ; ++k ) {
+				Carry = ( bShift && k + wShift + 1 < nWords ) ? pRow[k+wShift+1] << (64-bShift) : 0;
+				pRow[k] |= (pRow[k+wShift] >> bShift) | Carry;
+			}
 		}
 	}
 	// 3. find optimal value
-   optValue = Th_subSumOptValue( matrix[num-1] , minSum , range , bound , fMax );	
-	Th_Free2DArray( matrix , num );
-   return optValue;
-}
-
-int**
-Th_Alloc2DArray( int row , int column )
-{
-   int ** matrix;
-	int i;
-
-	matrix = (int**) malloc( row * sizeof(int*) );
-	for ( i = 0 ; i < row ; ++i )
-	   matrix[i] = (int*) malloc( column * sizeof(int) );
-	return matrix;
-}
-
-void
-Th_Free2DArray( int ** matrix , int row )
-{
-	assert( matrix );
-	int i;
-	for ( i = 0 ; i < row ; ++i ) free( matrix[i] );
-	free( matrix );
+   return Th_subSumOptValue( pRow , minSum , range , bound , fMax );
 }
 
 int
-Th_subSumOptValue( int * matLastRow , int minSum , int range , int bound , int fMax )
+Th_subSumOptValue( word * pRow , int minSum , int range , int bound , int fMax )
 {
 	int j;
    if ( fMax ) { // maximized
-      for ( j = bound - minSum ; j > -1 ; --j )
-		   if ( matLastRow[j] ) return minSum + j;
+      for ( j = bound - minSum ; j > -1 ; --j ) {
+			if ( !pRow[j >> 6] ) { j &= ~63; continue; } // skip empty word
+		   if ( (pRow[j >> 6] >> (j & 63)) & 1 ) return minSum + j;
+		}
 	}
 	else { // minimized
-		for ( j = bound - minSum ; j < range ; ++j )
-			if ( matLastRow[j] ) return minSum + j;
+		for ( j = bound - minSum ; j < range ; ++j ) {
+			if ( !pRow[j >> 6] ) { j |= 63; continue; } // skip empty word
+			if ( (pRow[j >> 6] >> (j & 63)) & 1 ) return minSum + j;
+		}
 	}
 	return TH_MIN;
 }
@@ -388,7 +441,7 @@ Th_subSumOptValue( int * matLastRow , int minSum , int range , int bound , int f
 
   Synopsis    [If : Solve for K and L analytically.]
 
-  Description []
+  Description [Th_IfSolveKLPair() fills a caller-provided pair, no allocation.]
                
   SideEffects []
 
@@ -398,6 +451,15 @@ Th_subSumOptValue( int * matLastRow , int minSum , int range , int bound , int f
 
 Pair_S*
 Th_IfSolveKL( int * cond , int * n , int w )
+{
+	Pair_S * pair;
+	pair = ABC_ALLOC( Pair_S , 1 );
+	Th_IfSolveKLPair( cond , n , w , pair );
+	return pair;
+}
+
+void
+Th_IfSolveKLPair( int * cond , int * n , int w , Pair_S * pair )
 {
 #ifdef CHECK
 	if ( !Th_IfCheckCoeff( cond , n ) ) {
@@ -405,8 +467,6 @@ Th_IfSolveKL( int * cond , int * n , int w )
 		assert(0);
 	}
 #endif
-	Pair_S * pair;
-	pair = ABC_ALLOC( Pair_S , 1 );
 	pair->IntK = pair->IntL = 0;
 
 	if ( cond[0] && cond[1] ) {
@@ -450,7 +510,6 @@ Th_IfSolveKL( int * cond , int * n , int w )
 	// restrict k,l <= 10
 	//if ( pair->IntK > 10 || pair->IntL > 10 )
 	  // pair->IntK = pair->IntL = 0;
-	return pair;
 }
 
 int
@@ -469,7 +528,6 @@ Th_IfCheckKL( Pair_S * pair , int * cond , int * n )
 	k = pair->IntK;
 	l = pair->IntL;
 
-	//printf( "\tTh_IfCheckKL() : k = %d , l = %d\n" , k , l );
 	if ( k == 0 && l == 0 )                         return 1;
 	if ( !(k > 0 && l > 0) )                        return 0;
 	if ( cond[0] && !( l >= k * n[0] + 1 ) )        return 0;
@@ -482,7 +540,7 @@ Th_IfCheckKL( Pair_S * pair , int * cond , int * n )
 
   Synopsis    [DP : Solve for K and L analytically.]
 
-  Description []
+  Description [Th_DPSolveKLPair() fills a caller-provided pair, no allocation.]
                
   SideEffects []
 
@@ -493,15 +551,24 @@ Th_IfCheckKL( Pair_S * pair , int * cond , int * n )
 Pair_S*
 Th_DPSolveKL( int * cond , int * n , int w )
 {
+	Pair_S * pair;
+	pair = ABC_ALLOC( Pair_S , 1 );
+	Th_DPSolveKLPair( cond , n , w , pair );
+	return pair;
+}
+
+void
+Th_DPSolveKLPair( int * cond , int * n , int w , Pair_S * pair )
+{
+	pair->IntK = pair->IntL = 0;
+	// cond3 fails : tObj1 is redundant to tObj2 , no K and L
+	if ( n[5] < 0 ) return;
 #ifdef CHECK
 	if ( !Th_DPCheckCoeff( cond , n , w ) ) {
 		printf( "Th_DPSolveKL() : coefficient check fails...\n" );
 		assert(0);
 	}
 #endif
-	Pair_S * pair;
-	pair = ABC_ALLOC( Pair_S , 1 );
-	pair->IntK = pair->IntL = 0;
 
 	if ( cond[0] && cond[1] ) {
 		if ( (n[0]*n[4] > n[1]*n[5]) && (n[2]*n[4] > n[3]*n[5]) ) {
@@ -511,24 +578,24 @@ Th_DPSolveKL( int * cond , int * n , int w )
 			slope = y / x;
 			if ( (double)n[2] >= n[3]*slope ) {
 	         pair->IntL = Th_DPDivRound( n[1]+n[4] , n[0]*n[4]-n[1]*n[5] );
-			   pair->IntK = Th_DPFindIntK( pair->IntL , n[4] , n[5] , n[0] , n[1] , 1 );
+			   pair->IntK = Th_DPFindIntK( &pair->IntL , n[4] , n[5] , n[0] , n[1] , 1 );
 			}
 			else {
 	         pair->IntL = Th_DPDivRound( n[3] , n[2]*n[4]-n[3]*n[5] );
-			   pair->IntK = Th_DPFindIntK( pair->IntL , n[4] , n[5] , n[2] , n[3] , 0 );
+			   pair->IntK = Th_DPFindIntK( &pair->IntL , n[4] , n[5] , n[2] , n[3] , 0 );
 			} 
 		}
 	}
 	else if ( cond[0] ) {
       if ( n[0]*n[4] > n[1]*n[5] ) {
 	      pair->IntL = Th_DPDivRound( n[1]+n[4] , n[0]*n[4]-n[1]*n[5] );
-			pair->IntK = Th_DPFindIntK( pair->IntL , n[4] , n[5] , n[0] , n[1] , 1 );
+			pair->IntK = Th_DPFindIntK( &pair->IntL , n[4] , n[5] , n[0] , n[1] , 1 );
 		}
 	}
 	else if ( cond[1] ) {
       if ( n[2]*n[4] > n[3]*n[5] ) {
 	      pair->IntL = Th_DPDivRound( n[3] , n[2]*n[4]-n[3]*n[5] );
-			pair->IntK = Th_DPFindIntK( pair->IntL , n[4] , n[5] , n[2] , n[3] , 0 );
+			pair->IntK = Th_DPFindIntK( &pair->IntL , n[4] , n[5] , n[2] , n[3] , 0 );
 		}
 	}
 	else {
@@ -544,7 +611,6 @@ Th_DPSolveKL( int * cond , int * n , int w )
 	// restrict k,l <= 10
 	//if ( pair->IntK > 10 || pair->IntL > 10 )
 	  // pair->IntK = pair->IntL = 0;
-	return pair;
 }
 
 int
@@ -563,7 +629,6 @@ Th_DPCheckKL( Pair_S * pair , int * cond , int * n )
 	k = pair->IntK;
 	l = pair->IntL;
 
-	printf( "\tTh_DPCheckKL() : k = %d , l = %d\n" , k , l );
 	if ( k == 0 && l == 0 )                         return 1;
 	if ( !(k > 0 && l > 0) )                        return 0;
 	if ( cond[0] && !( l * n[0] >= k * n[1] + 1 ) ) return 0;
@@ -579,14 +644,15 @@ Th_DPDivRound( int num1 , int num2 )
 }
 
 int
-Th_DPFindIntK( int IntL , int n4 , int n5 , int a , int b , int c )
+Th_DPFindIntK( int * pIntL , int n4 , int n5 , int a , int b , int c )
 {
+	// smallest K with K*n4 >= L*n5+1 , increase L until K*b <= L*a-c holds
+	// (L is returned through pIntL since it may grow)
 	int IntK;
 	while ( 1 ) {
-		if ( (n5*IntL+1) % n4 == 0 ) return (n5*IntL+1) / n4;
-	   IntK = Th_DPDivRound( n5*IntL+1 , n4 );
-		if ( IntK <= (double)(a*IntL-c)/(double)(b) ) return IntK;
-		else ++IntL;
+	   IntK = Th_DPDivRound( n5*(*pIntL)+1 , n4 );
+		if ( IntK * b <= a * (*pIntL) - c ) return IntK;
+		else ++(*pIntL);
 	}
 }
 
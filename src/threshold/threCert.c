@@ -0,0 +1,214 @@
+/**CFile****************************************************************
+
+  FileName    [threCert.c]
+
+  SystemName  [ABC: Logic synthesis and verification system.]
+
+  PackageName [threshold.]
+
+  Synopsis    [Local certificates of collapse steps.]
+
+  Author      [ALCom Lab]
+
+  Affiliation [NTU]
+
+  Date        [Oct 16, 2026.]
+
+  Revision    [$Id: abc.c,v 1.00 2005/06/20 00:00:00 alanmi Exp $]
+
+***********************************************************************/
+
+////////////////////////////////////////////////////////////////////////
+///                          INCLUDES                                ///
+////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include "base/abc/abc.h"
+#include "misc/util/utilTruth.h"
+#include "threshold.h"
+
+////////////////////////////////////////////////////////////////////////
+///                        DECLARATIONS                              ///
+////////////////////////////////////////////////////////////////////////
+
+// supports up to this size are checked by exhaustive simulation
+#define TH_CERT_TT_MAX     16
+// conflict limit of the SAT check of larger supports
+#define TH_CERT_CONF_LIMIT 100000
+
+////////////////////////////////////////////////////////////////////////
+///                     FUNCTION DEFINITIONS                         ///
+////////////////////////////////////////////////////////////////////////
+
+/**Function*************************************************************
+
+  Synopsis    [Local support of a collapse step.]
+
+  Description [The fanins of the pair and of the merged gate , except
+               tObj1 itself and the constant.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+static inline int Th_CertIsConst( int Id )
+{
+    return ((Thre_S*)Vec_PtrEntry( current_TList, Id ))->Type == Th_CONST1;
+}
+
+static Vec_Int_t * Th_CertSupport( const Thre_S * tObj1, const Thre_S * tObj2, const Thre_S * tObjMerge )
+{
+    Vec_Int_t * vSupp = Vec_IntAlloc( 32 );
+    const Thre_S * pGates[3] = { tObj1, tObj2, tObjMerge };
+    int i, k, finId;
+    for ( i = 0; i < 3; i++ )
+        Vec_IntForEachEntry( pGates[i]->Fanins, finId, k )
+            if ( finId != tObj1->Id && !Th_CertIsConst(finId) )
+                Vec_IntPushUnique( vSupp, finId );
+    return vSupp;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Checks a collapse step by its truth tables.]
+
+  Description [Returns 1 if tObjMerge equals tObj2 with tObj1 in place
+               of its fanin , 0 otherwise.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+static void Th_CertSimGate( const Thre_S * tObj, Vec_Int_t * vSupp, word * pElems, word * pConst,
+                            int IdSub, word * pSub, word * pOut, int nWords )
+{
+    word ** ppFans = ABC_ALLOC( word *, Vec_IntSize(tObj->Fanins) + 1 );
+    int k, finId;
+    Vec_IntForEachEntry( tObj->Fanins, finId, k )
+        if ( finId == IdSub )
+            ppFans[k] = pSub;
+        else if ( Th_CertIsConst(finId) )
+            ppFans[k] = pConst;
+        else
+            ppFans[k] = pElems + Vec_IntFind( vSupp, finId ) * nWords;
+    Th_SimObjFans( (Thre_S *)tObj, ppFans, pOut, nWords );
+    ABC_FREE( ppFans );
+}
+
+static int Th_CertTruth( const Thre_S * tObj1, const Thre_S * tObj2, const Thre_S * tObjMerge, Vec_Int_t * vSupp )
+{
+    int nWords = Abc_TtWordNum( Vec_IntSize(vSupp) );
+    word * pElems = ABC_ALLOC( word, nWords * (Vec_IntSize(vSupp) + 4) );
+    word * pConst = pElems + nWords * Vec_IntSize(vSupp);
+    word * pOut1  = pConst + nWords;
+    word * pOut2  = pOut1  + nWords;
+    word * pOutM  = pOut2  + nWords;
+    int RetValue;
+    Abc_TtElemInit2( pElems, Vec_IntSize(vSupp) );
+    Abc_TtConst1( pConst, nWords );
+    Th_CertSimGate( tObj1,     vSupp, pElems, pConst, -1,         NULL,  pOut1, nWords );
+    Th_CertSimGate( tObj2,     vSupp, pElems, pConst, tObj1->Id,  pOut1, pOut2, nWords );
+    Th_CertSimGate( tObjMerge, vSupp, pElems, pConst, -1,         NULL,  pOutM, nWords );
+    RetValue = Abc_TtEqual( pOut2, pOutM, nWords );
+    ABC_FREE( pElems );
+    return RetValue;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Checks a collapse step by SAT.]
+
+  Description [The three gates over the local support as native PB
+               constraints , with the outputs of tObj2 and tObjMerge
+               required to differ. Returns 1 if unsatisfiable , 0 if
+               satisfiable and -1 if undecided.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+static void Th_CertWriteGate( Th_CnfMan_t * pCnf, const Thre_S * tObj, Vec_Int_t * vSupp,
+                              int IdSub, int VarSub, int outVar, Vec_Int_t * vFanVars )
+{
+    int k, finId;
+    Vec_IntClear( vFanVars );
+    Vec_IntForEachEntry( tObj->Fanins, finId, k )
+        if ( finId == IdSub )
+            Vec_IntPush( vFanVars, VarSub );
+        else if ( Th_CertIsConst(finId) )
+            Vec_IntPush( vFanVars, 0 );
+        else
+            Vec_IntPush( vFanVars, Vec_IntFind(vSupp, finId) + 1 );
+    Th_CnfWriteObj( pCnf, (Thre_S *)tObj, vFanVars, outVar );
+}
+
+static int Th_CertSat( const Thre_S * tObj1, const Thre_S * tObj2, const Thre_S * tObjMerge, Vec_Int_t * vSupp )
+{
+    int nSupp = Vec_IntSize( vSupp ), Lit, Status;
+    Th_CnfMan_t * pCnf = Th_CnfManStart( NULL, nSupp + 4, TH_CNF_ENC_PB, 1 );
+    Vec_Int_t * vFanVars = Vec_IntAlloc( 32 );
+    Th_CertWriteGate( pCnf, tObj1,     vSupp, -1,        0,         nSupp + 1, vFanVars );
+    Th_CertWriteGate( pCnf, tObj2,     vSupp, tObj1->Id, nSupp + 1, nSupp + 2, vFanVars );
+    Th_CertWriteGate( pCnf, tObjMerge, vSupp, -1,        0,         nSupp + 3, vFanVars );
+    Th_CnfWriteXor( pCnf, nSupp + 2, nSupp + 3, nSupp + 4 );
+    Lit = nSupp + 4;
+    Th_CnfManAddClause( pCnf, &Lit, 1 );
+    Status = Th_CnfManSolve( pCnf, TH_CERT_CONF_LIMIT, 0 );
+    Vec_IntFree( vFanVars );
+    Th_CnfManStop( pCnf );
+    return Status == -1 ? -1 : !Status;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Checks one collapse step on its local support.]
+
+  Description [tObj1 is a fanin of tObj2 and tObjMerge is the gate that
+               replaces tObj2 ; they are checked before the fanins and
+               fanouts are patched. Supports of at most TH_CERT_TT_MAX
+               inputs are simulated exhaustively , larger ones go to the
+               SAT solver. The outcome is counted in thProfiler and a
+               failed step is reported. Returns 1 if the step is proved ,
+               0 if refuted and -1 if undecided.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+int Th_CollapseCheck( const Thre_S * tObj1, const Thre_S * tObj2, const Thre_S * tObjMerge )
+{
+    abctime clk = Abc_Clock();
+    Vec_Int_t * vSupp = Th_CertSupport( tObj1, tObj2, tObjMerge );
+    int RetValue;
+    thProfiler.numClpCheck++;
+    if ( Vec_IntSize(vSupp) <= TH_CERT_TT_MAX ) {
+        thProfiler.numClpCheckTt++;
+        RetValue = Th_CertTruth( tObj1, tObj2, tObjMerge, vSupp );
+    }
+    else {
+        thProfiler.numClpCheckSat++;
+        RetValue = Th_CertSat( tObj1, tObj2, tObjMerge, vSupp );
+    }
+    if ( RetValue == -1 )
+        thProfiler.numClpCheckUndec++;
+    if ( RetValue == 0 ) {
+        thProfiler.numClpCheckFail++;
+        printf( "Warning : collapsing gate %d into gate %d gives gate %d , which differs on the %d local inputs.\n",
+            tObj1->Id, tObj2->Id, tObjMerge->Id, Vec_IntSize(vSupp) );
+    }
+    Vec_IntFree( vSupp );
+    thProfiler.clkClpCheck += Abc_Clock() - clk;
+    return RetValue;
+}
+
+////////////////////////////////////////////////////////////////////////
+///                       END OF FILE                                ///
+////////////////////////////////////////////////////////////////////////
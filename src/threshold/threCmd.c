@@ -32,12 +32,14 @@
 // I/O commands
 static int Abc_CommandReadThreshold    ( Abc_Frame_t * pAbc, int argc, char ** argv );
 static int Abc_CommandWriteThreshold   ( Abc_Frame_t * pAbc, int argc, char ** argv );
+static int Abc_CommandConvTh           ( Abc_Frame_t * pAbc, int argc, char ** argv );
 static int Abc_CommandPrintThreshold   ( Abc_Frame_t * pAbc, int argc, char ** argv );
 // Synthesis commands
 static int Abc_CommandAig2Th           ( Abc_Frame_t * pAbc, int argc, char ** argv );
 static int Abc_CommandMerge            ( Abc_Frame_t * pAbc, int argc, char ** argv );
 static int Abc_CommandTh2Mux           ( Abc_Frame_t * pAbc, int argc, char ** argv );
 static int Abc_CommandTh2Blif          ( Abc_Frame_t * pAbc, int argc, char ** argv );
+static int Abc_CommandFraigTh          ( Abc_Frame_t * pAbc, int argc, char ** argv );
 // Verification commands
 static int Abc_CommandPB_Threshold     ( Abc_Frame_t * pAbc, int argc, char ** argv );
 static int Abc_CommandCNF_Threshold    ( Abc_Frame_t * pAbc, int argc, char ** argv );
@@ -48,8 +50,18 @@ static int Abc_CommandOAO              ( Abc_Frame_t * pAbc, int argc, char ** a
 // misc commands
 static int Abc_CommandTestTH           ( Abc_Frame_t * pAbc, int argc, char ** argv );
 static int Abc_CommandProfileTh        ( Abc_Frame_t * pAbc, int argc, char ** argv );
+static int Abc_CommandSimTh            ( Abc_Frame_t * pAbc, int argc, char ** argv );
 static void Th_GlobalInit();
 
+// global variables of the threshold package (declared in threshold.h)
+Vec_Ptr_t * current_TList;
+Vec_Ptr_t * cut_TList;
+int         globalRef;
+Th_Stat     thProfiler;
+int         thKLDP;
+int         thClpCheck;
+int         thSimKernel;
+
 ////////////////////////////////////////////////////////////////////////
 ///                     FUNCTION DEFINITIONS                         ///
 ////////////////////////////////////////////////////////////////////////
@@ -73,6 +85,9 @@ Th_GlobalInit()
     current_TList = NULL;
     //another_TList = NULL;
     cut_TList     = NULL;
+    thKLDP        = 1;
+    thClpCheck    = 0;
+    thSimKernel   = TH_SIM_AUTO;
 	 Th_ProfileInit();
 }
 
@@ -82,11 +97,13 @@ Threshold_Init( Abc_Frame_t *pAbc)
 	 Th_GlobalInit();
     Cmd_CommandAdd( pAbc, "z Alcom", "read_th"     , Abc_CommandReadThreshold,  1 );
     Cmd_CommandAdd( pAbc, "z Alcom", "write_th"    , Abc_CommandWriteThreshold, 0 );
+    Cmd_CommandAdd( pAbc, "z Alcom", "conv_th"     , Abc_CommandConvTh,         0 );
     Cmd_CommandAdd( pAbc, "z Alcom", "print_th"    , Abc_CommandPrintThreshold, 0 );
     Cmd_CommandAdd( pAbc, "z Alcom", "aig2th"      , Abc_CommandAig2Th,         1 );
     Cmd_CommandAdd( pAbc, "z Alcom", "merge_th"    , Abc_CommandMerge,          1 );
     Cmd_CommandAdd( pAbc, "z Alcom", "th2blif"     , Abc_CommandTh2Blif,        0 );
     Cmd_CommandAdd( pAbc, "z Alcom", "th2mux"      , Abc_CommandTh2Mux,         1 );
+    Cmd_CommandAdd( pAbc, "z Alcom", "fraig_th"    , Abc_CommandFraigTh,        1 );
     Cmd_CommandAdd( pAbc, "z Alcom", "PB_th"       , Abc_CommandPB_Threshold,   0 );
     Cmd_CommandAdd( pAbc, "z Alcom", "CNF_th"      , Abc_CommandCNF_Threshold,  0 );
     Cmd_CommandAdd( pAbc, "z Alcom", "thverify"    , Abc_CommandThVerify,       0 );
@@ -95,6 +112,7 @@ Threshold_Init( Abc_Frame_t *pAbc)
     Cmd_CommandAdd( pAbc, "z Alcom", "OAO"         , Abc_CommandOAO,            0 );
     Cmd_CommandAdd( pAbc, "z Alcom", "test_th"     , Abc_CommandTestTH,         1 );
     Cmd_CommandAdd( pAbc, "z Alcom", "profile_th"  , Abc_CommandProfileTh,      0 );
+    Cmd_CommandAdd( pAbc, "z Alcom", "sim_th"      , Abc_CommandSimTh,          0 );
 }
 
 void 
@@ -103,6 +121,7 @@ Threshold_End( Abc_Frame_t *pAbc )
 	if ( current_TList ) { DeleteTList( current_TList ); current_TList = NULL; }
 	//if ( another_TList ) { DeleteTList( another_TList ); another_TList = NULL; }
 	if ( cut_TList )     { DeleteTList( cut_TList ); cut_TList = NULL; }
+	Th_ObjManStop();
 }
 
 /**Function*************************************************************
@@ -165,6 +184,8 @@ Abc_CommandReadThreshold( Abc_Frame_t * pAbc, int argc, char ** argv )
 usage:
     Abc_Print( -2, "usage: read_th [-h] <file>\n" );
     Abc_Print( -2, "\t         a reader for threshold gate '.th' files\n" );
+    Abc_Print( -2, "\t         (binary '.thb' format if the file name ends with .thb ,\n" );
+    Abc_Print( -2, "\t         compressed '.th' if it ends with .gz or .bz2)\n" );
     Abc_Print( -2, "\t-h     : print the command usage\n");
     Abc_Print( -2, "\t<file> : the file name\n");
     return 1;
@@ -185,17 +206,22 @@ usage:
 int 
 Abc_CommandWriteThreshold( Abc_Frame_t * pAbc,int argc, char ** argv )
 {
+    Th_Ntk_t * pNtk;
     char ** pArgvNew;
     char * FileName;
     int nArgcNew;
-    int c;
+    int c, fNames = 1;
 
     Extra_UtilGetoptReset();
-    while ( ( c = Extra_UtilGetopt( argc, argv, "h" ) ) != EOF )
+    while ( ( c = Extra_UtilGetopt( argc, argv, "nh" ) ) != EOF )
     {
        switch(c)
        {
+          case 'n':
+             fNames ^= 1;
+             break;
           case 'h':
+          default:
              goto usage;
        }
     }
@@ -213,17 +239,87 @@ Abc_CommandWriteThreshold( Abc_Frame_t * pAbc,int argc, char ** argv )
        printf("[Error] current threshold gateList is empty!!\n");
        return 1;
     }
-    dumpTh2FileNZ( current_TList , FileName );
+    pNtk = Th_NtkFromList( current_TList );
+    if ( Th_FileIsThb( FileName ) )
+       Th_NtkWriteThb( pNtk , FileName , fNames );
+    else
+       Th_NtkWriteTh( pNtk , FileName );
+    Th_NtkFree( pNtk );
     return 0;
 
 usage:
-    Abc_Print( -2, "usage: write_th [-h] <file>\n" );
+    Abc_Print( -2, "usage: write_th [-nh] <file>\n" );
     Abc_Print( -2, "\t         dump function  for threshold gate '.th' files\n" );
+    Abc_Print( -2, "\t         (binary '.thb' format if the file name ends with .thb ,\n" );
+    Abc_Print( -2, "\t         compressed '.th' if it ends with .gz or .bz2)\n" );
+    Abc_Print( -2, "\t-n     : toggle writing PI/PO names into '.thb' files [default = %s]\n", fNames ? "yes" : "no" );
     Abc_Print( -2, "\t-h     : print the command usage\n");
     Abc_Print( -2, "\t<file> : the file name\n");
     return 1;
 }
 
+/**Function*************************************************************
+
+  Synopsis    [Threshold network format converter.]
+
+  Description [Converts between '.th' and '.thb' by the file extensions ,
+               without touching the current network.]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+int 
+Abc_CommandConvTh( Abc_Frame_t * pAbc, int argc, char ** argv )
+{
+    Vec_Ptr_t * tList;
+    Th_Ntk_t  * pNtk;
+    char ** pArgvNew;
+    int nArgcNew;
+    int c, fNames = 1;
+
+    Extra_UtilGetoptReset();
+    while ( ( c = Extra_UtilGetopt( argc, argv, "nh" ) ) != EOF )
+    {
+       switch(c)
+       {
+          case 'n':
+             fNames ^= 1;
+             break;
+          case 'h':
+          default:
+             goto usage;
+       }
+    }
+    pArgvNew = argv + globalUtilOptind;
+    nArgcNew = argc - globalUtilOptind;
+    if ( nArgcNew != 2 ) {
+       Abc_Print( -1, "Extra/missing files are given: expected %d, received %d!\n" , 2 , nArgcNew );
+       goto usage;
+    }
+    tList = func_readFileOAO( pArgvNew[0] );
+    if ( !tList ) return 1;
+    pNtk = Th_NtkFromList( tList );
+    DeleteTList( tList );
+    if ( Th_FileIsThb( pArgvNew[1] ) )
+       Th_NtkWriteThb( pNtk , pArgvNew[1] , fNames );
+    else
+       Th_NtkWriteTh( pNtk , pArgvNew[1] );
+    Th_NtkFree( pNtk );
+    return 0;
+
+usage:
+    Abc_Print( -2, "usage: conv_th [-nh] <in> <out>\n" );
+    Abc_Print( -2, "\t         converts a threshold network between '.th' and '.thb' by the file extensions\n" );
+    Abc_Print( -2, "\t-n     : toggle writing PI/PO names into '.thb' files [default = %s]\n", fNames ? "yes" : "no" );
+    Abc_Print( -2, "\t-h     : print the command usage\n");
+    Abc_Print( -2, "\t<in>   : the input file name\n");
+    Abc_Print( -2, "\t<out>  : the output file name\n");
+    return 1;
+}
+
 /**Function*************************************************************
 
   Synopsis    [Print statistics of a network.]
@@ -240,14 +336,19 @@ int
 Abc_CommandPrintThreshold( Abc_Frame_t * pAbc, int argc, char ** argv )
 {
     FILE * pErr;
+    Th_Ntk_t * pNtk;
     int c;
+    int fMemory = 0;
     pErr = Abc_FrameReadErr(pAbc);
 
     Extra_UtilGetoptReset();
-    while ( ( c = Extra_UtilGetopt( argc, argv, "h" ) ) != EOF )
+    while ( ( c = Extra_UtilGetopt( argc, argv, "mh" ) ) != EOF )
     {
        switch(c)
        {
+          case 'm':
+             fMemory ^= 1;
+             break;
           case 'h':
              goto usage;
        }
@@ -259,12 +360,20 @@ Abc_CommandPrintThreshold( Abc_Frame_t * pAbc, int argc, char ** argv )
         return 1;
     }
 
-    Th_PrintStat(current_TList);
+    pNtk = Th_NtkFromList( current_TList );
+    Th_NtkPrintStat( pNtk );
+    if ( fMemory ) {
+       printf( "----------------------------------------\n" );
+       printf( "\tMemory (list)    : %.2f MB\n" , Th_ListMemory( current_TList ) / (1<<20) );
+       printf( "\tMemory (compact) : %.2f MB\n" , Th_NtkMemory( pNtk ) / (1<<20) );
+    }
+    Th_NtkFree( pNtk );
     
 	 return 0;
 usage:
-    fprintf( pErr, "usage:    print_th [-h]\n" );
+    fprintf( pErr, "usage:    print_th [-mh]\n" );
     fprintf( pErr, "\t        print TH network statistics\n");
+    fprintf( pErr, "\t-m    : toggle printing memory usage [default = %s]\n", fMemory? "yes": "no" );
     fprintf( pErr, "\t-h    : print the command usage\n");
     return 1;
 }
@@ -360,14 +469,21 @@ Abc_CommandMerge( Abc_Frame_t * pAbc, int argc, char ** argv )
 {
     FILE * pErr;
 	 int fIterative;
-    int c, i, fOutBound, fTCAD;
+    int c, i, fOutBound, fTCAD, fWorklist, fPriority, fDP, nLevelBound, fCheck, fLocal;
+    Vec_Wrd_t * vSign = NULL, * vSignNew;
 	 abctime clk;
     pErr = Abc_FrameReadErr(pAbc);
 	 fIterative = 0;
 	 fOutBound  = -1;
     fTCAD      = 0;
+    fWorklist  = 0;
+    fPriority  = 0;
+    fDP        = 1;
+    nLevelBound = 0;
+    fCheck     = 0;
+    fLocal     = 0;
     Extra_UtilGetoptReset();
-    while ( ( c = Extra_UtilGetopt( argc, argv, "Bith" ) ) != EOF )
+    while ( ( c = Extra_UtilGetopt( argc, argv, "BLitwpdclh" ) ) != EOF )
     {
        switch ( c )
 		 {
@@ -379,6 +495,15 @@ Abc_CommandMerge( Abc_Frame_t * pAbc, int argc, char ** argv )
                fOutBound = atoi(argv[globalUtilOptind]);
                globalUtilOptind++;
                if ( fOutBound < 1 ) goto usage;
+               break;
+           case 'L':
+               if ( globalUtilOptind >= argc ) {
+                  Abc_Print( -1, "Command line switch \"-L\" should be followed by an integer.\n" );
+                  goto usage;
+               }
+               nLevelBound = atoi(argv[globalUtilOptind]);
+               globalUtilOptind++;
+               if ( nLevelBound < 0 ) goto usage;
                break;
 		    case 'i':
 			    fIterative ^= 1;
@@ -386,6 +511,21 @@ Abc_CommandMerge( Abc_Frame_t * pAbc, int argc, char ** argv )
 		    case 't':
 			    fTCAD ^= 1;
 			    break;
+		    case 'w':
+			    fWorklist ^= 1;
+			    break;
+		    case 'p':
+			    fPriority ^= 1;
+			    break;
+		    case 'd':
+			    fDP ^= 1;
+			    break;
+		    case 'c':
+			    fCheck ^= 1;
+			    break;
+		    case 'l':
+			    fLocal ^= 1;
+			    break;
 		    default:
              goto usage;
 		 }
@@ -394,31 +534,152 @@ Abc_CommandMerge( Abc_Frame_t * pAbc, int argc, char ** argv )
         fprintf( pErr, "\tEmpty threshold network.\n" );
         return 1;
 	 }
+	 // PIs and POs keep their order through collapsing
+	 if ( fCheck ) vSign = Th_SimSignature( current_TList, 64 );
+	 thKLDP = fDP;
+	 thClpCheck = fLocal;
+	 thProfiler.numClpCheck = thProfiler.numClpCheckTt = thProfiler.numClpCheckSat = 0;
+	 thProfiler.numClpCheckUndec = thProfiler.numClpCheckFail = 0;
+	 thProfiler.clkClpCheck = 0;
 	 clk = Abc_Clock();
+	 if ( nLevelBound ) Th_NtkLevelForward( current_TList );
 	 if ( fOutBound == -1 ) {
-       fTCAD ? Th_CollapseNtk_tcad( current_TList , fIterative , fOutBound ):
-               Th_CollapseNtk( current_TList , fIterative , fOutBound );
+       if ( fWorklist )
+          Th_CollapseNtkWorklist( current_TList , fOutBound , nLevelBound , fTCAD );
+       else
+          fTCAD ? Th_CollapseNtk_tcad( current_TList , fIterative , fOutBound , nLevelBound ):
+                  Th_CollapseNtk( current_TList , fIterative , fOutBound , nLevelBound );
     }
+	 else if ( fPriority && !fIterative && !fTCAD && !fWorklist )
+       Th_CollapseNtkPriority( current_TList , fOutBound , nLevelBound );
 	 else {
 	    for ( i = 1 ; i <= fOutBound ; ++i ) {
-          fTCAD ? Th_CollapseNtk_tcad( current_TList , fIterative , i ):
-                  Th_CollapseNtk( current_TList , fIterative , i );
+          if ( fWorklist )
+             Th_CollapseNtkWorklist( current_TList , i , nLevelBound , fTCAD );
+          else
+             fTCAD ? Th_CollapseNtk_tcad( current_TList , fIterative , i , nLevelBound ):
+                     Th_CollapseNtk( current_TList , fIterative , i , nLevelBound );
        }
 	 }
+	 thClpCheck = 0;
     // sort current_TList and clean up NULL objects
     Th_NtkDfs();
 	 Abc_PrintTime( 1 , "collapse time : " , Abc_Clock()-clk );
+	 if ( fLocal ) {
+       printf( "\tLocal checks : %d steps ( %d by truth tables , %d by SAT ) , %d undecided , %d FAILED.  ",
+          thProfiler.numClpCheck, thProfiler.numClpCheckTt, thProfiler.numClpCheckSat,
+          thProfiler.numClpCheckUndec, thProfiler.numClpCheckFail );
+       Abc_PrintTime( 1 , "Time" , thProfiler.clkClpCheck );
+    }
+	 if ( fCheck ) {
+       vSignNew = Th_SimSignature( current_TList, 64 );
+       if ( Vec_WrdEqual( vSign, vSignNew ) )
+          printf( "\tCollapse self-check passed on %d random patterns.\n", 64 * 64 );
+       else
+          printf( "\tCollapse self-check FAILED : the collapsed network differs on random patterns.\n" );
+       Vec_WrdFree( vSignNew );
+       Vec_WrdFree( vSign );
+    }
 	 return 0;
 usage:
-    fprintf( pErr, "usage:    merge_th [-B <num>] [-ih]\n" );
+    fprintf( pErr, "usage:    merge_th [-B <num>] [-L <num>] [-itwpdclh]\n" );
     fprintf( pErr, "\t        merging process for TList.\n");
     fprintf( pErr, "\t-B num   : collapse from single fanout to num fanout [default=%d]\n", fOutBound);
+    fprintf( pErr, "\t-L num   : collapse only nodes at level <= num from PIs (0 = no bound) [default=%d]\n", nLevelBound);
     fprintf( pErr, "\t-i       : toggle iterative collapse [default=%d]\n", fIterative);
     fprintf( pErr, "\t-t       : collapse to fanouts (suggested by TCAD reviewer) [default=%d]\n", fTCAD);
+    fprintf( pErr, "\t-w       : toggle worklist-driven collapse (revisit changed nodes only) [default=%d]\n", fWorklist);
+    fprintf( pErr, "\t-p       : toggle single-pass fanout-ordered collapse for -B (else one pass per bound) [default=%d]\n", fPriority);
+    fprintf( pErr, "\t           (with -i/-t/-w the passes per bound are used)\n");
+    fprintf( pErr, "\t-d       : toggle computing K/L by exact iff conditions (else if conditions) [default=%d]\n", fDP);
+    fprintf( pErr, "\t-c       : toggle checking the result against the input by random simulation [default=%d]\n", fCheck);
+    fprintf( pErr, "\t-l       : toggle checking every collapse step on its local support [default=%d]\n", fLocal);
     fprintf( pErr, "\t-h       : print the command usage\n");
 	 return 1;
 }
 
+/**Function*************************************************************
+
+  Synopsis    [Merge functionally equivalent gates.]
+
+  Description []
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+int 
+Abc_CommandFraigTh( Abc_Frame_t * pAbc, int argc, char ** argv )
+{
+    FILE * pErr;
+    int c, nWords, nConfLimit, nEncoding, fVerbose, nGates;
+    pErr       = Abc_FrameReadErr(pAbc);
+    nWords     = 16;
+    nConfLimit = 1000;
+    nEncoding  = TH_CNF_ENC_PB;
+    fVerbose   = 0;
+    Extra_UtilGetoptReset();
+    while ( ( c = Extra_UtilGetopt( argc, argv, "WCEvh" ) ) != EOF )
+    {
+       switch ( c )
+       {
+           case 'W':
+               if ( globalUtilOptind >= argc ) {
+                  Abc_Print( -1, "Command line switch \"-W\" should be followed by an integer.\n" );
+                  goto usage;
+               }
+               nWords = atoi(argv[globalUtilOptind]);
+               globalUtilOptind++;
+               if ( nWords < 1 ) goto usage;
+               break;
+           case 'C':
+               if ( globalUtilOptind >= argc ) {
+                  Abc_Print( -1, "Command line switch \"-C\" should be followed by an integer.\n" );
+                  goto usage;
+               }
+               nConfLimit = atoi(argv[globalUtilOptind]);
+               globalUtilOptind++;
+               if ( nConfLimit < 0 ) goto usage;
+               break;
+           case 'E':
+               if ( globalUtilOptind >= argc ) {
+                  Abc_Print( -1, "Command line switch \"-E\" should be followed by an integer.\n" );
+                  goto usage;
+               }
+               nEncoding = atoi(argv[globalUtilOptind]);
+               globalUtilOptind++;
+               if ( nEncoding < 0 || nEncoding >= TH_CNF_ENC_NUM ) goto usage;
+               break;
+           case 'v':
+               fVerbose ^= 1;
+               break;
+           default:
+               goto usage;
+       }
+    }
+    if ( current_TList == NULL ) {
+        fprintf( pErr, "\tEmpty threshold network.\n" );
+        return 1;
+    }
+    nGates = Th_CountGate( current_TList, Th_Node );
+    Th_NtkFraig( current_TList, nWords, nConfLimit, nEncoding, fVerbose );
+    // sort current_TList and clean up NULL objects
+    Th_NtkDfs();
+    printf( "\tGates : %d -> %d\n", nGates, Th_CountGate( current_TList, Th_Node ) );
+    return 0;
+usage:
+    fprintf( pErr, "usage:    fraig_th [-WCE <num>] [-vh]\n" );
+    fprintf( pErr, "\t        merges functionally equivalent gates of the TList\n");
+    fprintf( pErr, "\t-W num   : the number of 64-pattern words of random simulation [default=%d]\n", nWords);
+    fprintf( pErr, "\t-C num   : the conflict limit of each SAT call (0 = no limit) [default=%d]\n", nConfLimit);
+    fprintf( pErr, "\t-E num   : gate encoding (0: auto; 1: bdd; 2: counter; 3: totalizer; 4: adder; 5: PB) [default=%d]\n", nEncoding);
+    fprintf( pErr, "\t-v       : toggle printing SAT statistics [default=%d]\n", fVerbose);
+    fprintf( pErr, "\t-h       : print the command usage\n");
+    return 1;
+}
+
 /**Function*************************************************************
 
   Synopsis    [Write out threshold network as blif file.]
@@ -472,7 +733,7 @@ Abc_CommandTh2Blif( Abc_Frame_t * pAbc, int argc, char ** argv )
 usage:
     fprintf( pErr, "usage:    th2blif [-h] <file>\n" );
     fprintf( pErr, "\t        write out threshold network as blif file\n");
-    fprintf( pErr, "\tfile  : output file name\n");
+    fprintf( pErr, "\tfile  : output file name , compressed if it ends with .gz or .bz2\n");
     fprintf( pErr, "\t-h    : print the command usage\n");
     return 1;
 }
@@ -623,6 +884,7 @@ int Abc_CommandPB_Threshold( Abc_Frame_t * pAbc, int argc, char ** argv )
 usage:
     fprintf( pErr, "usage:  PB_th [-h] <fileName> \n" );
     fprintf( pErr, "\t       given strashNtk and thresholdNtk, print out Pseudo Boolean constraints for minisat+ to solve EC.\n");
+    fprintf( pErr, "\t       The file is compressed if its name ends with .gz or .bz2.\n");
     fprintf( pErr, "\t-h    : print the command usage\n");
     return 1;
 }
@@ -652,28 +914,65 @@ Abc_CommandCNF_Threshold( Abc_Frame_t * pAbc, int argc, char ** argv )
     int fRecord        = 1;
     int fCleanup       = 0;
 	 int fRemoveLatches = 0;
+    int nEncoding      = TH_CNF_ENC_AUTO;
+    int fSolve         = 1;
+    int nConfLimit     = 0;
+    int nTimeLimit     = 0;
 	 abctime clk;
     pNtk = Abc_FrameReadNtk(pAbc);
     pOut = Abc_FrameReadOut(pAbc);
     pErr = Abc_FrameReadErr(pAbc);
     Extra_UtilGetoptReset();
-    while ( ( c = Extra_UtilGetopt( argc, argv, "h" ) ) != EOF )
+    while ( ( c = Extra_UtilGetopt( argc, argv, "ECTsh" ) ) != EOF )
     {
        switch(c)
        {
+          case 'E':
+             if ( globalUtilOptind >= argc ) {
+                Abc_Print( -1, "Command line switch \"-E\" should be followed by an integer.\n" );
+                goto usage;
+             }
+             nEncoding = atoi(argv[globalUtilOptind]);
+             globalUtilOptind++;
+             if ( nEncoding < 0 || nEncoding >= TH_CNF_ENC_PB ) goto usage;
+             break;
+          case 'C':
+             if ( globalUtilOptind >= argc ) {
+                Abc_Print( -1, "Command line switch \"-C\" should be followed by an integer.\n" );
+                goto usage;
+             }
+             nConfLimit = atoi(argv[globalUtilOptind]);
+             globalUtilOptind++;
+             if ( nConfLimit < 0 ) goto usage;
+             break;
+          case 'T':
+             if ( globalUtilOptind >= argc ) {
+                Abc_Print( -1, "Command line switch \"-T\" should be followed by an integer.\n" );
+                goto usage;
+             }
+             nTimeLimit = atoi(argv[globalUtilOptind]);
+             globalUtilOptind++;
+             if ( nTimeLimit < 0 ) goto usage;
+             break;
+          case 's':
+             fSolve ^= 1;
+             break;
           case 'h':
+          default:
              goto usage;
        }
     }
     pArgvNew = argv + globalUtilOptind;
     nArgcNew = argc - globalUtilOptind;
-    if ( nArgcNew != 1 )
+    if ( nArgcNew > 1 )
+        goto usage;
+    if ( nArgcNew == 0 && !fSolve )
     {
         Abc_Print( -1, "There is no file name.\n" );
         return 1;
     }
-    // get the input file name
-    FileName = pArgvNew[0];
+    // get the output file name, if any
+    FileName = nArgcNew ? pArgvNew[0] : NULL;
     if ( pNtk == NULL ) {
         fprintf( pErr, "Empty network.\n" );
         return 1;
@@ -700,12 +999,17 @@ Abc_CommandCNF_Threshold( Abc_Frame_t * pAbc, int argc, char ** argv )
         return 1;
     }
 	 clk = Abc_Clock();
-    func_EC_writeCNF(pNtk, current_TList, FileName);
+    func_EC_writeCNF(pNtk, current_TList, FileName, nEncoding, fSolve, nConfLimit, nTimeLimit);
 	 Abc_PrintTime( 1 , "ec gen time : " , Abc_Clock()-clk );
     return 0;
 usage:
-    fprintf( pErr, "usage:  CNF_th [-h] <fileName>\n" );
-    fprintf( pErr, "\t       given strashNtk and thresholdNtk, print out CNF for minisat to solve EC.\n");
+    fprintf( pErr, "usage:  CNF_th [-E <num>] [-C <num>] [-T <num>] [-sh] [<fileName>]\n" );
+    fprintf( pErr, "\t       given strashNtk and thresholdNtk, check EC with the built-in SAT solver\n");
+    fprintf( pErr, "\t       and/or print out CNF to <fileName> for minisat ( compressed if it ends with .gz or .bz2 ).\n");
+    fprintf( pErr, "\t-E num : gate encoding (0: auto; 1: bdd; 2: counter; 3: totalizer; 4: adder) [default=%d]\n", nEncoding);
+    fprintf( pErr, "\t-C num : conflict limit of the SAT solver (0 = no limit) [default=%d]\n", nConfLimit);
+    fprintf( pErr, "\t-T num : time limit of the SAT solver in seconds (0 = no limit) [default=%d]\n", nTimeLimit);
+    fprintf( pErr, "\t-s     : toggle solving with the built-in SAT solver [default=%s]\n", fSolve ? "yes" : "no");
     fprintf( pErr, "\t-h    : print the command usage\n");
     return 1;
 }
@@ -725,11 +1029,22 @@ usage:
 int 
 Abc_CommandThVerify( Abc_Frame_t * pAbc, int argc, char ** argv )
 {
-   char ** pArgvNew;
-   int nArgcNew, fVer, c;
+   char ** pArgvNew, * pPatFile;
+   Vec_Ptr_t * vSimCexes;
+   int nArgcNew, fVer, nEncoding, fWrite, fSolve, fGzip, nConfLimit, nTimeLimit, nProcs, nSimWords, fVerbose, nDiff, c;
    fVer = 0;
+   nEncoding = TH_CNF_ENC_AUTO;
+   fWrite = 0;
+   fSolve = 1;
+   fGzip = 0;
+   nConfLimit = 0;
+   nTimeLimit = 0;
+   nProcs = 0;
+   nSimWords = 64;
+   pPatFile = NULL;
+   fVerbose = 0;
    Extra_UtilGetoptReset();
-   while ( ( c = Extra_UtilGetopt( argc , argv , "Vh" ) ) != EOF )
+   while ( ( c = Extra_UtilGetopt( argc , argv , "VECTPRSwszvh" ) ) != EOF )
    {
        switch ( c )
        {
@@ -742,6 +1057,71 @@ Abc_CommandThVerify( Abc_Frame_t * pAbc, int argc, char ** argv )
           globalUtilOptind++;
           if ( fVer < 0 || fVer > 2 ) goto usage;
           break;
+       case 'E':
+          if ( globalUtilOptind >= argc ) {
+              Abc_Print( -1 , "Command line switch \"-E\" should be followed by an integer.\n" );
+              goto usage;
+          }
+          nEncoding = atoi( argv[globalUtilOptind] );
+          globalUtilOptind++;
+          if ( nEncoding < 0 || nEncoding >= TH_CNF_ENC_PB ) goto usage;
+          break;
+       case 'C':
+          if ( globalUtilOptind >= argc ) {
+              Abc_Print( -1 , "Command line switch \"-C\" should be followed by an integer.\n" );
+              goto usage;
+          }
+          nConfLimit = atoi( argv[globalUtilOptind] );
+          globalUtilOptind++;
+          if ( nConfLimit < 0 ) goto usage;
+          break;
+       case 'T':
+          if ( globalUtilOptind >= argc ) {
+              Abc_Print( -1 , "Command line switch \"-T\" should be followed by an integer.\n" );
+              goto usage;
+          }
+          nTimeLimit = atoi( argv[globalUtilOptind] );
+          globalUtilOptind++;
+          if ( nTimeLimit < 0 ) goto usage;
+          break;
+       case 'P':
+          if ( globalUtilOptind >= argc ) {
+              Abc_Print( -1 , "Command line switch \"-P\" should be followed by an integer.\n" );
+              goto usage;
+          }
+          nProcs = atoi( argv[globalUtilOptind] );
+          globalUtilOptind++;
+          if ( nProcs < 0 ) goto usage;
+          break;
+       case 'R':
+          if ( globalUtilOptind >= argc ) {
+              Abc_Print( -1 , "Command line switch \"-R\" should be followed by an integer.\n" );
+              goto usage;
+          }
+          nSimWords = atoi( argv[globalUtilOptind] );
+          globalUtilOptind++;
+          if ( nSimWords < 0 ) goto usage;
+          break;
+       case 'S':
+          if ( globalUtilOptind >= argc ) {
+              Abc_Print( -1 , "Command line switch \"-S\" should be followed by a file name.\n" );
+              goto usage;
+          }
+          pPatFile = argv[globalUtilOptind];
+          globalUtilOptind++;
+          break;
+       case 'w':
+          fWrite ^= 1;
+          break;
+       case 's':
+          fSolve ^= 1;
+          break;
+       case 'z':
+          fGzip ^= 1;
+          break;
+       case 'v':
+          fVerbose ^= 1;
+          break;
        case 'h':
        default:
            goto usage;
@@ -753,6 +1133,10 @@ Abc_CommandThVerify( Abc_Frame_t * pAbc, int argc, char ** argv )
       Abc_Print( -1, "Extra/missing files are given: expected %d, received %d!\n" , 2 , nArgcNew );
       goto usage;
    }
+   if ( !fSolve && !fWrite ) {
+      Abc_Print( -1, "Solving is off (-s) and no formula is written (-w).\n" );
+      goto usage;
+   }
    if ( current_TList ) {
       Abc_Print( 0, "Original current_TList destroyed.\n" );
 	   DeleteTList( current_TList ); 
@@ -767,14 +1151,48 @@ Abc_CommandThVerify( Abc_Frame_t * pAbc, int argc, char ** argv )
    }
    cut_TList = func_readFileOAO( pArgvNew[1] );
    if ( !cut_TList ) { DeleteTList(current_TList); goto usage; }
-   if ( fVer == 0 ) func_EC_compareTH( current_TList, cut_TList );
-   else if ( fVer == 1 ) func_CNF_compareTH( current_TList, cut_TList );
-   else assert(0);
+   // simulation rules out most differing pairs before any formula is built ;
+   // with -s the formula is only written , as by OAO and NZ
+   vSimCexes = Vec_PtrAlloc( 100 );
+   nDiff = 0;
+   if ( fSolve && (nSimWords > 0 || pPatFile) )
+      nDiff = Th_SimCompare( current_TList, cut_TList, pPatFile, nSimWords, vSimCexes );
+   if ( nDiff < 0 ) {
+      Vec_PtrFree( vSimCexes );
+      return 1;
+   }
+   if ( fSolve && nProcs > 0 )
+      Th_SplitCompare( current_TList, cut_TList, nDiff ? vSimCexes : NULL, fVer == 0 ? TH_CNF_ENC_PB : nEncoding, nProcs, nConfLimit, nTimeLimit, fVerbose );
+   else if ( nDiff > 0 && !fWrite )
+      Th_SimPrintCex( current_TList, vSimCexes );
+   else {
+      // a pair refuted by simulation is not solved , but -w still writes its formula
+      if ( nDiff > 0 ) {
+         Th_SimPrintCex( current_TList, vSimCexes );
+         fSolve = 0;
+      }
+      if ( fVer == 0 ) func_EC_compareTH( current_TList, cut_TList, fWrite ? (fGzip ? "compTH.opb.gz" : "compTH.opb") : NULL, fSolve, nConfLimit, nTimeLimit );
+      else if ( fVer == 1 ) func_CNF_compareTH( current_TList, cut_TList, fWrite ? (fGzip ? "compTH.dimacs.gz" : "compTH.dimacs") : NULL, nEncoding, fSolve, nConfLimit, nTimeLimit );
+      else assert(0);
+   }
+   Vec_PtrFreeFree( vSimCexes );
    return 0;
 usage:
-    Abc_Print( -2, "usage:  thverify [-V <num>] [-h] <file1> <file2>\n" );
-    Abc_Print( -2, "\t          eq check between file1 and file2 via PB/CNF (output file name: compTH.opb/dimacs)\n");
+    Abc_Print( -2, "usage:  thverify [-V <num>] [-E <num>] [-C <num>] [-T <num>] [-P <num>] [-R <num>] [-S <file>] [-wszvh] <file1> <file2>\n" );
+    Abc_Print( -2, "\t          eq check between file1 and file2 with the built-in SAT solver , the gates\n");
+    Abc_Print( -2, "\t          given as native PB constraints or as CNF\n");
     Abc_Print( -2, "\t-V <num> :toggling verification methods (0: PB; 1: CNF), default = %d\n", fVer );
+    Abc_Print( -2, "\t-E <num> :CNF gate encoding (0: auto; 1: bdd; 2: counter; 3: totalizer; 4: adder), default = %d\n", nEncoding );
+    Abc_Print( -2, "\t-C <num> :conflict limit of the SAT solver (0 = no limit), default = %d\n", nConfLimit );
+    Abc_Print( -2, "\t-T <num> :time limit of the SAT solver in seconds (0 = no limit), default = %d\n", nTimeLimit );
+    Abc_Print( -2, "\t-P <num> :check the outputs one by one with this many processes ( 0 = one miter ;\n");
+    Abc_Print( -2, "\t          -C and -T then apply to each output ), default = %d\n", nProcs );
+    Abc_Print( -2, "\t-R <num> :words of 64 random patterns simulated first ( 0 = none ), default = %d\n", nSimWords );
+    Abc_Print( -2, "\t-S <file>:input patterns simulated first , a line of 0/1 per pattern\n");
+    Abc_Print( -2, "\t-w       :toggle writing the formula to compTH.opb/dimacs ( one miter only ), default = %s\n", fWrite ? "yes" : "no" );
+    Abc_Print( -2, "\t-s       :toggle solving with the built-in SAT solver ( off : -w only writes the formula ), default = %s\n", fSolve ? "yes" : "no" );
+    Abc_Print( -2, "\t-z       :toggle compressing the formula written by -w into a .gz file, default = %s\n", fGzip ? "yes" : "no" );
+    Abc_Print( -2, "\t-v       :toggle printing every output of the per-output check, default = %s\n", fVerbose ? "yes" : "no" );
     Abc_Print( -2, "\t<file1>  :the first TH file to be verified\n");
     Abc_Print( -2, "\t<file2>  :the second TH file to be verified\n");
     Abc_Print( -2, "\t-h       :print the command usage\n");
@@ -814,17 +1232,20 @@ Abc_CommandThPGEncode( Abc_Frame_t * pAbc, int argc, char ** argv )
    }
    pArgvNew = argv + globalUtilOptind;
    nArgcNew = argc - globalUtilOptind;
+   if ( nArgcNew > 1 )
+      goto usage;
    if ( !current_TList ) {
       Abc_Print(-1, "current_TList is empty!\n");
       goto usage;
    }
-   Th_PBPGEncoding(current_TList, fPG);
+   Th_PBPGEncoding(current_TList, fPG, nArgcNew ? pArgvNew[0] : NULL);
    return 0;
 usage:
-    Abc_Print( -2, "usage:  thpg [-ph]\n" );
+    Abc_Print( -2, "usage:  thpg [-ph] [<file>]\n" );
     Abc_Print( -2, "\t          generate a PB formula with/without PG encoding (output file name: pg.opb/no_pg.opb)\n");
     Abc_Print( -2, "\t-p       :toggling using PG encoding [default = %s]\n" , fPG ? "yes" : "no" );
     Abc_Print( -2, "\t-h       :print the command usage\n");
+    Abc_Print( -2, "\t<file>   :the output file name , compressed if it ends with .gz or .bz2\n");
     return 1;
 }
 
@@ -863,7 +1284,7 @@ Abc_CommandNZ( Abc_Frame_t * pAbc, int argc, char ** argv )
         goto usage;
     }
     clk = Abc_Clock();
-    func_EC_compareTH( current_TList, cut_TList );
+    func_EC_compareTH( current_TList, cut_TList, "compTH.opb", 0, 0, 0 );
     Abc_PrintTime( 1 , "PB translation time : " , Abc_Clock() - clk );
     return 0;
 usage:
@@ -896,7 +1317,7 @@ Abc_CommandOAO( Abc_Frame_t * pAbc, int argc, char ** argv )
         goto usage;
     }
     clk = Abc_Clock();
-    func_CNF_compareTH( current_TList, cut_TList );
+    func_CNF_compareTH( current_TList, cut_TList, "compTH.dimacs", TH_CNF_ENC_AUTO, 0, 0, 0 );
     Abc_PrintTime( 1 , "CNF translation time : " , Abc_Clock() - clk );
     return 0;
 usage:
@@ -945,6 +1366,87 @@ Abc_CommandProfileTh( Abc_Frame_t * pAbc, int argc, char ** argv )
 	return 0;
 }
 
+/**Function*************************************************************
+
+  Synopsis    [Measure the simulation speed of the current network.]
+
+  Description []
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+int 
+Abc_CommandSimTh( Abc_Frame_t * pAbc, int argc, char ** argv )
+{
+    FILE * pErr;
+    int c, nWords, nRounds, nKernel;
+    pErr    = Abc_FrameReadErr(pAbc);
+    nWords  = 256;
+    nRounds = 10;
+    nKernel = TH_SIM_AUTO;
+    Extra_UtilGetoptReset();
+    while ( ( c = Extra_UtilGetopt( argc, argv, "WNKh" ) ) != EOF )
+    {
+       switch ( c )
+       {
+           case 'W':
+               if ( globalUtilOptind >= argc ) {
+                  Abc_Print( -1, "Command line switch \"-W\" should be followed by an integer.\n" );
+                  goto usage;
+               }
+               nWords = atoi(argv[globalUtilOptind]);
+               globalUtilOptind++;
+               if ( nWords < 1 ) goto usage;
+               break;
+           case 'N':
+               if ( globalUtilOptind >= argc ) {
+                  Abc_Print( -1, "Command line switch \"-N\" should be followed by an integer.\n" );
+                  goto usage;
+               }
+               nRounds = atoi(argv[globalUtilOptind]);
+               globalUtilOptind++;
+               if ( nRounds < 1 ) goto usage;
+               break;
+           case 'K':
+               if ( globalUtilOptind >= argc ) {
+                  Abc_Print( -1, "Command line switch \"-K\" should be followed by an integer.\n" );
+                  goto usage;
+               }
+               nKernel = atoi(argv[globalUtilOptind]);
+               globalUtilOptind++;
+               if ( nKernel < 0 || nKernel >= TH_SIM_NUM ) goto usage;
+               if ( !Th_SimKernelAvail(nKernel) ) {
+                  Abc_Print( -1, "Kernel \"%s\" is not compiled into this build.\n", Th_SimKernelName(nKernel) );
+                  return 1;
+               }
+               break;
+           default:
+               goto usage;
+       }
+    }
+    if ( current_TList == NULL ) {
+        fprintf( pErr, "\tEmpty threshold network.\n" );
+        return 1;
+    }
+    Th_SimBench( current_TList, nWords, nRounds, nKernel );
+    return 0;
+usage:
+    fprintf( pErr, "usage:    sim_th [-WNK <num>] [-h]\n" );
+    fprintf( pErr, "\t        measures bit-parallel simulation of the current TList\n");
+    fprintf( pErr, "\t-W num   : the number of 64-pattern words [default=%d]\n", nWords);
+    fprintf( pErr, "\t-N num   : the number of simulation rounds [default=%d]\n", nRounds);
+    fprintf( pErr, "\t-K num   : the gate kernel (0=all available, 1=word, 2=sse2, 3=avx2) [default=%d]\n", nKernel);
+    fprintf( pErr, "\t           compiled in :");
+    for ( c = TH_SIM_WORD; c < TH_SIM_NUM; c++ )
+       if ( Th_SimKernelAvail(c) ) fprintf( pErr, " %s", Th_SimKernelName(c) );
+    fprintf( pErr, "\n");
+    fprintf( pErr, "\t-h       : print the command usage\n");
+    return 1;
+}
+
 ////////////////////////////////////////////////////////////////////////
 ///                       END OF FILE                                ///
 ////////////////////////////////////////////////////////////////////////
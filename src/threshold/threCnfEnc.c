@@ -0,0 +1,867 @@
+/**CFile****************************************************************
+
+  FileName    [threCnfEnc.c]
+
+  SystemName  [ABC: Logic synthesis and verification system.]
+
+  PackageName [threshold.]
+
+  Synopsis    [CNF encodings of threshold gates.]
+
+  Author      [ALCom Lab]
+
+  Affiliation [NTU]
+
+  Date        [Oct 16, 2026.]
+
+  Revision    [$Id: abc.c,v 1.00 2005/06/20 00:00:00 alanmi Exp $]
+
+***********************************************************************/
+
+////////////////////////////////////////////////////////////////////////
+///                          INCLUDES                                ///
+////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include "base/abc/abc.h"
+#include "threshold.h"
+#include "sat/bsat/satSolver.h"
+
+////////////////////////////////////////////////////////////////////////
+///                        DECLARATIONS                              ///
+////////////////////////////////////////////////////////////////////////
+
+// a gate y <-> ( sum w_i x_i >= T ) is first normalized to positive
+// weights over literals ( w x = w + |w| !x for w < 0 ) , then written
+// with one of the encodings below ; literals are signed DIMACS numbers
+// and the two constants are TH_CNF_TRUE / TH_CNF_FALSE = -TH_CNF_TRUE
+#define TH_CNF_TRUE    ( ABC_INFINITY )
+#define TH_CNF_FALSE   ( -ABC_INFINITY )
+
+struct Th_CnfMan_t_
+{
+    Th_Out_t  * pFile;     // output file or NULL
+    sat_solver* pSat;      // in-process solver or NULL
+    int         fUnsat;    // the clauses added to pSat are already conflicting
+    int         Encoding;  // Th_CnfEnc_t
+    int         nVars;     // the last variable in use
+    int         nClauses;  // clauses written so far
+    int         nGates[TH_CNF_ENC_NUM]; // gates written by each encoding
+    Vec_Int_t * vClause;   // clause being written
+    // normalized gate
+    Vec_Int_t * vWeights;  // positive weights , in decreasing order
+    Vec_Int_t * vLits;     // literals of these weights
+    Vec_Int_t * vSuffix;   // vSuffix[i] : sum of the weights from i on
+    Vec_Int_t * vVarPos;   // per variable : 1 + its position in vLits during normalization , else 0
+    // shared cofactors
+    int         nNodeLimit;// node limit of the cofactor build ( 0 = none )
+    Vec_Ptr_t * vMemo;     // per level : (lo, hi, node) of the nodes built
+    Vec_Int_t * vNodes;    // (lvl, hi, lo) of internal node 2+k ; 0/1 : const0/const1
+    Vec_Int_t * vNodeVars; // variable of internal node 2+k or 0 if it is not shared
+    Vec_Int_t * vCube;     // literals of the path being written
+    // counters , totalizers and adders
+    Vec_Int_t * vPrev;     // literals of the previous counter row
+    Vec_Int_t * vCur;      // literals of the current counter row
+    Vec_Ptr_t * vBuckets;  // per bit : literals to add up
+};
+
+static char * Th_CnfEncNames[TH_CNF_ENC_NUM] = { "auto", "bdd", "counter", "totalizer", "adder", "pb" };
+
+////////////////////////////////////////////////////////////////////////
+///                     FUNCTION DEFINITIONS                         ///
+////////////////////////////////////////////////////////////////////////
+
+/**Function*************************************************************
+
+  Synopsis    [Manager of the CNF encoders.]
+
+  Description [Variables up to nVars are taken by the caller ; the
+               encoders number their auxiliary variables after them.
+               The clauses go to pFile if it is given and to an
+               in-process sat_solver if fSolve is set.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+Th_CnfMan_t * Th_CnfManStart( Th_Out_t * pFile, int nVars, int Encoding, int fSolve )
+{
+    Th_CnfMan_t * p = ABC_CALLOC( Th_CnfMan_t, 1 );
+    assert( Encoding >= 0 && Encoding < TH_CNF_ENC_NUM );
+    // PB constraints have no DIMACS form
+    assert( Encoding != TH_CNF_ENC_PB || (fSolve && pFile == NULL) );
+    p->pFile     = pFile;
+    p->pSat      = fSolve ? sat_solver_new() : NULL;
+    if ( p->pSat ) sat_solver_setnvars( p->pSat, nVars + 1 );
+    p->Encoding  = Encoding;
+    p->nVars     = nVars;
+    p->vClause   = Vec_IntAlloc( 16 );
+    p->vWeights  = Vec_IntAlloc( 16 );
+    p->vLits     = Vec_IntAlloc( 16 );
+    p->vSuffix   = Vec_IntAlloc( 16 );
+    p->vVarPos   = Vec_IntStart( nVars + 1 );
+    p->vMemo     = Vec_PtrAlloc( 16 );
+    p->vNodes    = Vec_IntAlloc( 48 );
+    p->vNodeVars = Vec_IntAlloc( 16 );
+    p->vCube     = Vec_IntAlloc( 16 );
+    p->vPrev     = Vec_IntAlloc( 16 );
+    p->vCur      = Vec_IntAlloc( 16 );
+    p->vBuckets  = Vec_PtrAlloc( 16 );
+    return p;
+}
+
+void Th_CnfManStop( Th_CnfMan_t * p )
+{
+    if ( p->pSat ) sat_solver_delete( p->pSat );
+    Vec_IntFree( p->vClause );
+    Vec_IntFree( p->vWeights );
+    Vec_IntFree( p->vLits );
+    Vec_IntFree( p->vSuffix );
+    Vec_IntFree( p->vVarPos );
+    Vec_VecFree( (Vec_Vec_t *)p->vMemo );
+    Vec_IntFree( p->vNodes );
+    Vec_IntFree( p->vNodeVars );
+    Vec_IntFree( p->vCube );
+    Vec_IntFree( p->vPrev );
+    Vec_IntFree( p->vCur );
+    Vec_VecFree( (Vec_Vec_t *)p->vBuckets );
+    ABC_FREE( p );
+}
+
+int Th_CnfManVarNum( Th_CnfMan_t * p )    { return p->nVars;    }
+int Th_CnfManVarValue( Th_CnfMan_t * p, int Var ) { return sat_solver_var_value( p->pSat, Var ); }
+int Th_CnfManClauseNum( Th_CnfMan_t * p ) { return p->nClauses; }
+int Th_CnfManConflictNum( Th_CnfMan_t * p ) { return p->pSat ? sat_solver_nconflicts( p->pSat ) : 0; }
+
+void Th_CnfManPrintStats( Th_CnfMan_t * p )
+{
+    int i;
+    printf( "\tCNF      : %d vars , %d clauses ;", p->nVars, p->nClauses );
+    for ( i = 1; i < TH_CNF_ENC_NUM; ++i )
+        printf( " %s %d", Th_CnfEncNames[i], p->nGates[i] );
+    printf( "\n" );
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Solves the clauses loaded into the solver.]
+
+  Description [Returns 1 if satisfiable , 0 if unsatisfiable and -1 if
+               the conflict limit or the time limit ( in seconds , 0 for
+               none ) is reached first.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+int Th_CnfManSolve( Th_CnfMan_t * p, int nConfLimit, int nTimeLimit )
+{
+    int RetValue;
+    assert( p->pSat );
+    if ( p->fUnsat )
+        return 0;
+    if ( nTimeLimit )
+        sat_solver_set_runtime_limit( p->pSat, Abc_Clock() + (abctime)nTimeLimit * CLOCKS_PER_SEC );
+    RetValue = sat_solver_solve( p->pSat, NULL, NULL, (ABC_INT64_T)nConfLimit, 0, 0, 0 );
+    if ( RetValue == l_True )  return 1;
+    if ( RetValue == l_False ) return 0;
+    return -1;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Solves under assumptions.]
+
+  Description [pLits are DIMACS literals over the named variables ; the
+               clauses stay loaded , so the manager can be queried again
+               and extended between the calls. Returns as
+               Th_CnfManSolve().]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+int Th_CnfManSolveAssume( Th_CnfMan_t * p, int * pLits, int nLits, int nConfLimit )
+{
+    int i, RetValue;
+    assert( p->pSat );
+    if ( p->fUnsat )
+        return 0;
+    Vec_IntClear( p->vClause );
+    for ( i = 0; i < nLits; i++ )
+        Vec_IntPush( p->vClause, Abc_Var2Lit( Abc_AbsInt(pLits[i]), pLits[i] < 0 ) );
+    RetValue = sat_solver_solve( p->pSat, Vec_IntArray(p->vClause), Vec_IntLimit(p->vClause), (ABC_INT64_T)nConfLimit, 0, 0, 0 );
+    if ( RetValue == l_True )  return 1;
+    if ( RetValue == l_False ) return 0;
+    return -1;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Clauses and gates with constant propagation.]
+
+  Description []
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+static inline int Th_CnfNewVar( Th_CnfMan_t * p ) { return ++p->nVars; }
+
+// writes the clause of the literals in p->vClause ; constants are dropped
+static void Th_CnfWriteClause( Th_CnfMan_t * p )
+{
+    int k, j, Lit;
+    Vec_IntForEachEntry( p->vClause, Lit, k )
+        if ( Lit == TH_CNF_TRUE ) return;
+    for ( k = j = 0; k < Vec_IntSize(p->vClause); ++k )
+        if ( (Lit = Vec_IntEntry(p->vClause, k)) != TH_CNF_FALSE )
+            Vec_IntWriteEntry( p->vClause, j++, Lit );
+    Vec_IntShrink( p->vClause, j );
+    p->nClauses++;
+    if ( p->pFile )
+        Th_OutClause( p->pFile, Vec_IntArray(p->vClause), Vec_IntSize(p->vClause) );
+    if ( p->pSat && !p->fUnsat ) {
+        Vec_IntForEachEntry( p->vClause, Lit, k )
+            Vec_IntWriteEntry( p->vClause, k, Abc_Var2Lit( Abc_AbsInt(Lit), Lit < 0 ) );
+        if ( Vec_IntSize(p->vClause) == 0 || !sat_solver_addclause( p->pSat, Vec_IntArray(p->vClause), Vec_IntLimit(p->vClause) ) )
+            p->fUnsat = 1;
+    }
+}
+
+void Th_CnfManAddClause( Th_CnfMan_t * p, int * pLits, int nLits )
+{
+    Vec_IntClear( p->vClause );
+    Vec_IntPushArray( p->vClause, pLits, nLits );
+    Th_CnfWriteClause( p );
+}
+
+static void Th_CnfClause( Th_CnfMan_t * p, int Lit0, int Lit1, int Lit2 )
+{
+    Vec_IntClear( p->vClause );
+    Vec_IntPush( p->vClause, Lit0 );
+    if ( Lit1 ) Vec_IntPush( p->vClause, Lit1 );
+    if ( Lit2 ) Vec_IntPush( p->vClause, Lit2 );
+    Th_CnfWriteClause( p );
+}
+
+static void Th_CnfClause4( Th_CnfMan_t * p, int Lit0, int Lit1, int Lit2, int Lit3 )
+{
+    Vec_IntClear( p->vClause );
+    Vec_IntPush( p->vClause, Lit0 );
+    Vec_IntPush( p->vClause, Lit1 );
+    Vec_IntPush( p->vClause, Lit2 );
+    Vec_IntPush( p->vClause, Lit3 );
+    Th_CnfWriteClause( p );
+}
+
+static int Th_CnfAnd( Th_CnfMan_t * p, int a, int b )
+{
+    int v;
+    if ( a == TH_CNF_FALSE || b == TH_CNF_FALSE || a == -b ) return TH_CNF_FALSE;
+    if ( a == TH_CNF_TRUE || a == b ) return b;
+    if ( b == TH_CNF_TRUE ) return a;
+    v = Th_CnfNewVar( p );
+    Th_CnfClause( p, -v, a, 0 );
+    Th_CnfClause( p, -v, b, 0 );
+    Th_CnfClause( p, v, -a, -b );
+    return v;
+}
+
+static inline int Th_CnfOr( Th_CnfMan_t * p, int a, int b ) { return -Th_CnfAnd( p, -a, -b ); }
+
+static int Th_CnfXor( Th_CnfMan_t * p, int a, int b )
+{
+    int v;
+    assert( abs(a) != TH_CNF_TRUE && abs(b) != TH_CNF_TRUE );
+    v = Th_CnfNewVar( p );
+    Th_CnfClause( p, -v, a, b );
+    Th_CnfClause( p, -v, -a, -b );
+    Th_CnfClause( p, v, -a, b );
+    Th_CnfClause( p, v, a, -b );
+    return v;
+}
+
+// v <-> a ^ b for a caller-owned v ( miter outputs )
+void Th_CnfWriteXor( Th_CnfMan_t * p, int a, int b, int v )
+{
+    Th_CnfClause( p, -v, a, b );
+    Th_CnfClause( p, -v, -a, -b );
+    Th_CnfClause( p, v, -a, b );
+    Th_CnfClause( p, v, a, -b );
+}
+
+// v <-> a | ( b & c )
+static int Th_CnfOrAnd( Th_CnfMan_t * p, int a, int b, int c )
+{
+    int v;
+    if ( abs(a) == TH_CNF_TRUE || abs(b) == TH_CNF_TRUE || abs(c) == TH_CNF_TRUE )
+        return Th_CnfOr( p, a, Th_CnfAnd( p, b, c ) );
+    v = Th_CnfNewVar( p );
+    Th_CnfClause( p, -a, v, 0 );
+    Th_CnfClause( p, -b, -c, v );
+    Th_CnfClause( p, -v, a, b );
+    Th_CnfClause( p, -v, a, c );
+    return v;
+}
+
+// full adder : returns the sum , *pCarry gets the majority
+static int Th_CnfFullAdder( Th_CnfMan_t * p, int a, int b, int c, int * pCarry )
+{
+    int s = Th_CnfNewVar( p ), m = Th_CnfNewVar( p );
+    Th_CnfClause4( p, -s, a, b, c );
+    Th_CnfClause4( p, -s, a, -b, -c );
+    Th_CnfClause4( p, -s, -a, b, -c );
+    Th_CnfClause4( p, -s, -a, -b, c );
+    Th_CnfClause4( p, s, -a, -b, -c );
+    Th_CnfClause4( p, s, -a, b, c );
+    Th_CnfClause4( p, s, a, -b, c );
+    Th_CnfClause4( p, s, a, b, -c );
+    Th_CnfClause( p, -m, a, b );
+    Th_CnfClause( p, -m, a, c );
+    Th_CnfClause( p, -m, b, c );
+    Th_CnfClause( p, m, -a, -b );
+    Th_CnfClause( p, m, -a, -c );
+    Th_CnfClause( p, m, -b, -c );
+    *pCarry = m;
+    return s;
+}
+
+// outVar <-> Lit
+static void Th_CnfWriteOutput( Th_CnfMan_t * p, int Lit, int outVar )
+{
+    if ( abs(Lit) == TH_CNF_TRUE )
+        Th_CnfClause( p, Lit == TH_CNF_TRUE ? outVar : -outVar, 0, 0 );
+    else {
+        Th_CnfClause( p, -Lit, outVar, 0 );
+        Th_CnfClause( p, Lit, -outVar, 0 );
+    }
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Normalizes a gate to positive weights.]
+
+  Description [Fills vLits/vWeights by decreasing weight , constant
+               fanins ( variable 0 ) are folded into the threshold.
+               A variable listed more than once gets the sum of its
+               signed weights , so every variable appears at most once
+               ( the PB constraints of the solver require it ) ; the
+               variables whose weights cancel are dropped. Returns the
+               threshold over the normalized sum.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+static int Th_CnfNormalize( Th_CnfMan_t * p, Thre_S * tObj, Vec_Int_t * vFanVars )
+{
+    int i, k, w, Lit, Var, Pos, thre, nLits = 0;
+    thre = tObj->thre;
+    Vec_IntClear( p->vWeights );
+    Vec_IntClear( p->vLits );
+    // sum the signed weights of each variable
+    Vec_IntForEachEntry( vFanVars, Var, i ) {
+        w = Vec_IntEntry( tObj->weights, i );
+        if ( Var == 0 ) { thre -= w; continue; }
+        Vec_IntFillExtra( p->vVarPos, Var + 1, 0 );
+        if ( (Pos = Vec_IntEntry( p->vVarPos, Var )) ) {
+            Vec_IntAddToEntry( p->vWeights, Pos - 1, w );
+            continue;
+        }
+        Vec_IntPush( p->vWeights, w );
+        Vec_IntPush( p->vLits, Var );
+        Vec_IntWriteEntry( p->vVarPos, Var, Vec_IntSize(p->vLits) );
+    }
+    // make the weights positive and sort them in place ; entry i is
+    // read before the sorted prefix [0, nLits) grows over it
+    for ( i = 0; i < Vec_IntSize(p->vLits); ++i ) {
+        Var = Vec_IntEntry( p->vLits, i );
+        w   = Vec_IntEntry( p->vWeights, i );
+        Vec_IntWriteEntry( p->vVarPos, Var, 0 );
+        if ( w == 0 ) continue;
+        Lit = w > 0 ? Var : -Var;
+        if ( w < 0 ) { thre -= w; w = -w; }
+        Vec_IntWriteEntry( p->vWeights, nLits, w );
+        Vec_IntWriteEntry( p->vLits, nLits, Lit );
+        for ( k = nLits++; k > 0 && Vec_IntEntry(p->vWeights, k-1) < w; --k ) {
+            Vec_IntWriteEntry( p->vWeights, k, Vec_IntEntry(p->vWeights, k-1) );
+            Vec_IntWriteEntry( p->vLits,    k, Vec_IntEntry(p->vLits,    k-1) );
+            Vec_IntWriteEntry( p->vWeights, k-1, w );
+            Vec_IntWriteEntry( p->vLits,    k-1, Lit );
+        }
+    }
+    Vec_IntShrink( p->vWeights, nLits );
+    Vec_IntShrink( p->vLits, nLits );
+    Vec_IntFill( p->vSuffix, Vec_IntSize(p->vWeights) + 1, 0 );
+    for ( i = Vec_IntSize(p->vWeights) - 1; i >= 0; --i )
+        Vec_IntWriteEntry( p->vSuffix, i, Vec_IntEntry(p->vSuffix, i+1) + Vec_IntEntry(p->vWeights, i) );
+    return thre;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Shared-cofactor (BDD) encoding.]
+
+  Description [The cofactors of the gate are built as a reduced ordered
+               BDD. The cofactor at level lvl with residual threshold r
+               is f(lvl,r) = sum_{j>=lvl} w_j l_j >= r ; it stays the same
+               function over an interval of r , so each level keeps the
+               intervals of the nodes already built and a cofactor is
+               encoded once no matter how many paths reach it. Every
+               shared node gets one auxiliary variable (the root uses
+               the gate output) ; the unshared nodes between them are
+               written as path clauses , so gates without sharing get
+               the same clauses as the plain cofactor enumeration. The
+               size is linear in the number of fanins times the number
+               of distinct residuals per level , instead of one clause
+               per cofactor path.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+// returns the node of f(lvl,r) or -1 if the node limit is reached
+static int Th_CnfBddBuild_rec( Th_CnfMan_t * p, int lvl, int r, int * pLo, int * pHi )
+{
+    Vec_Int_t * vMemo;
+    int w, k, Node, Node1, Node0, lo1, hi1, lo0, hi0;
+    // terminal cofactors
+    if ( r <= 0 ) {
+        *pLo = -ABC_INFINITY; *pHi = 0;
+        return 1;
+    }
+    if ( r > Vec_IntEntry( p->vSuffix, lvl ) ) {
+        *pLo = Vec_IntEntry( p->vSuffix, lvl ) + 1; *pHi = ABC_INFINITY;
+        return 0;
+    }
+    // cofactors already built at this level
+    vMemo = (Vec_Int_t *)Vec_PtrEntry( p->vMemo, lvl );
+    for ( k = 0; k < Vec_IntSize(vMemo); k += 3 )
+        if ( Vec_IntEntry(vMemo, k) <= r && r <= Vec_IntEntry(vMemo, k+1) ) {
+            *pLo = Vec_IntEntry(vMemo, k); *pHi = Vec_IntEntry(vMemo, k+1);
+            return Vec_IntEntry(vMemo, k+2);
+        }
+    if ( p->nNodeLimit && Vec_IntSize(p->vNodes) / 3 >= p->nNodeLimit )
+        return -1;
+    w     = Vec_IntEntry( p->vWeights, lvl );
+    Node1 = Th_CnfBddBuild_rec( p, lvl+1, r - w, &lo1, &hi1 );
+    if ( Node1 == -1 ) return -1;
+    Node0 = Th_CnfBddBuild_rec( p, lvl+1, r, &lo0, &hi0 );
+    if ( Node0 == -1 ) return -1;
+    *pLo  = Abc_MaxInt( Th_IntervalShift(lo1, w), lo0 );
+    *pHi  = Abc_MinInt( Th_IntervalShift(hi1, w), hi0 );
+    if ( Node1 == Node0 )
+        Node = Node1;
+    else {
+        Node = 2 + Vec_IntSize(p->vNodes) / 3;
+        Vec_IntPush( p->vNodes, lvl );
+        Vec_IntPush( p->vNodes, Node1 );
+        Vec_IntPush( p->vNodes, Node0 );
+    }
+    Vec_IntPush( vMemo, *pLo );
+    Vec_IntPush( vMemo, *pHi );
+    Vec_IntPush( vMemo, Node );
+    return Node;
+}
+
+static int Th_CnfBddBuild( Th_CnfMan_t * p, int thre )
+{
+    Vec_Int_t * vMemo;
+    int i, lo, hi;
+    while ( Vec_PtrSize(p->vMemo) < Vec_IntSize(p->vWeights) + 1 )
+        Vec_PtrPush( p->vMemo, Vec_IntAlloc(8) );
+    Vec_PtrForEachEntry( Vec_Int_t *, p->vMemo, vMemo, i )
+        Vec_IntClear( vMemo );
+    Vec_IntClear( p->vNodes );
+    return Th_CnfBddBuild_rec( p, 0, thre, &lo, &hi );
+}
+
+// writes the paths from an encoded node down to the constants or the next shared node
+static void Th_CnfBddWritePaths_rec( Th_CnfMan_t * p, int Node, int aVar, int fStart )
+{
+    int xLit, sVar;
+    if ( Node < 2 || ( !fStart && Vec_IntEntry(p->vNodeVars, Node-2) ) ) {
+        sVar = ( Node < 2 ) ? 0 : Vec_IntEntry( p->vNodeVars, Node-2 );
+        Vec_IntClear( p->vClause );
+        Vec_IntAppend( p->vClause, p->vCube );
+        if ( Node < 2 )
+            Vec_IntPush( p->vClause, Node ? aVar : -aVar );
+        else
+            Vec_IntPush( p->vClause, -sVar ), Vec_IntPush( p->vClause, aVar );
+        Th_CnfWriteClause( p );
+        if ( Node < 2 ) return;
+        Vec_IntClear( p->vClause );
+        Vec_IntAppend( p->vClause, p->vCube );
+        Vec_IntPush( p->vClause, sVar );
+        Vec_IntPush( p->vClause, -aVar );
+        Th_CnfWriteClause( p );
+        return;
+    }
+    xLit = Vec_IntEntry( p->vLits, Vec_IntEntry(p->vNodes, 3*(Node-2)) );
+    Vec_IntPush( p->vCube, -xLit );
+    Th_CnfBddWritePaths_rec( p, Vec_IntEntry(p->vNodes, 3*(Node-2)+1), aVar, 0 );
+    Vec_IntPop( p->vCube );
+    Vec_IntPush( p->vCube, xLit );
+    Th_CnfBddWritePaths_rec( p, Vec_IntEntry(p->vNodes, 3*(Node-2)+2), aVar, 0 );
+    Vec_IntPop( p->vCube );
+}
+
+static void Th_CnfBddWrite( Th_CnfMan_t * p, int Root, int outVar )
+{
+    int k, nNodes, Node1, Node0;
+    if ( Root < 2 ) {
+        Th_CnfClause( p, Root ? outVar : -outVar, 0, 0 );
+        return;
+    }
+    // the root and the nodes reached by several branches get variables ,
+    // the other nodes are expanded into the paths through them
+    nNodes = Vec_IntSize(p->vNodes) / 3;
+    Vec_IntFill( p->vNodeVars, nNodes, 0 );
+    for ( k = 0; k < nNodes; ++k ) {
+        Node1 = Vec_IntEntry( p->vNodes, 3*k+1 );
+        Node0 = Vec_IntEntry( p->vNodes, 3*k+2 );
+        if ( Node1 >= 2 ) Vec_IntAddToEntry( p->vNodeVars, Node1-2, 1 );
+        if ( Node0 >= 2 ) Vec_IntAddToEntry( p->vNodeVars, Node0-2, 1 );
+    }
+    for ( k = 0; k < nNodes; ++k )
+        Vec_IntWriteEntry( p->vNodeVars, k, (2+k == Root) ? outVar : (Vec_IntEntry(p->vNodeVars, k) > 1 ? Th_CnfNewVar(p) : 0) );
+    Vec_IntClear( p->vCube );
+    for ( k = 0; k < nNodes; ++k )
+        if ( Vec_IntEntry(p->vNodeVars, k) )
+            Th_CnfBddWritePaths_rec( p, 2+k, Vec_IntEntry(p->vNodeVars, k), 1 );
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Sequential weight counter encoding.]
+
+  Description [Row i holds s(i,j) <-> sum_{k<=i} w_k l_k >= j with
+               s(i,j) = s(i-1,j) | ( l_i & s(i-1,j-w_i) ). Only the
+               columns j in [T - suffix(i+1), min(T, prefix(i))] can
+               reach the output s(n-1,T) , the others are constants.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+static inline int Th_CnfCounterLo( Th_CnfMan_t * p, int i, int thre ) { return Abc_MaxInt( 1, thre - Vec_IntEntry(p->vSuffix, i+1) ); }
+static inline int Th_CnfCounterHi( Th_CnfMan_t * p, int i, int thre ) { return Abc_MinInt( thre, Vec_IntEntry(p->vSuffix, 0) - Vec_IntEntry(p->vSuffix, i+1) ); }
+
+static double Th_CnfCounterCost( Th_CnfMan_t * p, int thre )
+{
+    double Cost = 0;
+    int i;
+    for ( i = 0; i < Vec_IntSize(p->vWeights); ++i )
+        Cost += 4.0 * Abc_MaxInt( 0, Th_CnfCounterHi(p, i, thre) - Th_CnfCounterLo(p, i, thre) + 1 );
+    return Cost;
+}
+
+// literal of s(i,j) from a row stored for the columns lo..hi
+static inline int Th_CnfCounterLit( Vec_Int_t * vRow, int lo, int hi, int j )
+{
+    if ( j <= 0 ) return TH_CNF_TRUE;
+    if ( j > hi ) return TH_CNF_FALSE;
+    assert( j >= lo );
+    return Vec_IntEntry( vRow, j - lo );
+}
+
+static int Th_CnfCounterWrite( Th_CnfMan_t * p, int thre )
+{
+    Vec_Int_t * vTemp;
+    int i, j, w, lo, hi, loPrev = 1, hiPrev = 0;
+    Vec_IntClear( p->vPrev );
+    for ( i = 0; i < Vec_IntSize(p->vWeights); ++i ) {
+        w  = Vec_IntEntry( p->vWeights, i );
+        lo = Th_CnfCounterLo( p, i, thre );
+        hi = Th_CnfCounterHi( p, i, thre );
+        Vec_IntClear( p->vCur );
+        for ( j = lo; j <= hi; ++j )
+            Vec_IntPush( p->vCur, Th_CnfOrAnd( p, Th_CnfCounterLit(p->vPrev, loPrev, hiPrev, j),
+                                                  Vec_IntEntry(p->vLits, i),
+                                                  Th_CnfCounterLit(p->vPrev, loPrev, hiPrev, j - w) ) );
+        vTemp = p->vPrev; p->vPrev = p->vCur; p->vCur = vTemp;
+        loPrev = lo; hiPrev = hi;
+    }
+    return Th_CnfCounterLit( p->vPrev, loPrev, hiPrev, thre );
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Generalized totalizer encoding.]
+
+  Description [The weighted literals are merged pairwise in a balanced
+               tree. A tree node has one literal o(v) <-> sum >= v for
+               each sum v it can reach , sums beyond T are cut to T.
+               Merging A and B writes a(x) & b(y) -> o(x+y) upwards ,
+               !a(next x) & !b(next y) -> !o(next sum above x+y)
+               downwards and o(v') -> o(v) between neighbouring sums.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+// a totalizer node is a Vec_Int_t of (value, literal) pairs by increasing value
+static Vec_Int_t * Th_CnfTotMerge( Th_CnfMan_t * p, Vec_Int_t * vA, Vec_Int_t * vB, int thre, int fWrite, double * pCost )
+{
+    Vec_Int_t * vSums = Vec_IntAlloc( Vec_IntSize(vA) * Vec_IntSize(vB) / 4 + 4 );
+    Vec_Int_t * vRes;
+    int i, j, k, nA = Vec_IntSize(vA) / 2, nB = Vec_IntSize(vB) / 2;
+    int a, b, aNext, bNext, LitA, LitB, LitO, v;
+    // output values
+    for ( i = 0; i <= nA; ++i )
+    for ( j = 0; j <= nB; ++j )
+        if ( i + j > 0 )
+            Vec_IntPush( vSums, Abc_MinInt( thre, (i ? Vec_IntEntry(vA, 2*i-2) : 0) + (j ? Vec_IntEntry(vB, 2*j-2) : 0) ) );
+    Vec_IntUniqify( vSums );
+    *pCost += 2.0 * (nA + 1) * (nB + 1) + Vec_IntSize(vSums);
+    vRes = Vec_IntAlloc( 2 * Vec_IntSize(vSums) );
+    Vec_IntForEachEntry( vSums, v, k ) {
+        Vec_IntPush( vRes, v );
+        Vec_IntPush( vRes, fWrite ? Th_CnfNewVar(p) : 0 );
+    }
+    Vec_IntFree( vSums );
+    if ( !fWrite )
+        return vRes;
+    for ( i = 0; i <= nA; ++i )
+    for ( j = 0; j <= nB; ++j ) {
+        a     = i ? Vec_IntEntry(vA, 2*i-2) : 0;
+        b     = j ? Vec_IntEntry(vB, 2*j-2) : 0;
+        LitA  = i ? Vec_IntEntry(vA, 2*i-1) : TH_CNF_TRUE;
+        LitB  = j ? Vec_IntEntry(vB, 2*j-1) : TH_CNF_TRUE;
+        // upwards : sum >= a+b
+        if ( i + j > 0 ) {
+            for ( k = 0; Vec_IntEntry(vRes, 2*k) != Abc_MinInt(thre, a+b); ++k );
+            Th_CnfClause( p, -LitA, -LitB, Vec_IntEntry(vRes, 2*k+1) );
+        }
+        // downwards : sum <= a+b when both are below their next values
+        for ( k = 0; k < Vec_IntSize(vRes) / 2 && Vec_IntEntry(vRes, 2*k) <= a + b; ++k );
+        if ( k == Vec_IntSize(vRes) / 2 ) continue;
+        aNext = ( i < nA ) ? Vec_IntEntry(vA, 2*i+1) : TH_CNF_FALSE;
+        bNext = ( j < nB ) ? Vec_IntEntry(vB, 2*j+1) : TH_CNF_FALSE;
+        Th_CnfClause( p, aNext, bNext, -Vec_IntEntry(vRes, 2*k+1) );
+    }
+    for ( k = 1; k < Vec_IntSize(vRes) / 2; ++k ) {
+        LitO = Vec_IntEntry( vRes, 2*k+1 );
+        Th_CnfClause( p, -LitO, Vec_IntEntry(vRes, 2*k-1), 0 );
+    }
+    return vRes;
+}
+
+// returns the literal of sum >= thre ( 1 if !fWrite ) , or 0 if the cost exceeds CostLimit
+static int Th_CnfTotalizer( Th_CnfMan_t * p, int thre, int fWrite, double CostLimit, double * pCost )
+{
+    Vec_Ptr_t * vLevel = Vec_PtrAlloc( Vec_IntSize(p->vWeights) ), * vNext;
+    Vec_Int_t * vNode;
+    int i, Lit = 0;
+    *pCost = 0;
+    for ( i = 0; i < Vec_IntSize(p->vWeights); ++i ) {
+        vNode = Vec_IntAlloc( 2 );
+        Vec_IntPush( vNode, Abc_MinInt( thre, Vec_IntEntry(p->vWeights, i) ) );
+        Vec_IntPush( vNode, Vec_IntEntry(p->vLits, i) );
+        Vec_PtrPush( vLevel, vNode );
+    }
+    while ( Vec_PtrSize(vLevel) > 1 && *pCost <= CostLimit ) {
+        vNext = Vec_PtrAlloc( Vec_PtrSize(vLevel) / 2 + 1 );
+        for ( i = 0; i + 1 < Vec_PtrSize(vLevel) && *pCost <= CostLimit; i += 2 ) {
+            Vec_PtrPush( vNext, Th_CnfTotMerge( p, (Vec_Int_t *)Vec_PtrEntry(vLevel, i), (Vec_Int_t *)Vec_PtrEntry(vLevel, i+1), thre, fWrite, pCost ) );
+            Vec_IntFree( (Vec_Int_t *)Vec_PtrEntry(vLevel, i) );
+            Vec_IntFree( (Vec_Int_t *)Vec_PtrEntry(vLevel, i+1) );
+        }
+        for ( ; i < Vec_PtrSize(vLevel); ++i )
+            Vec_PtrPush( vNext, Vec_PtrEntry(vLevel, i) );
+        Vec_PtrFree( vLevel );
+        vLevel = vNext;
+    }
+    if ( Vec_PtrSize(vLevel) == 1 ) {
+        vNode = (Vec_Int_t *)Vec_PtrEntry( vLevel, 0 );
+        Lit = ( Vec_IntEntry(vNode, Vec_IntSize(vNode) - 2) == thre ) ? Vec_IntEntryLast(vNode) : TH_CNF_FALSE;
+        if ( !fWrite ) Lit = 1;
+    }
+    Vec_VecFree( (Vec_Vec_t *)vLevel );
+    return Lit;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Binary adder with comparator encoding.]
+
+  Description [The weights are split into their bits , the literals of
+               each bit column are added up with full/half adders and
+               the binary sum is compared with T from the lowest bit :
+               ge(k) = R_k & ge(k-1) if T_k = 1 , else R_k | ge(k-1).]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+static double Th_CnfAdderCost( Th_CnfMan_t * p, int thre )
+{
+    int i, w, nBits = 0;
+    for ( i = 0; i < Vec_IntSize(p->vWeights); ++i )
+        for ( w = Vec_IntEntry(p->vWeights, i); w; w &= w - 1 )
+            nBits++;
+    return 14.0 * nBits + 3.0 * Abc_Base2Log( Vec_IntEntry(p->vSuffix, 0) + 1 );
+}
+
+static int Th_CnfAdderWrite( Th_CnfMan_t * p, int thre )
+{
+    Vec_Int_t * vBucket;
+    int i, k, w, a, b, c, Carry, Ge = TH_CNF_TRUE;
+    int nBits = Abc_Base2Log( Vec_IntEntry(p->vSuffix, 0) + 1 ) + 1;
+    while ( Vec_PtrSize(p->vBuckets) < nBits + 1 )
+        Vec_PtrPush( p->vBuckets, Vec_IntAlloc(8) );
+    Vec_PtrForEachEntry( Vec_Int_t *, p->vBuckets, vBucket, k )
+        Vec_IntClear( vBucket );
+    for ( i = 0; i < Vec_IntSize(p->vWeights); ++i )
+        for ( w = Vec_IntEntry(p->vWeights, i), k = 0; w; w >>= 1, ++k )
+            if ( w & 1 )
+                Vec_IntPush( (Vec_Int_t *)Vec_PtrEntry(p->vBuckets, k), Vec_IntEntry(p->vLits, i) );
+    for ( k = 0; k < nBits; ++k ) {
+        vBucket = (Vec_Int_t *)Vec_PtrEntry( p->vBuckets, k );
+        while ( Vec_IntSize(vBucket) > 1 ) {
+            a = Vec_IntPop( vBucket );
+            b = Vec_IntPop( vBucket );
+            if ( Vec_IntSize(vBucket) > 0 ) {
+                c = Vec_IntPop( vBucket );
+                Vec_IntInsert( vBucket, 0, Th_CnfFullAdder( p, a, b, c, &Carry ) );
+            }
+            else {
+                Vec_IntInsert( vBucket, 0, Th_CnfXor( p, a, b ) );
+                Carry = Th_CnfAnd( p, a, b );
+            }
+            Vec_IntPush( (Vec_Int_t *)Vec_PtrEntry(p->vBuckets, k+1), Carry );
+        }
+    }
+    // compare the sum with the threshold from the lowest bit
+    for ( k = 0; k < nBits; ++k ) {
+        vBucket = (Vec_Int_t *)Vec_PtrEntry( p->vBuckets, k );
+        a = Vec_IntSize(vBucket) ? Vec_IntEntry(vBucket, 0) : TH_CNF_FALSE;
+        Ge = ( (thre >> k) & 1 ) ? Th_CnfAnd( p, a, Ge ) : Th_CnfOr( p, a, Ge );
+    }
+    assert( (thre >> nBits) == 0 );
+    return Ge;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Native pseudo-Boolean constraints.]
+
+  Description [The normalized gate goes to the solver as the two
+               constraints  sum w_i l_i + thre !y >= thre  and
+               sum w_i !l_i + (W-thre+1) y >= W-thre+1 , where W is the
+               sum of the weights. The solver propagates them with slack
+               counters , so no auxiliary variables or clauses are made.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+static void Th_CnfPbWrite( Th_CnfMan_t * p, int thre, int outVar )
+{
+    int i, Lit, nLits = Vec_IntSize(p->vLits);
+    int Slack = Vec_IntEntry(p->vSuffix, 0) - thre + 1;
+    assert( p->pSat );
+    if ( p->fUnsat )
+        return;
+    // y -> sum >= thre
+    Vec_IntClear( p->vClause );
+    Vec_IntForEachEntry( p->vLits, Lit, i )
+        Vec_IntPush( p->vClause, Abc_Var2Lit( Abc_AbsInt(Lit), Lit < 0 ) );
+    Vec_IntPush( p->vClause, Abc_Var2Lit( outVar, 1 ) );
+    Vec_IntPush( p->vWeights, thre );
+    if ( !sat_solver_addpb( p->pSat, Vec_IntArray(p->vClause), Vec_IntLimit(p->vClause), Vec_IntArray(p->vWeights), thre ) )
+        p->fUnsat = 1;
+    // !y -> sum < thre
+    for ( i = 0; i <= nLits; ++i )
+        Vec_IntWriteEntry( p->vClause, i, Abc_LitNot(Vec_IntEntry(p->vClause, i)) );
+    Vec_IntWriteEntry( p->vWeights, nLits, Slack );
+    if ( !p->fUnsat && !sat_solver_addpb( p->pSat, Vec_IntArray(p->vClause), Vec_IntLimit(p->vClause), Vec_IntArray(p->vWeights), Slack ) )
+        p->fUnsat = 1;
+    Vec_IntShrink( p->vWeights, nLits );
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Writes outVar <-> tObj over the fanin variables.]
+
+  Description [vFanVars holds the variable of each fanin , 0 for the
+               constant-1 fanin. The automatic choice takes the
+               encoding with the fewest estimated clauses ; the BDD is
+               built with that estimate as node limit and is kept if it
+               fits.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+void Th_CnfWriteObj( Th_CnfMan_t * p, Thre_S * tObj, Vec_Int_t * vFanVars, int outVar )
+{
+    double Cost, CostBest;
+    int thre, Enc, Root = -1, Lit;
+    thre = Th_CnfNormalize( p, tObj, vFanVars );
+    if ( thre <= 0 || thre > Vec_IntEntry(p->vSuffix, 0) ) {
+        Th_CnfClause( p, thre <= 0 ? outVar : -outVar, 0, 0 );
+        p->nGates[TH_CNF_ENC_BDD]++;
+        return;
+    }
+    Enc = p->Encoding;
+    if ( Enc == TH_CNF_ENC_PB ) {
+        p->nGates[Enc]++;
+        Th_CnfPbWrite( p, thre, outVar );
+        return;
+    }
+    if ( Enc == TH_CNF_ENC_AUTO ) {
+        Enc = TH_CNF_ENC_ADDER;
+        CostBest = Th_CnfAdderCost( p, thre );
+        if ( (Cost = Th_CnfCounterCost( p, thre )) <= CostBest )
+            Enc = TH_CNF_ENC_COUNTER, CostBest = Cost;
+        if ( Th_CnfTotalizer( p, thre, 0, CostBest, &Cost ) && Cost < CostBest )
+            Enc = TH_CNF_ENC_TOTALIZER, CostBest = Cost;
+        p->nNodeLimit = (int)Abc_MinDouble( CostBest / 2 + 1, ABC_INFINITY );
+        Root = Th_CnfBddBuild( p, thre );
+        p->nNodeLimit = 0;
+        if ( Root >= 0 )
+            Enc = TH_CNF_ENC_BDD;
+    }
+    p->nGates[Enc]++;
+    if ( Enc == TH_CNF_ENC_BDD ) {
+        if ( Root < 0 )
+            Root = Th_CnfBddBuild( p, thre );
+        Th_CnfBddWrite( p, Root, outVar );
+        return;
+    }
+    if ( Enc == TH_CNF_ENC_COUNTER )
+        Lit = Th_CnfCounterWrite( p, thre );
+    else if ( Enc == TH_CNF_ENC_TOTALIZER )
+        Lit = Th_CnfTotalizer( p, thre, 1, ABC_INFINITY, &Cost );
+    else
+        Lit = Th_CnfAdderWrite( p, thre );
+    Th_CnfWriteOutput( p, Lit, outVar );
+}
+
+////////////////////////////////////////////////////////////////////////
+///                       END OF FILE                                ///
+////////////////////////////////////////////////////////////////////////
@@ -1,5 +1,6 @@
 #include "base/abc/abc.h"
 #include <stdio.h>
+#include "misc/util/utilNam.h"
 #include "threshold.h"
 
 void    DeleteTList     (Vec_Ptr_t *);
@@ -19,13 +20,7 @@ void DeleteTList(Vec_Ptr_t * tList)
     Vec_PtrForEachEntry( Thre_S * , tList , tObj , i ) {
        //printf( " > Delete %d-th object , ptr = %p\n" , i  , tObj );
        //fflush( stdout );
-       if ( tObj != NULL ) {
-          if ( tObj->pName ) ABC_FREE( tObj->pName );
-          Vec_IntFree( tObj->weights );
-          Vec_IntFree( tObj->Fanins  );
-          Vec_IntFree( tObj->Fanouts );
-          ABC_FREE( tObj );
-       }
+       if ( tObj != NULL ) Th_ObjRecycle( tObj );
     }
     //printf( "tList = %p\n" , tList );
     Vec_PtrFree( tList );
@@ -35,167 +30,224 @@ void DeleteTList(Vec_Ptr_t * tList)
  * Function: Read File*
  *********************/
 
+/**Function*************************************************************
+
+  Synopsis    [Creates the gate of one .threshold block.]
+
+  Description [The block holds the fanin names , the output name , the
+               weights and the threshold ; vToks has the begin and end
+               of each token in the buffer of the tokenizer and vLines
+               its line , iLine is the line of the .threshold keyword ;
+               errors are reported at these lines. The fanins
+               are kept as name ids and resolved once the whole file is
+               read. Returns 0 if the block is malformed.]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+static int Th_ReadBlock( Th_Tok_t * pTok, Vec_Ptr_t * vTG, Abc_Nam_t * pNames, Vec_Int_t * vName2Obj,
+                         Vec_Ptr_t * vToks, Vec_Int_t * vLines, int iLine, int * pIdCount )
+{
+    Thre_S * thisGate;
+    char ** pToks = (char **)Vec_PtrArray( vToks );
+    int nFanins = Vec_PtrSize(vToks) / 4 - 1;
+    int i, NameId, Value, fFound;
+    if ( Vec_PtrSize(vToks) < 4 || Vec_PtrSize(vToks) % 4 ) {
+        printf( "%s:%d: a .threshold block has %d tokens, an even number is expected\n",
+            Th_TokFileName(pTok), iLine, Vec_PtrSize(vToks) / 2 );
+        return 0;
+    }
+    NameId = Abc_NamStrFindOrAddLim( pNames, pToks[2*nFanins], pToks[2*nFanins+1], &fFound );
+    if ( NameId >= Vec_IntSize(vName2Obj) )
+        Vec_IntFillExtra( vName2Obj, NameId + 1, -1 );
+    // the outputs are declared in the header ; the other gates come in order
+    if ( Vec_IntEntry(vName2Obj, NameId) == -1 ) {
+        thisGate = newThre( (*pIdCount)++, Abc_NamStr(pNames, NameId) );
+        thisGate->Type = Th_Node;
+        Vec_PtrPush( vTG, thisGate );
+        Vec_IntWriteEntry( vName2Obj, NameId, thisGate->Id );
+    }
+    else {
+        thisGate = (Thre_S*)Vec_PtrEntry( vTG, Vec_IntEntry(vName2Obj, NameId) );
+        if ( thisGate->Type != Th_Po || Vec_IntSize(thisGate->Fanins) || Vec_IntSize(thisGate->weights) ) {
+            printf( "%s:%d: gate \"%s\" is defined more than once\n",
+                Th_TokFileName(pTok), Vec_IntEntry(vLines, nFanins), Abc_NamStr(pNames, NameId) );
+            return 0;
+        }
+    }
+    for ( i = 0; i < nFanins; ++i )
+        Vec_IntPush( thisGate->Fanins, Abc_NamStrFindOrAddLim(pNames, pToks[2*i], pToks[2*i+1], NULL) );
+    for ( i = nFanins + 1; i <= 2 * nFanins + 1; ++i ) {
+        if ( !Th_TokReadInt( pToks[2*i], pToks[2*i+1], &Value ) ) {
+            printf( "%s:%d: weight \"%.*s\" of gate \"%s\" is not an integer\n", Th_TokFileName(pTok), Vec_IntEntry(vLines, i),
+                (int)(pToks[2*i+1] - pToks[2*i]), pToks[2*i], Abc_NamStr(pNames, NameId) );
+            return 0;
+        }
+        if ( i <= 2 * nFanins )
+            Vec_IntPush( thisGate->weights, Value );
+        else
+            thisGate->thre = Value;
+    }
+    return 1;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Reads a .th file.]
+
+  Description [Files with extension .thb are read by Th_NtkReadThb() ,
+               others in a single pass , tokenized in place. Names are
+               hashed , so fanins may refer to gates defined later ; they
+               are resolved into object ids at the end. Objects are
+               numbered as before : the constant is 0 , then the inputs ,
+               the outputs and the other gates in the order of the file.]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
 
 Vec_Ptr_t* func_readFileOAO(char* fileName)
 {
-    FILE *inFile;
-    inFile = fopen(fileName, "r");
-    if (inFile == NULL){
+    Th_Tok_t  * pTok;
+    Vec_Ptr_t * vTG = NULL;       // total TG container
+    Abc_Nam_t * pNames;           // names of the gates
+    Vec_Int_t * vName2Obj;        // name id -> object id
+    Vec_Ptr_t * vToks;            // begin and end of the tokens of the current block
+    Vec_Int_t * vLines;           // lines of the tokens of the current block
+    Thre_S    * thisGate, * finGate;
+    char      * pBeg, * pEnd;
+    int piCount = 0, poCount = 0, tgCount = 0;
+    int i, j, NameId, fFound, fOk = 0, fMore, iLine;
+    int idCount = 0;
+
+    if ( Th_FileIsThb( fileName ) ) {
+        Th_Ntk_t * pNtk = Th_NtkReadThb( fileName );
+        if ( pNtk == NULL )
+            return NULL;
+        vTG = Th_NtkToList( pNtk );
+        Th_NtkFree( pNtk );
+        return vTG;
+    }
+    pTok = Th_TokStart( fileName );
+    if (pTok == NULL){
         printf("read failed\n");
         return NULL;
     }
-    Vec_Ptr_t* vTG;    // total TG container
-    Vec_Int_t* iCount; // counting Fanins
-    iCount = Vec_IntAlloc( 10 );   
-    
-    char buf[1000], buf2[1000];
-    int piCount = 0;
-    int poCount = 0;
-    int tgCount = 0;
-    Vec_Str_t*  moduleName = Vec_StrAlloc(10);
-
-    /*** parse gate counts ***/
+    pNames    = Abc_NamStart( Abc_MaxInt(1000, Th_TokFileSize(pTok) / 32), 10 );
+    vName2Obj = Vec_IntAlloc( 1000 );
+    vToks     = Vec_PtrAlloc( 100 );
+    vLines    = Vec_IntAlloc( 50 );
+    vTG       = Vec_PtrAlloc( 1000 );
+
     // first line: ignore
-    fgets( buf, 1000, inFile);
+    Th_TokSkipLine( pTok );
     // get modelName
-    fscanf( inFile, "%s%s", buf, buf2);
-    if ( !strncmp(buf, ".model", 6) )
-        Vec_StrPushBuffer( moduleName, buf2, 1000 );
-    printf("\tmoduleName:%s\n", moduleName->pArray);
-    // PI count    
-    fscanf( inFile , "%s", buf );
-    if (strncmp(buf, ".inputs", 6)){
-        printf("no INPUT detected\n");
-        return NULL;
-    }
-    // PO count
-    while ( fscanf(inFile, "%s", buf) ){
-        if( !strncmp(buf, ".outputs", 6 ))
-            break;
-        piCount++;
+    fMore = Th_TokNext( pTok, &pBeg, &pEnd );
+    if ( fMore && Th_TokIsPrefix(pBeg, pEnd, ".model") ) {
+        Th_TokNext( pTok, &pBeg, &pEnd );
+        printf("\tmoduleName:%.*s\n", (int)(pEnd - pBeg), pBeg);
+        fMore = Th_TokNext( pTok, &pBeg, &pEnd );
     }
-    // thresholdGate count
-    while ( fscanf(inFile, "%s", buf) ){
-        if( !strncmp(buf, ".threshold", 10) ){
-            tgCount++;
-            break;
-        }
-       poCount++;
+    if ( !fMore || !Th_TokIsPrefix(pBeg, pEnd, ".input") ) {
+        printf("no INPUT detected\n");
+        goto finish;
     }
-    int counter = 0;
-    while (1){
-        if(fscanf(inFile,"%s", buf) == EOF){
-            Vec_IntPush( iCount, counter/2 );
-            break;
+
+    // Const1 gate, id = 0, type = 4 
+    thisGate = newThre( idCount++, "CONST1" );
+    thisGate->Type = Th_CONST1;
+    Vec_PtrPush( vTG, thisGate );
+    NameId = Abc_NamStrFindOrAdd( pNames, "CONST1", NULL );
+    Vec_IntFillExtra( vName2Obj, NameId + 1, -1 );
+    Vec_IntWriteEntry( vName2Obj, NameId, thisGate->Id );
+
+    // inputs and outputs
+    for ( i = 0; i < 2; ++i ) {
+        while ( (fMore = Th_TokNext(pTok, &pBeg, &pEnd)) && *pBeg != '.' ) {
+            NameId = Abc_NamStrFindOrAddLim( pNames, pBeg, pEnd, &fFound );
+            if ( fFound ) {
+                printf("%s:%d: gate \"%s\" is declared more than once\n", fileName, Th_TokLine(pTok), Abc_NamStr(pNames, NameId));
+                goto finish;
+            }
+            thisGate = newThre( idCount++, Abc_NamStr(pNames, NameId) );
+            thisGate->Type = i ? Th_Po : Th_Pi;
+            Vec_PtrPush( vTG, thisGate );
+            Vec_IntFillExtra( vName2Obj, NameId + 1, -1 );
+            Vec_IntWriteEntry( vName2Obj, NameId, thisGate->Id );
+            if ( i ) poCount++; else piCount++;
         }
-        if( !strncmp(buf, ".threshold", 10) ){
-            tgCount++;
-            Vec_IntPush( iCount, counter/2 );
-            counter = 0;
+        if ( i == 0 && (!fMore || !Th_TokIsPrefix(pBeg, pEnd, ".output")) ) {
+            printf("no OUTPUT detected\n");
+            goto finish;
         }
-        else counter++;
     }
-    printf("\tPIcount:%d\n\tPOcount:%d\n\tTGcount:%d\n", piCount, poCount, tgCount);
-
-    // reRead inFile
-    rewind(inFile);
-    // initialize  containers
-    vTG = Vec_PtrAlloc( tgCount + piCount );
-    fgets( buf, 1000, inFile ); // Threshold logic gates synthesis
-    fgets( buf, 1000, inFile ); // .model <modelName>
-
-    int i, j, intBuf;
-    int idCount = 0;
 
-    // Const1 gate, id = 0, type = 4 
-    Thre_S* newGate = newThre( idCount++, "CONST1" );
-    newGate->Type = 4;
-    Vec_PtrPush( vTG, newGate );
-
-    fscanf( inFile, "%s", buf); // .inputs
-    for( i = 0; i < piCount; ++i){
-        fscanf( inFile, "%s", buf);
-        Thre_S* newGate = newThre( idCount++, buf );
-        newGate->Type = 1;
-        Vec_PtrPush( vTG, newGate );
+    // threshold gates
+    while ( fMore && Th_TokIsPrefix(pBeg, pEnd, ".threshold") ) {
+        // the next keyword is read before the block is parsed
+        iLine = Th_TokLine( pTok );
+        Vec_PtrClear( vToks );
+        Vec_IntClear( vLines );
+        while ( (fMore = Th_TokNext(pTok, &pBeg, &pEnd)) && *pBeg != '.' ) {
+            Vec_PtrPush( vToks, pBeg );
+            Vec_PtrPush( vToks, pEnd );
+            Vec_IntPush( vLines, Th_TokLine(pTok) );
+        }
+        if ( !Th_ReadBlock(pTok, vTG, pNames, vName2Obj, vToks, vLines, iLine, &idCount) )
+            goto finish;
+        tgCount++;
     }
-    
-    fscanf( inFile, "%s", buf); // .outputs
-    for( i = 0; i < poCount; ++i){
-        fscanf( inFile, "%s", buf);
-        Thre_S* newGate = newThre( idCount++, buf );
-        newGate->Type = 2;
-        Vec_PtrPush( vTG, newGate );
+    if ( fMore && !Th_TokIsPrefix(pBeg, pEnd, ".end") ) {
+        printf("%s:%d: unexpected token \"%.*s\"\n", fileName, Th_TokLine(pTok), (int)(pEnd - pBeg), pBeg);
+        goto finish;
     }
-    fgets( buf, 1000, inFile ); // read '\n' at the bottom of the line
-    for( i = 0; i < tgCount; ++i ){
-        if ( i < poCount ){
-            fgets( buf, 1000, inFile );// ignore 2 lines
-            fgets( buf, 1000, inFile );
+    printf("\tPIcount:%d\n\tPOcount:%d\n\tTGcount:%d\n", piCount, poCount, tgCount);
+
+    // resolve the fanin names and connect the fanouts
+    Vec_IntFillExtra( vName2Obj, Abc_NamObjNumMax(pNames), -1 );
+    Vec_PtrForEachEntry( Thre_S *, vTG, thisGate, i ) {
+        if ( thisGate->Type == Th_Po && Vec_IntSize(thisGate->Fanins) == 0 ) {
+            printf("output \"%s\" is not defined\n", thisGate->pName);
+            goto finish;
         }
-        else{
-            for( j = 0; j < Vec_IntEntry( iCount, i );++j ){
-                fscanf( inFile, "%s", buf);
+        Vec_IntForEachEntry( thisGate->Fanins, NameId, j ) {
+            if ( Vec_IntEntry(vName2Obj, NameId) == -1 ) {
+                printf("fanin \"%s\" of gate \"%s\" is not defined\n", Abc_NamStr(pNames, NameId), thisGate->pName);
+                goto finish;
             }
-            fscanf( inFile, "%s", buf2);
-            Thre_S* newGate = newThre( idCount++, buf2);
-            newGate->Type = 3;
-            Vec_PtrPush( vTG, newGate );
-            fgets( buf, 1000, inFile ); // read '\n' at the bottom of the line
-            fgets( buf, 1000, inFile ); // ignore 1 line
+            finGate = (Thre_S*)Vec_PtrEntry( vTG, Vec_IntEntry(vName2Obj, NameId) );
+            Vec_IntWriteEntry( thisGate->Fanins, j, finGate->Id );
         }
     }
-    // reRead inFile
-    rewind(inFile);
-    fgets( buf, 1000, inFile ); // Threshold logic gates synthesis
-    fgets( buf, 1000, inFile ); // .model <modelName>
-    for ( i = 0; i < piCount + poCount +2; ++i)
-        fscanf( inFile, "%s", buf );
-    fgets( buf, 1000, inFile ); // read '\n' at the bottom of the line
-   
-    for (i = 0; i < tgCount; ++i){
-                                                // + 1 for constGate
-        Thre_S* thisGate = (Thre_S*)Vec_PtrEntry(vTG, piCount + i + 1);
-        // connect fanins fanouts
-        fscanf( inFile, "%s", buf ); //.threshold
-        for( j = 0; j < Vec_IntEntry(iCount,i) -1; ++j ){
-            fscanf( inFile, "%s", buf );
-            int finId = getIdByName( vTG, buf );
-            Thre_S* finGate = getPtrByName( vTG, buf );
-            Vec_IntPush( thisGate->Fanins, finId );
-            Vec_IntPush( finGate->Fanouts, thisGate->Id );
-        }
-        // parse weight and threshold
-        fscanf( inFile, "%s", buf); // <thisGate->pName>
-        for( j = 0; j < Vec_IntEntry(iCount,i) -1; ++j){
-            fscanf( inFile, "%d", &intBuf );
-            Vec_IntPush( thisGate->weights, intBuf );
-        }
-        fscanf( inFile, "%d", &intBuf );
-        thisGate->thre = intBuf;
+    Vec_PtrForEachEntry( Thre_S *, vTG, thisGate, i )
+        Vec_IntForEachEntry( thisGate->Fanins, NameId, j )
+            Vec_IntPush( ((Thre_S*)Vec_PtrEntry(vTG, NameId))->Fanouts, thisGate->Id );
+    fOk = 1;
+
+finish:
+    Th_TokStop( pTok );
+    Abc_NamStop( pNames );
+    Vec_IntFree( vName2Obj );
+    Vec_PtrFree( vToks );
+    Vec_IntFree( vLines );
+    if ( !fOk ) {
+        DeleteTList( vTG );
+        return NULL;
     }
-   // check stats
-   // printNodeStats(vTG);
-    Vec_IntFree( iCount );
-    Vec_StrFree( moduleName );
     return vTG;
 }
 
 
 Thre_S* newThre(int id, char* name){
-    Thre_S* newGate = ABC_ALLOC( Thre_S, 1);
+    Thre_S* newGate = Th_ObjAlloc();
     newGate->pName  = ABC_ALLOC( char, strlen(name)+1 );
-    newGate->weights = Vec_IntAlloc( 10 );
-    newGate->Fanins  = Vec_IntAlloc( 10 );
-    newGate->Fanouts = Vec_IntAlloc( 10 );
     newGate-> Id = id;
     strcpy( newGate->pName, name );
-    newGate->Type = 0;
-    newGate->Ischoose = 0;
-    newGate->oId   = 0;
-    newGate->nId   = 0;
-    newGate->cost  = 0;
-    newGate->level = 0;
     return newGate;
 }
 int     getIdByName(Vec_Ptr_t* v, char* name)
@@ -233,20 +285,16 @@ void  printNodeStats(Vec_Ptr_t* vTG){
 
 void dumpTh2FileNZ( Vec_Ptr_t * thre_list , char * name )
 {   
-    FILE * pFile;
-    char filename[30];
+    Th_Out_t * pFile;
     Thre_S * tObj;
     Vec_Ptr_t * vPi , * vPo , * vTh; 
-    int i;
-    int j = 0;
-   
-    while (1) {
-        filename[j] = name[j];
-        if ( name[j] == '\0' ) break;
-        else ++j;
-    }
+    int i , j;
 
-    pFile = fopen( name , "w" );
+    pFile = Th_OutStart( name , Th_OutFileMode(name) );
+    if ( pFile == NULL ) {
+        printf( "dumpTh2FileNZ() : cannot open file %s for writing.\n" , name );
+        return;
+    }
     vPi   = Vec_PtrAlloc(16); 
     vPo   = Vec_PtrAlloc(16); 
     vTh   = Vec_PtrAlloc(16); 
@@ -260,48 +308,64 @@ void dumpTh2FileNZ( Vec_Ptr_t * thre_list , char * name )
     }
 
     // write header
-    fprintf( pFile , "Threshold logic gate list written by NZ.\n" );
+    Th_OutStr( pFile , "Threshold logic gate list written by NZ.\n" );
     // write model
-    fprintf( pFile , ".model %s\n" , name );
+    Th_OutStr( pFile , ".model " );
+    Th_OutStr( pFile , name );
+    Th_OutChar( pFile , '\n' );
     // write input
-    fprintf( pFile , ".input");
+    Th_OutStr( pFile , ".input");
     for ( i = 0 ; i < Vec_PtrSize( vPi ) ; ++i ) {
         tObj = Vec_PtrEntry( vPi , i);
-        fprintf( pFile , " %d" , tObj->Id );
+        Th_OutChar( pFile , ' ' );
+        Th_OutInt( pFile , tObj->Id );
     }
-    fprintf( pFile , "\n");
+    Th_OutChar( pFile , '\n' );
     // write output
-    fprintf( pFile , ".output");
+    Th_OutStr( pFile , ".output");
     for ( i = 0 ; i < Vec_PtrSize( vPo ) ; ++i ) {
         tObj = Vec_PtrEntry( vPo , i);
-        fprintf( pFile , " %d" , tObj->Id );
+        Th_OutChar( pFile , ' ' );
+        Th_OutInt( pFile , tObj->Id );
     }
-    fprintf( pFile , "\n");
+    Th_OutChar( pFile , '\n' );
     // write threshold gate
     for ( i = 0 ; i < Vec_PtrSize( vPo ) ; ++i ) {
         tObj = Vec_PtrEntry( vPo , i );
-		  if ( Vec_IntEntry( tObj->Fanins , 0 ) == 0 ) fprintf( pFile , ".threshold %s %d\n" , "CONST1" , tObj->Id );
-		  else fprintf( pFile , ".threshold %d %d\n" , Vec_IntEntry( tObj->Fanins , 0 ) , tObj->Id );
-        fprintf( pFile , "%d %d\n" , Vec_IntEntry( tObj->weights , 0 ) , tObj->thre );
+        Th_OutStr( pFile , ".threshold " );
+        if ( Vec_IntEntry( tObj->Fanins , 0 ) == 0 ) Th_OutStr( pFile , "CONST1" );
+        else Th_OutInt( pFile , Vec_IntEntry( tObj->Fanins , 0 ) );
+        Th_OutChar( pFile , ' ' );
+        Th_OutInt( pFile , tObj->Id );
+        Th_OutChar( pFile , '\n' );
+        Th_OutInt( pFile , Vec_IntEntry( tObj->weights , 0 ) );
+        Th_OutChar( pFile , ' ' );
+        Th_OutInt( pFile , tObj->thre );
+        Th_OutChar( pFile , '\n' );
     }
     for ( i = 0 ; i < Vec_PtrSize( vTh ) ; ++i ) {
         tObj = Vec_PtrEntry( vTh , i );
-        fprintf( pFile , ".threshold" );
+        Th_OutStr( pFile , ".threshold" );
         for ( j = 0 ; j < Vec_IntSize( tObj->Fanins ) ; ++j ) {
-           fprintf( pFile , " %d" , Vec_IntEntry( tObj->Fanins , j ) );
+           Th_OutChar( pFile , ' ' );
+           Th_OutInt( pFile , Vec_IntEntry( tObj->Fanins , j ) );
         }
-        fprintf( pFile , " %d\n" , tObj->Id );
+        Th_OutChar( pFile , ' ' );
+        Th_OutInt( pFile , tObj->Id );
+        Th_OutChar( pFile , '\n' );
         for ( j = 0 ; j < Vec_IntSize( tObj->weights ) ; ++j ) {
-           fprintf( pFile , "%d " , Vec_IntEntry( tObj->weights , j ) );
+           Th_OutInt( pFile , Vec_IntEntry( tObj->weights , j ) );
+           Th_OutChar( pFile , ' ' );
         }
-        fprintf( pFile , "%d\n" , tObj->thre );
+        Th_OutInt( pFile , tObj->thre );
+        Th_OutChar( pFile , '\n' );
     }
 
 	 Vec_PtrFree(vPi);
 	 Vec_PtrFree(vPo);
 	 Vec_PtrFree(vTh);
 
-	 fclose(pFile);
+	 Th_OutStop(pFile);
 }
 
 
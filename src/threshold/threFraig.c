@@ -0,0 +1,488 @@
+/**CFile****************************************************************
+
+  FileName    [threFraig.c]
+
+  SystemName  [ABC: Logic synthesis and verification system.]
+
+  PackageName [threshold.]
+
+  Synopsis    [Functionally reduced TL networks.]
+
+  Author      [ALCom Lab]
+
+  Affiliation [NTU]
+
+  Date        [Oct 16, 2026.]
+
+  Revision    [$Id: abc.c,v 1.00 2005/06/20 00:00:00 alanmi Exp $]
+
+***********************************************************************/
+
+////////////////////////////////////////////////////////////////////////
+///                          INCLUDES                                ///
+////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include "base/abc/abc.h"
+#include "aig/gia/gia.h"
+#include "misc/util/utilTruth.h"
+#include "threshold.h"
+
+////////////////////////////////////////////////////////////////////////
+///                        DECLARATIONS                              ///
+////////////////////////////////////////////////////////////////////////
+
+// sweeping manager ; the SAT variable of an object is its id ,
+// variable 0 standing for the constant as in thre1_CNF()
+typedef struct Th_FrgMan_t_ Th_FrgMan_t;
+struct Th_FrgMan_t_
+{
+    Vec_Ptr_t * TList;
+    Vec_Ptr_t * vPis;      // PIs in the list order
+    int         nWords;    // words of random patterns
+    int         nConfLimit;
+    Th_CnfMan_t*pCnf;
+    // simulation
+    Vec_Wrd_t * vSims;     // nWords random words per object id
+    Vec_Wrd_t * vCexPis;   // nCexWords words per PI : counterexamples so far
+    Vec_Wrd_t * vCexSims;  // nCexWords words per object id
+    int         nCexWords;
+    int         nCexes;
+    // classes of candidates hashed by the normalized random signature
+    int       * pTable;
+    int         nTableSize;
+    Vec_Int_t * vNext;     // next candidate in the bucket
+    // result
+    Vec_Int_t * vRepr;     // representative of a merged object ( -1 : none )
+    Vec_Int_t * vPhase;    // the object equals its representative xor phase
+    // statistics
+    int         nSatCalls;
+    int         nSatProof;
+    int         nSatFail;
+    int         nSatUndec;
+    int         nMerged;
+    int         nConst;
+};
+
+////////////////////////////////////////////////////////////////////////
+///                     FUNCTION DEFINITIONS                         ///
+////////////////////////////////////////////////////////////////////////
+
+static inline word * Th_FrgSim( Th_FrgMan_t * p, int Id )    { return Vec_WrdEntryP( p->vSims, Id * p->nWords );       }
+static inline word * Th_FrgCexSim( Th_FrgMan_t * p, int Id ) { return Vec_WrdEntryP( p->vCexSims, Id * p->nCexWords ); }
+
+/**Function*************************************************************
+
+  Synopsis    [Signatures.]
+
+  Description [The signature of an object is normalized to have the
+               first pattern at 0 , so complemented objects fall into
+               the same class. Th_FrgSimEqual() compares the random and
+               the counterexample simulations of two objects , the
+               second one complemented if fCompl is set.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+static inline int Th_FrgPhase( Th_FrgMan_t * p, int Id )
+{
+    return (int)(Th_FrgSim(p, Id)[0] & 1);
+}
+
+static int Th_FrgHash( Th_FrgMan_t * p, int Id )
+{
+    static int s_Primes[4] = { 12582917, 25165843, 50331653, 100663319 };
+    word * pSim = Th_FrgSim( p, Id ), Mask = Th_FrgPhase(p, Id) ? ~(word)0 : 0;
+    unsigned uHash = 0;
+    int k;
+    for ( k = 0; k < p->nWords; k++ )
+        uHash ^= (unsigned)((pSim[k] ^ Mask) * s_Primes[k & 3] >> 32) ^ (unsigned)((pSim[k] ^ Mask) & 0xFFFFFFFF) * s_Primes[(k+1) & 3];
+    return (int)(uHash % (unsigned)p->nTableSize);
+}
+
+static int Th_FrgSimEqual( Th_FrgMan_t * p, int Id0, int Id1, int fCompl )
+{
+    word Mask = fCompl ? ~(word)0 : 0;
+    word * pSim0 = Th_FrgSim( p, Id0 ), * pSim1 = Th_FrgSim( p, Id1 );
+    int k;
+    for ( k = 0; k < p->nWords; k++ )
+        if ( pSim0[k] != (pSim1[k] ^ Mask) )
+            return 0;
+    if ( p->nCexes == 0 )
+        return 1;
+    pSim0 = Th_FrgCexSim( p, Id0 );
+    pSim1 = Th_FrgCexSim( p, Id1 );
+    for ( k = 0; k < p->nCexWords; k++ )
+        if ( pSim0[k] != (pSim1[k] ^ Mask) )
+            return 0;
+    return 1;
+}
+
+// is the object constant under the patterns so far ; returns its value or -1
+static int Th_FrgSimConst( Th_FrgMan_t * p, int Id )
+{
+    word * pSim = Th_FrgSim( p, Id ), Value = pSim[0] & 1 ? ~(word)0 : 0;
+    int k;
+    for ( k = 0; k < p->nWords; k++ )
+        if ( pSim[k] != Value )
+            return -1;
+    pSim = Th_FrgCexSim( p, Id );
+    for ( k = 0; p->nCexes && k < p->nCexWords; k++ )
+        if ( pSim[k] != Value )
+            return -1;
+    return (int)(Value & 1);
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Refines the candidates with a counterexample.]
+
+  Description [Adds the PI values of the last satisfying assignment as
+               the next counterexample pattern and resimulates all the
+               counterexamples , which separates the pair just refuted
+               and , usually , many others.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+static void Th_FrgAddCex( Th_FrgMan_t * p )
+{
+    Thre_S * tPi;
+    int i, k;
+    if ( p->nCexes == 64 * p->nCexWords ) {
+        Vec_Wrd_t * vNew = Vec_WrdStart( Vec_PtrSize(p->vPis) * (p->nCexWords + 1) );
+        for ( i = 0; i < Vec_PtrSize(p->vPis); i++ )
+            for ( k = 0; k < p->nCexWords; k++ )
+                Vec_WrdWriteEntry( vNew, i * (p->nCexWords + 1) + k, Vec_WrdEntry(p->vCexPis, i * p->nCexWords + k) );
+        Vec_WrdFree( p->vCexPis );
+        p->vCexPis = vNew;
+        p->nCexWords++;
+    }
+    Vec_PtrForEachEntry( Thre_S*, p->vPis, tPi, i )
+        if ( Th_CnfManVarValue( p->pCnf, tPi->Id ) )
+            Abc_TtSetBit( Vec_WrdEntryP(p->vCexPis, i * p->nCexWords), p->nCexes );
+    p->nCexes++;
+    Vec_WrdFree( p->vCexSims );
+    p->vCexSims = Th_SimNtk( p->TList, Vec_WrdArray(p->vCexPis), p->nCexWords );
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Proves that Id0 equals Id1 xor fCompl.]
+
+  Description [Id1 = 0 compares Id0 with the constant fCompl. A proved
+               pair is added to the solver as two binary clauses , which
+               helps the later calls. Returns 1 if proved , 0 if refuted
+               ( the counterexample is added ) and -1 if undecided.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+static int Th_FrgProve( Th_FrgMan_t * p, int Id0, int Id1, int fCompl )
+{
+    int pLits[2], Status, k;
+    p->nSatCalls++;
+    if ( Id1 == 0 ) {
+        pLits[0] = fCompl ? -Id0 : Id0;
+        Status = Th_CnfManSolveAssume( p->pCnf, pLits, 1, p->nConfLimit );
+        if ( Status == 0 ) {
+            pLits[0] = -pLits[0];
+            Th_CnfManAddClause( p->pCnf, pLits, 1 );
+        }
+    }
+    else {
+        // both x0 = 1 , x1 ^ c = 0 and x0 = 0 , x1 ^ c = 1 are unsat
+        for ( k = 0; k < 2; k++ ) {
+            pLits[0] = k ? -Id0 : Id0;
+            pLits[1] = (k ^ fCompl) ? Id1 : -Id1;
+            Status = Th_CnfManSolveAssume( p->pCnf, pLits, 2, p->nConfLimit );
+            if ( Status != 0 )
+                break;
+        }
+        if ( Status == 0 )
+            for ( k = 0; k < 2; k++ ) {
+                pLits[0] = k ? Id0 : -Id0;
+                pLits[1] = (k ^ fCompl) ? -Id1 : Id1;
+                Th_CnfManAddClause( p->pCnf, pLits, 2 );
+            }
+    }
+    if ( Status == 1 ) {
+        p->nSatFail++;
+        Th_FrgAddCex( p );
+        return 0;
+    }
+    if ( Status == -1 ) {
+        p->nSatUndec++;
+        return -1;
+    }
+    p->nSatProof++;
+    return 1;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Finds the representatives.]
+
+  Description [Visits the objects in topological order ; a gate whose
+               signature matches a candidate visited before is proved
+               equivalent to it by SAT , and is otherwise added as a new
+               candidate. PIs are candidates , POs are kept as they are.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+static void Th_FrgSweep( Th_FrgMan_t * p, int fVerbose )
+{
+    Vec_Int_t * vOrder = Th_SimOrder( p->TList );
+    Thre_S * tObj;
+    int i, Id, iRepr, Key, Value, Status, fCompl;
+    Vec_IntForEachEntry( vOrder, Id, i ) {
+        tObj = (Thre_S*)Vec_PtrEntry( p->TList, Id );
+        if ( tObj->Type == Th_Po )
+            continue;
+        if ( tObj->Type == Th_Node ) {
+            // constant gates first
+            Value = Th_FrgSimConst( p, Id );
+            if ( Value >= 0 && Th_FrgProve( p, Id, 0, Value ) == 1 ) {
+                Vec_IntWriteEntry( p->vRepr, Id, 0 );
+                Vec_IntWriteEntry( p->vPhase, Id, Value );
+                p->nConst++;
+                continue;
+            }
+            Key = Th_FrgHash( p, Id );
+            for ( iRepr = p->pTable[Key]; iRepr; iRepr = Vec_IntEntry(p->vNext, iRepr) ) {
+                fCompl = Th_FrgPhase( p, Id ) ^ Th_FrgPhase( p, iRepr );
+                if ( !Th_FrgSimEqual( p, Id, iRepr, fCompl ) )
+                    continue;
+                Status = Th_FrgProve( p, Id, iRepr, fCompl );
+                if ( Status == 1 ) {
+                    Vec_IntWriteEntry( p->vRepr, Id, iRepr );
+                    Vec_IntWriteEntry( p->vPhase, Id, fCompl );
+                    p->nMerged++;
+                    break;
+                }
+            }
+            if ( iRepr )
+                continue;
+        }
+        Key = Th_FrgHash( p, Id );
+        Vec_IntWriteEntry( p->vNext, Id, p->pTable[Key] );
+        p->pTable[Key] = Id;
+    }
+    if ( fVerbose )
+        printf( "\tSAT calls = %d : proved = %d , refuted = %d , undecided = %d ; counterexamples = %d\n",
+            p->nSatCalls, p->nSatProof, p->nSatFail, p->nSatUndec, p->nCexes );
+    Vec_IntFree( vOrder );
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Merges the proved objects into their representatives.]
+
+  Description [A fanin x of weight w replaced by r ^ 1 contributes
+               w - w*r , so the weight becomes -w and the threshold
+               drops by w ; a constant fanin is folded into the
+               threshold , except that a PO is rewired to CONST1. Fanins meeting on the same representative are
+               added up. The gates left without fanouts are deleted.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+static void Th_FrgObjRemoveFanout( Thre_S * tObj, int Id )
+{
+    int k = Vec_IntFind( tObj->Fanouts, Id );
+    assert( k >= 0 );
+    Vec_IntDrop( tObj->Fanouts, k );
+}
+
+static void Th_FrgDeleteDangling_rec( Vec_Ptr_t * TList, Thre_S * tObj )
+{
+    Thre_S * tFanin;
+    int j, finId;
+    if ( tObj->Type != Th_Node || Vec_IntSize(tObj->Fanouts) > 0 )
+        return;
+    Vec_IntForEachEntry( tObj->Fanins, finId, j ) {
+        tFanin = (Thre_S*)Vec_PtrEntry( TList, finId );
+        // the fanin may appear twice
+        if ( Vec_IntFind(tFanin->Fanouts, tObj->Id) >= 0 )
+            Th_FrgObjRemoveFanout( tFanin, tObj->Id );
+    }
+    // the first visit of a fanin met twice may have deleted it
+    Vec_IntForEachEntry( tObj->Fanins, finId, j )
+        if ( Vec_PtrEntry(TList, finId) )
+            Th_FrgDeleteDangling_rec( TList, (Thre_S*)Vec_PtrEntry(TList, finId) );
+    Th_DeleteObj( tObj );
+}
+
+static void Th_FrgPatchObj( Th_FrgMan_t * p, Thre_S * tObj )
+{
+    Thre_S * tFanin;
+    int j, k, finId, iRepr, w, fCompl, Value;
+    for ( j = 0; j < Vec_IntSize(tObj->Fanins); j++ ) {
+        finId = Vec_IntEntry( tObj->Fanins, j );
+        iRepr = Vec_IntEntry( p->vRepr, finId );
+        if ( iRepr == -1 )
+            continue;
+        w      = Vec_IntEntry( tObj->weights, j );
+        fCompl = Vec_IntEntry( p->vPhase, finId );
+        tFanin = (Thre_S*)Vec_PtrEntry( p->TList, finId );
+        if ( Vec_IntFind(tFanin->Fanouts, tObj->Id) >= 0 )
+            Th_FrgObjRemoveFanout( tFanin, tObj->Id );
+        if ( iRepr == 0 ) {
+            // constant fCompl
+            if ( fCompl ) tObj->thre -= w;
+            if ( tObj->Type == Th_Po ) {
+                // a PO keeps one fanin : CONST1 , +1 / 1 or -1 / 0 as in aigThConnectFanin()
+                assert( Vec_IntSize(tObj->Fanins) == 1 );
+                Value = ( 0 >= tObj->thre );
+                Vec_IntWriteEntry( tObj->Fanins, j, 0 );
+                Vec_IntWriteEntry( tObj->weights, j, Value ? 1 : -1 );
+                tObj->thre = Value;
+                Vec_IntPush( ((Thre_S*)Vec_PtrEntry(p->TList, 0))->Fanouts, tObj->Id );
+                continue;
+            }
+            Vec_IntDrop( tObj->Fanins, j );
+            Vec_IntDrop( tObj->weights, j-- );
+            continue;
+        }
+        if ( fCompl ) {
+            tObj->thre -= w;
+            w = -w;
+        }
+        k = Vec_IntFind( tObj->Fanins, iRepr );
+        if ( k >= 0 ) {
+            // the representative is a fanin already
+            Vec_IntAddToEntry( tObj->weights, k, w );
+            Vec_IntDrop( tObj->Fanins, j );
+            Vec_IntDrop( tObj->weights, j );
+            if ( k > j ) k--;
+            j--;
+            if ( Vec_IntEntry(tObj->weights, k) == 0 ) {
+                Th_FrgObjRemoveFanout( (Thre_S*)Vec_PtrEntry(p->TList, iRepr), tObj->Id );
+                Vec_IntDrop( tObj->Fanins, k );
+                Vec_IntDrop( tObj->weights, k );
+                if ( k <= j ) j--;
+            }
+            continue;
+        }
+        Vec_IntWriteEntry( tObj->Fanins, j, iRepr );
+        Vec_IntWriteEntry( tObj->weights, j, w );
+        Vec_IntPush( ((Thre_S*)Vec_PtrEntry(p->TList, iRepr))->Fanouts, tObj->Id );
+    }
+    Th_ObjSumInvalidate( tObj );
+}
+
+static void Th_FrgMerge( Th_FrgMan_t * p )
+{
+    Thre_S * tObj;
+    int i, iRepr;
+    // patch the fanouts of the merged objects
+    Vec_PtrForEachEntry( Thre_S*, p->TList, tObj, i )
+        if ( tObj && (tObj->Type == Th_Node || tObj->Type == Th_Po) && Vec_IntEntry(p->vRepr, i) == -1 )
+            Th_FrgPatchObj( p, tObj );
+    // delete the merged objects and the logic only they used ; a merged
+    // object feeding another merged object goes with the last of them
+    Vec_IntForEachEntry( p->vRepr, iRepr, i )
+        if ( iRepr >= 0 && (tObj = (Thre_S*)Vec_PtrEntry(p->TList, i)) )
+            Th_FrgDeleteDangling_rec( p->TList, tObj );
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Sweeps equivalent gates of a TL network.]
+
+  Description [Gates are put into candidate classes by nWords words of
+               random simulation , the candidates are proved by the SAT
+               solver over the gate encoding Encoding ( nConfLimit
+               conflicts per call ) and each counterexample refines the
+               remaining classes. The proved gates and the gates proved
+               constant are merged in place ; the list then has NULL
+               entries until Th_NtkDfs(). Works on current_TList only ,
+               since Th_DeleteObj() does. Returns the number of merged
+               gates.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+int Th_NtkFraig( Vec_Ptr_t * TList, int nWords, int nConfLimit, int Encoding, int fVerbose )
+{
+    Th_FrgMan_t * p = ABC_CALLOC( Th_FrgMan_t, 1 );
+    Vec_Int_t * vFanVars = Vec_IntAlloc( 16 );
+    Vec_Wrd_t * vPiSims;
+    Thre_S * tObj;
+    int i, j, finId, nMerged;
+    abctime clk = Abc_Clock();
+    assert( TList == current_TList );
+    p->TList      = TList;
+    p->nWords     = nWords;
+    p->nConfLimit = nConfLimit;
+    p->vPis       = Vec_PtrAlloc( 100 );
+    Vec_PtrForEachEntry( Thre_S*, TList, tObj, i )
+        if ( tObj && tObj->Type == Th_Pi )
+            Vec_PtrPush( p->vPis, tObj );
+    // random simulation
+    Gia_ManRandomW( 1 );
+    vPiSims = Vec_WrdAlloc( Vec_PtrSize(p->vPis) * nWords );
+    for ( i = 0; i < Vec_PtrSize(p->vPis) * nWords; i++ )
+        Vec_WrdPush( vPiSims, Gia_ManRandomW(0) );
+    p->vSims     = Th_SimNtk( TList, Vec_WrdArray(vPiSims), nWords );
+    Vec_WrdFree( vPiSims );
+    p->nCexWords = 1;
+    p->vCexPis   = Vec_WrdStart( Vec_PtrSize(p->vPis) );
+    p->vCexSims  = Vec_WrdStart( Vec_PtrSize(TList) );
+    // the formula of the whole network
+    p->pCnf = Th_CnfManStart( NULL, Vec_PtrSize(TList), Encoding, 1 );
+    Vec_PtrForEachEntry( Thre_S*, TList, tObj, i ) {
+        if ( tObj == NULL || tObj->Type == Th_Pi || tObj->Type == Th_CONST1 ) continue;
+        Vec_IntClear( vFanVars );
+        Vec_IntForEachEntry( tObj->Fanins, finId, j )
+            Vec_IntPush( vFanVars, ((Thre_S*)Vec_PtrEntry(TList, finId))->Type == Th_CONST1 ? 0 : finId );
+        Th_CnfWriteObj( p->pCnf, tObj, vFanVars, tObj->Id );
+    }
+    Vec_IntFree( vFanVars );
+    p->nTableSize = Abc_PrimeCudd( Vec_PtrSize(TList) + 1 );
+    p->pTable     = ABC_CALLOC( int, p->nTableSize );
+    p->vNext      = Vec_IntStart( Vec_PtrSize(TList) );
+    p->vRepr      = Vec_IntStartFull( Vec_PtrSize(TList) );
+    p->vPhase     = Vec_IntStart( Vec_PtrSize(TList) );
+
+    Th_FrgSweep( p, fVerbose );
+    Th_FrgMerge( p );
+    nMerged = p->nMerged + p->nConst;
+    printf( "\tSwept %d gates : %d merged , %d constant.  ", nMerged, p->nMerged, p->nConst );
+    Abc_PrintTime( 1, "Time", Abc_Clock() - clk );
+
+    Th_CnfManStop( p->pCnf );
+    Vec_PtrFree( p->vPis );
+    Vec_WrdFree( p->vSims );
+    Vec_WrdFree( p->vCexPis );
+    Vec_WrdFree( p->vCexSims );
+    Vec_IntFree( p->vNext );
+    Vec_IntFree( p->vRepr );
+    Vec_IntFree( p->vPhase );
+    ABC_FREE( p->pTable );
+    ABC_FREE( p );
+    return nMerged;
+}
+
+////////////////////////////////////////////////////////////////////////
+///                       END OF FILE                                ///
+////////////////////////////////////////////////////////////////////////
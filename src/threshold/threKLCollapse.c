@@ -30,6 +30,7 @@
 #include "threshold.h"
 #include "bdd/extrab/extraBdd.h"
 #include "misc/extra/extra.h"
+#include "misc/vec/vecQue.h"
 
 #define CHECK
 //#define PROFILE
@@ -40,21 +41,23 @@
 
 // extern functions
 extern Pair_S*    Th_CalKLIf                  ( const Thre_S * , const Thre_S * , int , int , int );
-extern Pair_S*    Th_CalKLDP                  ( const Thre_S * , const Thre_S * , int , int , int );
+extern Pair_S*    Th_CalKLDP                  ( const Thre_S * , const Thre_S * , int , int , int , Vec_Wrd_t * );
 extern int        Th_ObjIsConst               ( const Thre_S * );
 extern Thre_S*    Th_GetObjById               ( Vec_Ptr_t * , int );
-extern int        Th_Check2FoutCollapse       ( const Thre_S * , const Thre_S * , int );
-extern int        Th_CheckMultiFoutCollapse   ( const Thre_S * , int );
+extern int        Th_Check2FoutCollapse       ( const Thre_S * , const Thre_S * , int , Vec_Wrd_t * , Vec_Int_t * );
+extern int        Th_CheckMultiFoutCollapse   ( const Thre_S * , int , int , Vec_Wrd_t * , Vec_Int_t * );
 extern int        Th_ObjFanoutFaninNum        ( const Thre_S * , const Thre_S * );
 // main functions
-void       Th_CollapseNtk         ( Vec_Ptr_t * , int , int );
+void       Th_CollapseNtk         ( Vec_Ptr_t * , int , int , int );
+void       Th_CollapseNtkWorklist ( Vec_Ptr_t * , int , int , int );
+void       Th_CollapseNtkPriority ( Vec_Ptr_t * , int , int );
 // main helper functions for collapse
-int        Th_CollapseNodes       ( const Thre_S * , int , int );
-int        Th_CalKLCollapse       ( const Thre_S * );
-void       Th_CollapsePair        ( const Thre_S * , const Thre_S * , int );
+int        Th_CollapseNodes       ( const Thre_S * , int , int , int , Vec_Wrd_t * , Vec_Int_t * );
+int        Th_CalKLCollapse       ( const Thre_S * , Vec_Wrd_t * , Vec_Int_t * );
+void       Th_CollapsePair        ( const Thre_S * , const Thre_S * , int , Vec_Wrd_t * , Vec_Int_t * );
 Pair_S*    Th_CalKL               ( const Thre_S * , const Thre_S * , int , int , int );
-Thre_S*    Th_KLCollapse          ( const Thre_S * , const Thre_S * , const Pair_S * , int , int );
-Thre_S*    Th_KLCreateClpObj      ( const Thre_S * , const Thre_S * , const Pair_S * , int , int );
+Thre_S*    Th_KLCollapse          ( const Thre_S * , const Thre_S * , const Pair_S * , int , int , Vec_Int_t * );
+Thre_S*    Th_KLCreateClpObj      ( const Thre_S * , const Thre_S * , const Pair_S * , int , int , Vec_Int_t * );
 int        Th_ObjIsFanin          ( const Thre_S * , int );
 void       Th_KLPatchFanio        ( const Thre_S * , const Thre_S * , const Thre_S * );
 // dumper functions
@@ -72,9 +75,26 @@ Thre_S*    Th_CopyObj             ( const Thre_S* );
 int        MaxF                   ( Vec_Int_t * , int );
 int        MinF                   ( Vec_Int_t * , int );
 int        Th_ObjNormalCheck      ( const Thre_S * );
+// fanin/fanout position index
+void       Th_NtkBuildFanioIndex  ( Vec_Ptr_t * );
+void       Th_ObjFreeFanioIndex   ( Thre_S * );
+void       Th_ObjAddFanin         ( Thre_S * , Thre_S * );
+void       Th_ObjRemoveFanout     ( Thre_S * , int );
+void       Th_ObjFaninMapStart    ( Vec_Int_t * , const Thre_S * );
+void       Th_ObjFaninMapStop     ( Vec_Int_t * , const Thre_S * );
+int        Th_ObjFaninMapFind     ( Vec_Int_t * , int );
 void       Th_DeleteClpObj        ( Thre_S * , int );
 void       Th_DeleteClpObj_tcad   ( Thre_S * );
 int        Th_NtkMaxFanout        ();
+// worklist helpers
+void       Th_WorklistPush        ( Vec_Int_t * , Vec_Int_t * , int );
+void       Th_WorklistPushFanio   ( Vec_Ptr_t * , Vec_Int_t * , Vec_Int_t * , Thre_S * );
+int        Th_WorklistIsCand      ( Vec_Ptr_t * , Thre_S * , int );
+void       Th_WorklistClearFailed ( Vec_Ptr_t * , Vec_Int_t * , Thre_S * );
+// priority helpers
+void       Th_PriorityPush        ( Vec_Wrd_t * , Vec_Wrd_t * , Thre_S * , int );
+void       Th_PriorityHeapPush    ( Vec_Wrd_t * , word );
+word       Th_PriorityHeapPop     ( Vec_Wrd_t * );
 // Dfs helper
 void       Th_NtkDfs              ();
 void       Th_NtkDfs_rec          ( Thre_S * , Vec_Ptr_t * );
@@ -136,19 +156,9 @@ Th_DumpObj( const Thre_S * tObj )
 Thre_S* 
 Th_CreateObjNoInsert( Th_Gate_Type Type )
 {
-   Thre_S * tObj    = ABC_ALLOC( Thre_S , 1 );
-	tObj->thre       = 0;
+   Thre_S * tObj    = Th_ObjAlloc();
 	tObj->Type       = Type;
-	tObj->Ischoose   = 0;
    tObj->Id         = -1; // no insert into TList
-	tObj->oId        = 0;
-	tObj->nId        = 0;
-	tObj->cost       = 0;
-	tObj->level      = 0;
-	tObj->pName      = NULL;
-	tObj->weights    = Vec_IntAlloc(16);
-	tObj->Fanins     = Vec_IntAlloc(16);
-	tObj->Fanouts    = Vec_IntAlloc(16);
 
 	return tObj;
 }
@@ -156,22 +166,14 @@ Th_CreateObjNoInsert( Th_Gate_Type Type )
 void 
 Th_DeleteObjNoInsert( Thre_S * tObj )
 {
-	if ( tObj->pName ) ABC_FREE( tObj->pName );
-   Vec_IntFree( tObj->weights );
-   Vec_IntFree( tObj->Fanins );
-   Vec_IntFree( tObj->Fanouts );
-   ABC_FREE( tObj );
+   Th_ObjRecycle( tObj );
 }
 
 void 
 Th_DeleteNode( Thre_S * tObj )
 {  
-   if ( tObj->pName ) ABC_FREE( tObj->pName );
-   Vec_IntFree( tObj->weights );
-   Vec_IntFree( tObj->Fanins  );
-   Vec_IntFree( tObj->Fanouts );
    Vec_PtrWriteEntry( current_TList , tObj->Id , NULL );
-   ABC_FREE( tObj );
+   Th_ObjRecycle( tObj );
 }
 
 /**Function*************************************************************
@@ -187,7 +189,7 @@ Th_DeleteNode( Thre_S * tObj )
 ***********************************************************************/
 
 int 
-Th_CollapseNodes( const Thre_S * tObj2 , int nFanin , int fOutBound )
+Th_CollapseNodes( const Thre_S * tObj2 , int nFanin , int fOutBound , int nLevelBound , Vec_Wrd_t * vRow , Vec_Int_t * vFaninMap )
 {
    assert( tObj2 );
 	assert( nFanin >= 0 && nFanin < Vec_IntSize(tObj2->Fanins) );
@@ -205,18 +207,18 @@ Th_CollapseNodes( const Thre_S * tObj2 , int nFanin , int fOutBound )
 	if ( Vec_IntSize(tObj1->Fanouts) > 1 ) {
 	   ++thProfiler.numMultiFout;
       //if ( Vec_IntSize(tObj1->Fanouts) > 2 && Th_CheckMultiFoutCollapse(tObj1) ) ++thProfiler.numMultiFoutOk;
-      if ( Th_CheckMultiFoutCollapse(tObj1 , 10) ) ++thProfiler.numMultiFoutOk;
+      if ( Th_CheckMultiFoutCollapse(tObj1 , 10 , 0 , vRow , vFaninMap) ) ++thProfiler.numMultiFoutOk;
 		/*if ( Vec_IntSize(tObj1->Fanouts) == 2 ) {
 			++thProfiler.numTwoFout;
-			if ( Th_Check2FoutCollapse( tObj1 , tObj2 , nFanin ) ) ++thProfiler.numTwoFoutOk;
+			if ( Th_Check2FoutCollapse( tObj1 , tObj2 , nFanin , vRow , vFaninMap ) ) ++thProfiler.numTwoFoutOk;
 		}*/
 		return 0;
 	}
 	else return Th_CalKLMerge( tObj1 , tObj2 , nFanin );
 #else
-	if ( tObj1->Type != Th_Node || !Th_CheckMultiFoutCollapse( tObj1 , fOutBound ) )
+	if ( tObj1->Type != Th_Node || !Th_CheckMultiFoutCollapse( tObj1 , fOutBound , nLevelBound , vRow , vFaninMap ) )
 		return 0;
-	else return Th_CalKLCollapse( tObj1 );
+	else return Th_CalKLCollapse( tObj1 , vRow , vFaninMap );
 #endif
 }
 
@@ -254,10 +256,9 @@ Th_CopyList( Vec_Ptr_t * tList )
 Thre_S* 
 Th_CopyObj( const Thre_S * tObj )
 {
-   int Entry , i;
 	Thre_S * tObjCopy;
    
-	tObjCopy             = ABC_ALLOC( Thre_S , 1 );
+	tObjCopy             = Th_ObjAlloc();
 	tObjCopy->thre       = tObj->thre;
 	tObjCopy->Type       = tObj->Type;
 	tObjCopy->Ischoose   = tObj->Ischoose;
@@ -272,22 +273,10 @@ Th_CopyObj( const Thre_S * tObj )
       tObjCopy->pName = malloc(strlen(tObj->pName) + 1);
       strcpy(tObjCopy->pName, tObj->pName);
    }
-	// copy weights, fanins, and fanouts
-   tObjCopy->weights    = Vec_IntAlloc(16);
-	tObjCopy->Fanins     = Vec_IntAlloc(16);
-	tObjCopy->Fanouts    = Vec_IntAlloc(16);
-	Vec_IntForEachEntry( tObj->weights , Entry , i )
-	{
-		Vec_IntPush( tObjCopy->weights , Entry );
-	}
-	Vec_IntForEachEntry( tObj->Fanins , Entry , i )
-	{
-		Vec_IntPush( tObjCopy->Fanins , Entry );
-	}
-	Vec_IntForEachEntry( tObj->Fanouts , Entry , i )
-	{
-		Vec_IntPush( tObjCopy->Fanouts , Entry );
-	}
+	// copy weights, fanins, and fanouts (collapse index is not copied)
+	Vec_IntAppend( tObjCopy->weights , tObj->weights );
+	Vec_IntAppend( tObjCopy->Fanins  , tObj->Fanins  );
+	Vec_IntAppend( tObjCopy->Fanouts , tObj->Fanouts );
 	return tObjCopy;
 }
 
@@ -302,6 +291,7 @@ Th_InvertObj( const Thre_S * tObj )
 		Vec_IntWriteEntry( tObjInvert->weights , i , -Entry );
 	// invert threshold
 	tObjInvert->thre = 1 - tObjInvert->thre;
+	Th_ObjSumInvalidate( tObjInvert );
    return tObjInvert;
 }
 
@@ -327,6 +317,43 @@ MinF(Vec_Int_t * weights , int nFanin )
 	return sum;
 }
 
+/**Function*************************************************************
+
+  Synopsis    [Compute the cached weight sums of tObj.]
+
+  Description [See Th_ObjMaxF()/Th_ObjSumPos() in threshold.h. Called
+               from these const getters , so it writes to tObj even for
+               read-only callers ; use it from the main thread only.]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+void
+Th_ObjSumCompute( Thre_S * tObj )
+{
+	int Entry , i , pos , neg;
+	if ( tObj->vSumPos == NULL ) {
+		tObj->vSumPos = Th_VecIntFetch();
+		tObj->vSumNeg = Th_VecIntFetch();
+	}
+	Vec_IntClear( tObj->vSumPos );
+	Vec_IntClear( tObj->vSumNeg );
+	pos = neg = 0;
+	Vec_IntPush( tObj->vSumPos , pos );
+	Vec_IntPush( tObj->vSumNeg , neg );
+	Vec_IntForEachEntry( tObj->weights , Entry , i )
+	{
+		if ( Entry > 0 ) pos += Entry;
+		else             neg += Entry;
+		Vec_IntPush( tObj->vSumPos , pos );
+		Vec_IntPush( tObj->vSumNeg , neg );
+	}
+	tObj->fSumValid = 1;
+}
+
 void 
 Th_UnmarkAllNode()
 {
@@ -378,11 +405,11 @@ Th_CalKL( const Thre_S * tObj1 , const Thre_S * tObj2 , int nFanin , int w , int
 	pair->IntL    = 0;
 	T1            = tObj1->thre;
 	T2            = (fInvert) ? (tObj2->thre + w) : (tObj2->thre);
-	maxf2         = MaxF( tObj2->weights , nFanin );
-	minf2         = MinF( tObj2->weights , nFanin );
-	n1            = MaxF( tObj1->weights , Vec_IntSize( tObj1->weights ) ) - T1; 
+	maxf2         = Th_ObjMaxF( tObj2 , nFanin );
+	minf2         = Th_ObjMinF( tObj2 , nFanin );
+	n1            = Th_ObjMaxF( tObj1 , -1 ) - T1; 
 	n2            = w - 1;
-	n3            = T1 - MinF( tObj1->weights , Vec_IntSize( tObj1->weights ) );
+	n3            = T1 - Th_ObjMinF( tObj1 , -1 );
 	n4            = w;
 	cond1         = 0;
 	cond2         = 0;
@@ -470,38 +497,41 @@ Th_CalKL( const Thre_S * tObj1 , const Thre_S * tObj2 , int nFanin , int w , int
 ***********************************************************************/
 
 Thre_S* 
-Th_KLCollapse( const Thre_S * tObj1 , const Thre_S * tObj2 , const Pair_S * pair , int w , int fInvert )
+Th_KLCollapse( const Thre_S * tObj1 , const Thre_S * tObj2 , const Pair_S * pair , int w , int fInvert , Vec_Int_t * vFaninMap )
 {	
 	Thre_S * tObjMerge;
 
-	tObjMerge = Th_KLCreateClpObj( tObj1 , tObj2 , pair , w , fInvert );
+	tObjMerge = Th_KLCreateClpObj( tObj1 , tObj2 , pair , w , fInvert , vFaninMap );
    Th_KLPatchFanio( tObj1 , tObj2 , tObjMerge );
 	return tObjMerge;
 }
 
 Thre_S*
 Th_KLCreateClpObj( const Thre_S * tObj1 , const Thre_S * tObj2 , 
-		             const Pair_S * pair , int w , int fInvert )
+		             const Pair_S * pair , int w , int fInvert , Vec_Int_t * vFaninMap )
 {
 	Thre_S * tObjMerge;
-	int T1 , T2 , fMark , Entry , i;
+	int T1 , T2 , K1 , fMark , Entry , i;
    
-	T1 = tObj1->thre;
+	// tObj1 is read inverted (weights negated) if fInvert
+	T1 = (fInvert) ? (1 - tObj1->thre) : (tObj1->thre);
 	T2 = (fInvert) ? (tObj2->thre + w) : (tObj2->thre);
+	K1 = (fInvert) ? -pair->IntK : pair->IntK;
 
 	tObjMerge = Th_CreateObj( current_TList , Th_Node );
 	tObjMerge->thre = pair->IntK * T1 + pair->IntL * (T2 - w);
 	// set merged weights and fanins , tObj1 part
 	Vec_IntForEachEntry( tObj1->weights , Entry , i )
-		Vec_IntPush( tObjMerge->weights , pair->IntK * Entry );
+		Vec_IntPush( tObjMerge->weights , K1 * Entry );
 	Vec_IntForEachEntry( tObj1->Fanins , Entry , i )
 		Vec_IntPush( tObjMerge->Fanins , Entry );
 
 	// set merged weights and fanins , tObj2 part , take care of joint fanins
+	Th_ObjFaninMapStart( vFaninMap , tObj1 );
 	Vec_IntForEachEntry( tObj2->Fanins , Entry , i )
 	{
 		if ( Entry == tObj1->Id ) continue;
-      fMark = Th_ObjIsFanin( tObj1 , Entry );
+      fMark = Th_ObjFaninMapFind( vFaninMap , Entry );
 		if ( fMark > -1 ) { // joint fanin , sum weights up
 		   Vec_IntWriteEntry( tObjMerge->weights , fMark , Vec_IntEntry( tObjMerge->weights , fMark ) + 
 					                                          pair->IntL * Vec_IntEntry( tObj2->weights , i ));
@@ -511,6 +541,7 @@ Th_KLCreateClpObj( const Thre_S * tObj1 , const Thre_S * tObj2 ,
          Vec_IntPush( tObjMerge->Fanins  , Entry );
 		}
    }
+	Th_ObjFaninMapStop( vFaninMap , tObj1 );
 	// connect fanouts , tObjMerge part
 	Vec_IntForEachEntry( tObj2->Fanouts , Entry , i )
 		Vec_IntPush( tObjMerge->Fanouts , Entry );
@@ -532,8 +563,11 @@ Th_ObjIsFanin( const Thre_S * tObj , int faninId )
 void
 Th_KLPatchFanio( const Thre_S * tObj1 , const Thre_S * tObj2 , const Thre_S * tObjMerge )
 {
-	Thre_S * tObjFanin , * tObjFanout;
+	Thre_S * tObjFanin , * tObjFanout , * tObjM;
 	int nFanin , Entry , i;
+	tObjM = (Thre_S*)tObjMerge;
+	tObjM->FaninPos  = Th_VecIntFetch();
+	tObjM->FanoutPos = Th_VecIntFetch();
 	// connect fanins , tObj2 fanout part
 	Vec_IntForEachEntry( tObj2->Fanouts , Entry , i )
 	{
@@ -541,8 +575,11 @@ Th_KLPatchFanio( const Thre_S * tObj1 , const Thre_S * tObj2 , const Thre_S * tO
 	   assert(tObjFanout);
 		// Unmark a node if some of its fanins are merged
 		if ( tObjFanout->nId == globalRef ) --(tObjFanout->nId);
-	   nFanin = Th_ObjFanoutFaninNum( tObj2 , tObjFanout );
-	   Vec_IntWriteEntry( tObjFanout->Fanins , nFanin , tObjMerge->Id );
+	   nFanin = Vec_IntEntry( tObj2->FanoutPos , i );
+	   assert( Vec_IntEntry( tObjFanout->Fanins , nFanin ) == tObj2->Id );
+	   Vec_IntWriteEntry( tObjFanout->Fanins   , nFanin , tObjMerge->Id );
+	   Vec_IntWriteEntry( tObjFanout->FaninPos , nFanin , i );
+	   Vec_IntPush( tObjM->FanoutPos , nFanin );
 	   assert( Vec_IntSize(tObjFanout->Fanins) == Vec_IntSize(tObjFanout->weights) );
 	}
 	// connect fanouts , tObj1 fanin part 
@@ -550,8 +587,12 @@ Th_KLPatchFanio( const Thre_S * tObj1 , const Thre_S * tObj2 , const Thre_S * tO
 	{
       tObjFanin = Th_GetObjById( current_TList , Entry );
 	   assert(tObjFanin);
-		Vec_IntRemove( tObjFanin->Fanouts , tObj1->Id );
-		Vec_IntPush  ( tObjFanin->Fanouts , tObjMerge->Id );
+		// tObj1 is removed once , when collapsed into its first fanout
+		if ( Vec_IntEntry( tObj1->FaninPos , i ) > -1 ) {
+			Th_ObjRemoveFanout( tObjFanin , Vec_IntEntry( tObj1->FaninPos , i ) );
+			Vec_IntWriteEntry( tObj1->FaninPos , i , -1 );
+		}
+		Th_ObjAddFanin( tObjM , tObjFanin );
 	}
 	// connect fanouts , tObj2 fanin part 
 	Vec_IntForEachEntry( tObj2->Fanins , Entry , i )
@@ -559,12 +600,160 @@ Th_KLPatchFanio( const Thre_S * tObj1 , const Thre_S * tObj2 , const Thre_S * tO
 	   if ( Entry == tObj1->Id ) continue;
       tObjFanin = Th_GetObjById( current_TList , Entry );
 	   assert(tObjFanin);
-		Vec_IntRemove( tObjFanin->Fanouts , tObj2->Id );
-		Vec_IntPushUnique  ( tObjFanin->Fanouts , tObjMerge->Id );
+		Th_ObjRemoveFanout( tObjFanin , Vec_IntEntry( tObj2->FaninPos , i ) );
+		Vec_IntWriteEntry( tObj2->FaninPos , i , -1 );
+		// non-joint fanins follow in order , joint ones are already connected
+		if ( Vec_IntSize( tObjM->FaninPos ) < Vec_IntSize( tObjM->Fanins ) &&
+		     Vec_IntEntry( tObjM->Fanins , Vec_IntSize( tObjM->FaninPos ) ) == Entry )
+			Th_ObjAddFanin( tObjM , tObjFanin );
 	}
+	assert( Vec_IntSize(tObjMerge->FaninPos) == Vec_IntSize(tObjMerge->Fanins) );
 	assert( Vec_IntSize(tObjMerge->Fanins) == Vec_IntSize(tObjMerge->weights) );
 }
 
+/**Function*************************************************************
+
+  Synopsis    [Fanin/fanout position index.]
+
+  Description [Each edge stores its position at the other end, so that
+               the fanin number of a fanout and the removal of a fanout
+               are O(1). Th_NtkBuildFanioIndex() builds the index in
+               linear time at the beginning of collapsing; it is kept up
+               to date by Th_KLPatchFanio() only, other passes do not
+               maintain it. Fanouts are removed by swapping with the last
+               one, so the fanout order is not preserved.]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+void
+Th_NtkBuildFanioIndex( Vec_Ptr_t * TList )
+{
+	Vec_Int_t * vMap;
+	Thre_S * tObj , * tObjFanin , * tObjFanout;
+	int i , j , k , Entry;
+
+	// collect (fanout , fanin number) pairs of each node in FanoutPos
+	Vec_PtrForEachEntry( Thre_S* , TList , tObj , i )
+	{
+		if ( !tObj ) continue;
+		Th_ObjFreeFanioIndex( tObj );
+		tObj->FaninPos  = Th_VecIntFetch();
+		tObj->FanoutPos = Th_VecIntFetch();
+		Vec_IntFill( tObj->FaninPos , Vec_IntSize( tObj->Fanins ) , -1 );
+	}
+	Vec_PtrForEachEntry( Thre_S* , TList , tObj , i )
+	{
+		if ( !tObj ) continue;
+		Vec_IntForEachEntry( tObj->Fanins , Entry , j )
+		{
+			tObjFanin = Th_GetObjById( TList , Entry );
+			assert( tObjFanin );
+			Vec_IntPushTwo( tObjFanin->FanoutPos , tObj->Id , j );
+		}
+	}
+	// match the pairs against the fanout order
+	vMap = Vec_IntStartFull( Vec_PtrSize( TList ) );
+	Vec_PtrForEachEntry( Thre_S* , TList , tObj , i )
+	{
+		if ( !tObj ) continue;
+		assert( Vec_IntSize( tObj->FanoutPos ) == 2 * Vec_IntSize( tObj->Fanouts ) );
+		for ( k = 0 ; k < Vec_IntSize( tObj->FanoutPos ) ; k += 2 )
+			Vec_IntWriteEntry( vMap , Vec_IntEntry( tObj->FanoutPos , k ) , Vec_IntEntry( tObj->FanoutPos , k+1 ) );
+		Vec_IntClear( tObj->FanoutPos );
+		Vec_IntForEachEntry( tObj->Fanouts , Entry , k )
+		{
+			j = Vec_IntEntry( vMap , Entry );
+			assert( j > -1 );
+			tObjFanout = Th_GetObjById( TList , Entry );
+			Vec_IntPush( tObj->FanoutPos , j );
+			Vec_IntWriteEntry( tObjFanout->FaninPos , j , k );
+		}
+		Vec_IntForEachEntry( tObj->Fanouts , Entry , k )
+			Vec_IntWriteEntry( vMap , Entry , -1 );
+	}
+	Vec_IntFree( vMap );
+}
+
+void
+Th_ObjFreeFanioIndex( Thre_S * tObj )
+{
+	Th_VecIntRecycle( tObj->FaninPos  );
+	Th_VecIntRecycle( tObj->FanoutPos );
+	tObj->FaninPos = tObj->FanoutPos = NULL;
+}
+
+void
+Th_ObjAddFanin( Thre_S * tObj , Thre_S * tObjFanin )
+{
+	// tObjFanin is at the next unindexed position of tObj->Fanins
+	int nFanin = Vec_IntSize( tObj->FaninPos );
+	assert( Vec_IntEntry( tObj->Fanins , nFanin ) == tObjFanin->Id );
+	Vec_IntPush( tObj->FaninPos       , Vec_IntSize( tObjFanin->Fanouts ) );
+	Vec_IntPush( tObjFanin->Fanouts   , tObj->Id );
+	Vec_IntPush( tObjFanin->FanoutPos , nFanin );
+}
+
+void
+Th_ObjRemoveFanout( Thre_S * tObj , int k )
+{
+	Thre_S * tObjFanout;
+	int last = Vec_IntSize( tObj->Fanouts ) - 1;
+	assert( k >= 0 && k <= last );
+	if ( k < last ) { // move the last fanout into the hole
+		Vec_IntWriteEntry( tObj->Fanouts   , k , Vec_IntEntry( tObj->Fanouts   , last ) );
+		Vec_IntWriteEntry( tObj->FanoutPos , k , Vec_IntEntry( tObj->FanoutPos , last ) );
+		tObjFanout = Th_GetObjById( current_TList , Vec_IntEntry( tObj->Fanouts , k ) );
+		Vec_IntWriteEntry( tObjFanout->FaninPos , Vec_IntEntry( tObj->FanoutPos , k ) , k );
+	}
+	Vec_IntShrink( tObj->Fanouts   , last );
+	Vec_IntShrink( tObj->FanoutPos , last );
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Scratch map from fanin id to fanin number.]
+
+  Description [Replaces Th_ObjIsFanin() in the merge loops: start the map
+               on one node, look up the fanins of the other, then stop it
+               (which clears only the entries set). vFaninMap maps a fanin
+               id to its fanin number + 1 and to 0 otherwise ; it is owned
+               by the collapse driver and grows with the ids it is given.]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+void
+Th_ObjFaninMapStart( Vec_Int_t * vFaninMap , const Thre_S * tObj )
+{
+	int Entry , i;
+	Vec_IntForEachEntry( tObj->Fanins , Entry , i )
+	{
+		Vec_IntFillExtra( vFaninMap , Entry + 1 , 0 );
+		Vec_IntWriteEntry( vFaninMap , Entry , i + 1 );
+	}
+}
+
+void
+Th_ObjFaninMapStop( Vec_Int_t * vFaninMap , const Thre_S * tObj )
+{
+	int Entry , i;
+	Vec_IntForEachEntry( tObj->Fanins , Entry , i )
+		Vec_IntWriteEntry( vFaninMap , Entry , 0 );
+}
+
+int
+Th_ObjFaninMapFind( Vec_Int_t * vFaninMap , int Id )
+{
+	return Id < Vec_IntSize( vFaninMap ) ? Vec_IntEntry( vFaninMap , Id ) - 1 : -1;
+}
+
 /**Function*************************************************************
 
   Synopsis    [Th_CalKLCollapse(interface); Th_CollapsePair(internal).]
@@ -578,23 +767,24 @@ Th_KLPatchFanio( const Thre_S * tObj1 , const Thre_S * tObj2 , const Thre_S * tO
 ***********************************************************************/
 
 int 
-Th_CalKLCollapse( const Thre_S * tObj1 )
+Th_CalKLCollapse( const Thre_S * tObj1 , Vec_Wrd_t * vRow , Vec_Int_t * vFaninMap )
 {
 	Thre_S * tObj2;
 	int nFanin , Entry , i;
+	assert( Th_ObjHasFanioIndex( tObj1 ) );
    Vec_IntForEachEntry( tObj1->Fanouts , Entry , i )
 	{
       tObj2  = Th_GetObjById( current_TList , Entry );
 		assert( tObj2 && tObj2->Type == Th_Node );
-	   nFanin = Th_ObjFanoutFaninNum( tObj1 , tObj2 );
-		assert( Th_CheckPairCollapse( tObj1 , tObj2 , nFanin ) );
-		Th_CollapsePair( tObj1 , tObj2 , nFanin );
+	   nFanin = Vec_IntEntry( tObj1->FanoutPos , i );
+		assert( Th_CheckPairCollapse( tObj1 , tObj2 , nFanin , vRow , vFaninMap ) );
+		Th_CollapsePair( tObj1 , tObj2 , nFanin , vRow , vFaninMap );
 	}
 	return 1;
 }
 
 void
-Th_CollapsePair( const Thre_S * tObj1 , const Thre_S * tObj2 , int nFanin )
+Th_CollapsePair( const Thre_S * tObj1 , const Thre_S * tObj2 , int nFanin , Vec_Wrd_t * vRow , Vec_Int_t * vFaninMap )
 {
 	Pair_S * pair;
 	Thre_S * tObjMerge;
@@ -604,18 +794,20 @@ Th_CollapsePair( const Thre_S * tObj1 , const Thre_S * tObj2 , int nFanin )
 	w             = Vec_IntEntry( tObj2->weights , nFanin );
 	fInvert       = 0;
 	
+	// negative connecting weight : tObj1 is read in inverted polarity , no copy
 	if ( w < 0 ) {
-		tObj1        = Th_InvertObj(tObj1);
 		w           *= -1;
       fInvert      = 1;
 	}
-	pair = Th_CalKLIf( tObj1 , tObj2 , nFanin , w , fInvert );
-	//pair = Th_CalKLDP( tObj1 , tObj2 , nFanin , w , fInvert );
+	pair = thKLDP ? Th_CalKLDP( tObj1 , tObj2 , nFanin , w , fInvert , vRow ):
+	                Th_CalKLIf( tObj1 , tObj2 , nFanin , w , fInvert );
    
 	assert( pair->IntK > 0 && pair->IntL > 0 );
-	tObjMerge = Th_KLCollapse( tObj1 , tObj2 , pair , w , fInvert );
+	tObjMerge = Th_KLCreateClpObj( tObj1 , tObj2 , pair , w , fInvert , vFaninMap );
+	// check the step before the pair is patched away
+	if ( thClpCheck ) Th_CollapseCheck( tObj1 , tObj2 , tObjMerge );
+   Th_KLPatchFanio( tObj1 , tObj2 , tObjMerge );
    
-   if ( fInvert ) Th_DeleteObjNoInsert( tObj1 ); // delete the inverted object created in this function
 	ABC_FREE(pair);
 	if (tObjMerge) assert( Vec_IntSize(tObjMerge->Fanins) == Vec_IntSize(tObjMerge->weights) );
 }
@@ -633,10 +825,15 @@ Th_CollapsePair( const Thre_S * tObj1 , const Thre_S * tObj2 , int nFanin )
 ***********************************************************************/
 
 void
-Th_CollapseNtk_tcad( Vec_Ptr_t * TList , int fIterative , int fOutBound )
+Th_CollapseNtk_tcad( Vec_Ptr_t * TList , int fIterative , int fOutBound , int nLevelBound )
 {
+   Vec_Wrd_t * vRow = Vec_WrdAlloc( 16 ); // subset sum scratch of Th_subSumSolveBits()
+   Vec_Int_t * vFaninMap = Vec_IntStart( Vec_PtrSize( TList ) ); // scratch of Th_ObjFaninMapStart()
+   Vec_Int_t * vLevelQueue  = Vec_IntAlloc( 100 ); // scratch of Th_NtkLevelUpdate()
+   Vec_Int_t * vLevelQueued = Vec_IntAlloc( 100 );
    Thre_S * tObj;
-	int i , sizeBeforeIter , sizeBeforeCollapse;
+	int i , nObjs , sizeBeforeIter , sizeBeforeCollapse;
+   Th_NtkBuildFanioIndex( TList );
    do {
 	   Th_UnmarkAllNode();
       sizeBeforeIter = Vec_PtrSize( TList );
@@ -648,9 +845,11 @@ Th_CollapseNtk_tcad( Vec_Ptr_t * TList , int fIterative , int fOutBound )
             if ( tObj->Type != Th_Node )    continue; // PI/PO/CONST
             if ( tObj->nId == globalRef )   continue; // black node : those who have nId = 1
 			   if ( !Th_ObjNormalCheck(tObj) ) continue; // Abnormal node : const or 0-weight, collect and clean
-	         if ( Th_CheckMultiFoutCollapse( tObj , fOutBound ) ) {
-               Th_CalKLCollapse( tObj );
+	         if ( Th_CheckMultiFoutCollapse( tObj , fOutBound , nLevelBound , vRow , vFaninMap ) ) {
+               nObjs = Vec_PtrSize( TList );
+               Th_CalKLCollapse( tObj , vRow , vFaninMap );
                Th_DeleteClpObj_tcad( tObj );
+               if ( nLevelBound ) Th_NtkLevelUpdate( TList , nObjs , vLevelQueue , vLevelQueued );
             }
             else
                tObj->nId = globalRef;
@@ -658,6 +857,10 @@ Th_CollapseNtk_tcad( Vec_Ptr_t * TList , int fIterative , int fOutBound )
          if ( sizeBeforeCollapse == Vec_PtrSize(TList) ) break;
       }
 	} while ( fIterative && Vec_PtrSize( TList ) > sizeBeforeIter );
+   Vec_WrdFree( vRow );
+   Vec_IntFree( vFaninMap );
+   Vec_IntFree( vLevelQueue );
+   Vec_IntFree( vLevelQueued );
 }
 
 void
@@ -678,13 +881,18 @@ Th_DeleteClpObj_tcad( Thre_S * tObj )
 }
 
 void
-Th_CollapseNtk( Vec_Ptr_t * TList , int fIterative , int fOutBound )
+Th_CollapseNtk( Vec_Ptr_t * TList , int fIterative , int fOutBound , int nLevelBound )
 {
+   Vec_Wrd_t * vRow = Vec_WrdAlloc( 16 ); // subset sum scratch of Th_subSumSolveBits()
+   Vec_Int_t * vFaninMap = Vec_IntStart( Vec_PtrSize( TList ) ); // scratch of Th_ObjFaninMapStart()
+   Vec_Int_t * vLevelQueue  = Vec_IntAlloc( 100 ); // scratch of Th_NtkLevelUpdate()
+   Vec_Int_t * vLevelQueued = Vec_IntAlloc( 100 );
    Thre_S * tObj;
-	int i , j , FinId , sizeBeforeIter , sizeBeforeCollapse;
+	int i , j , FinId , nObjs , sizeBeforeIter , sizeBeforeCollapse;
 	
 	//printf( "Th_CollapseNtk() : fIterative = %d\n" , fIterative );
 	//printf( "Th_CollapseNtk() : fOutBound  = %d\n" , fOutBound  );
+   Th_NtkBuildFanioIndex( TList );
    do {
 	   Th_UnmarkAllNode();
       sizeBeforeIter = Vec_PtrSize( TList );
@@ -700,9 +908,11 @@ Th_CollapseNtk( Vec_Ptr_t * TList , int fIterative , int fOutBound )
                
 		      Vec_IntForEachEntry( tObj->Fanins , FinId , j )
 			   {
-               if ( Th_CollapseNodes( tObj , j , fOutBound ) ) {
+               nObjs = Vec_PtrSize( TList );
+               if ( Th_CollapseNodes( tObj , j , fOutBound , nLevelBound , vRow , vFaninMap ) ) {
 						// delete tObj`s j-fanin and all its fanouts
 						Th_DeleteClpObj( tObj , j );
+                  if ( nLevelBound ) Th_NtkLevelUpdate( TList , nObjs , vLevelQueue , vLevelQueued );
                   break;
                }
                //printf("(%d) cannot be merged.\n", tObj->Id);
@@ -714,7 +924,10 @@ Th_CollapseNtk( Vec_Ptr_t * TList , int fIterative , int fOutBound )
          if ( sizeBeforeCollapse == Vec_PtrSize(TList) ) break;
       }
 	} while ( fIterative && Vec_PtrSize( TList ) > sizeBeforeIter );
-    
+   Vec_WrdFree( vRow );
+   Vec_IntFree( vFaninMap );
+   Vec_IntFree( vLevelQueue );
+   Vec_IntFree( vLevelQueued );
 	//printf("merging process completed...\n");
 }
 
@@ -737,6 +950,295 @@ Th_DeleteClpObj( Thre_S * tObj2 , int nFanin )
    Th_DeleteNode( tObj1 );
 }
 
+/**Function*************************************************************
+
+  Synopsis    [Worklist-driven collapsing.]
+
+  Description [Event-driven version of Th_CollapseNtk()/Th_CollapseNtk_tcad().
+               Every candidate node is visited once; after a successful
+               collapse only the merged nodes, their direct fanouts and their
+               fanins (whose fanout sets changed) are queued again, since no
+               other node can change its collapsibility.
+               When the queue runs empty the network is at a fixed point,
+               hence no outer iteration is needed.
+               Without -t a fanin failing Th_CheckMultiFoutCollapse() would
+               be checked again against all its fanouts from each of them;
+               vFailed remembers the failure instead, until a collapse
+               changes the fanin , its fanouts or their fanins (see
+               Th_WorklistClearFailed()). Levels may change elsewhere , so
+               failures are not kept under a level bound.]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+void
+Th_CollapseNtkWorklist( Vec_Ptr_t * TList , int fOutBound , int nLevelBound , int fTCAD )
+{
+   Vec_Int_t * vQueue , * vInQueue , * vFailed;
+   Vec_Wrd_t * vRow = Vec_WrdAlloc( 16 ); // subset sum scratch of Th_subSumSolveBits()
+   Vec_Int_t * vFaninMap = Vec_IntStart( Vec_PtrSize( TList ) ); // scratch of Th_ObjFaninMapStart()
+   Vec_Int_t * vLevelQueue  = Vec_IntAlloc( 100 ); // scratch of Th_NtkLevelUpdate()
+   Vec_Int_t * vLevelQueued = Vec_IntAlloc( 100 );
+   Thre_S    * tObj;
+	int i , j , FinId , head , sizeBeforeCollapse , fCollapsed;
+
+   // no black nodes in the worklist mode
+   Th_UnmarkAllNode();
+   Th_NtkBuildFanioIndex( TList );
+   vQueue   = Vec_IntAlloc( Vec_PtrSize( TList ) );
+   vInQueue = Vec_IntStart( Vec_PtrSize( TList ) );
+   vFailed  = Vec_IntStart( Vec_PtrSize( TList ) ); // 1 : failed to collapse into its fanouts
+   Vec_PtrForEachEntry( Thre_S* , TList , tObj , i )
+      if ( Th_WorklistIsCand( TList , tObj , fTCAD ) ) Th_WorklistPush( vQueue , vInQueue , tObj->Id );
+
+   for ( head = 0 ; head < Vec_IntSize( vQueue ) ; ++head )
+   {
+      tObj = (Thre_S*)Vec_PtrEntry( TList , Vec_IntEntry( vQueue , head ) );
+      Vec_IntWriteEntry( vInQueue , Vec_IntEntry( vQueue , head ) , 0 );
+      // Following nodes are skipped:
+      if ( !tObj )                    continue; // NULL  node (already collapsed)
+      if ( tObj->Type != Th_Node )    continue; // PI/PO/CONST
+      if ( !Th_ObjNormalCheck(tObj) ) continue; // Abnormal node : const or 0-weight
+
+      sizeBeforeCollapse = Vec_PtrSize( TList );
+      fCollapsed         = 0;
+      if ( fTCAD ) {
+         // tObj is collapsed into all its fanouts
+         if ( Th_CheckMultiFoutCollapse( tObj , fOutBound , nLevelBound , vRow , vFaninMap ) ) {
+            Th_CalKLCollapse( tObj , vRow , vFaninMap );
+            Th_DeleteClpObj_tcad( tObj );
+            fCollapsed = 1;
+         }
+      }
+      else {
+         // one fanin of tObj is collapsed into all its fanouts
+         Vec_IntForEachEntry( tObj->Fanins , FinId , j )
+         {
+            if ( Vec_IntEntry( vFailed , FinId ) ) continue;
+            if ( Th_CollapseNodes( tObj , j , fOutBound , nLevelBound , vRow , vFaninMap ) ) {
+               Th_DeleteClpObj( tObj , j );
+               fCollapsed = 1;
+               break;
+            }
+            if ( !nLevelBound ) Vec_IntWriteEntry( vFailed , FinId , 1 );
+         }
+      }
+      if ( !fCollapsed ) continue;
+      if ( nLevelBound ) Th_NtkLevelUpdate( TList , sizeBeforeCollapse , vLevelQueue , vLevelQueued );
+      // revisit the merged nodes and their neighbors only
+      Vec_IntFillExtra( vFailed , Vec_PtrSize( TList ) , 0 );
+      for ( i = sizeBeforeCollapse ; i < Vec_PtrSize( TList ) ; ++i )
+      {
+         tObj = (Thre_S*)Vec_PtrEntry( TList , i );
+         if ( !tObj ) continue;
+         Th_WorklistPushFanio( TList , vQueue , vInQueue , tObj );
+         Th_WorklistClearFailed( TList , vFailed , tObj );
+      }
+   }
+   Vec_IntFree( vQueue );
+   Vec_IntFree( vInQueue );
+   Vec_IntFree( vFailed );
+   Vec_WrdFree( vRow );
+   Vec_IntFree( vFaninMap );
+   Vec_IntFree( vLevelQueue );
+   Vec_IntFree( vLevelQueued );
+}
+
+int
+Th_WorklistIsCand( Vec_Ptr_t * TList , Thre_S * tObj , int fTCAD )
+{
+   Thre_S * tObjFanin;
+	int Entry , i;
+
+   if ( !tObj || tObj->Type != Th_Node ) return 0;
+   // -t : tObj itself is collapsed into its fanouts
+   if ( fTCAD ) return Vec_IntSize( tObj->Fanouts ) > 0;
+   // otherwise one of its fanins is collapsed into tObj
+	Vec_IntForEachEntry( tObj->Fanins , Entry , i )
+	{
+      tObjFanin = (Thre_S*)Vec_PtrEntry( TList , Entry );
+		if ( tObjFanin && tObjFanin->Type == Th_Node ) return 1;
+	}
+   return 0;
+}
+
+void
+Th_WorklistClearFailed( Vec_Ptr_t * TList , Vec_Int_t * vFailed , Thre_S * tObjM )
+{
+   // the collapse creating tObjM rewrote the fanins of its fanouts and the
+   // fanouts of its fanins : clear tObjM , its fanins , its fanouts and
+   // their fanins , whose fanouts changed
+   Thre_S * tObjFanout;
+	int Entry , Fanin , i , k;
+
+   Vec_IntWriteEntry( vFailed , tObjM->Id , 0 );
+	Vec_IntForEachEntry( tObjM->Fanins , Entry , i )
+      Vec_IntWriteEntry( vFailed , Entry , 0 );
+	Vec_IntForEachEntry( tObjM->Fanouts , Entry , i )
+	{
+      Vec_IntWriteEntry( vFailed , Entry , 0 );
+      tObjFanout = (Thre_S*)Vec_PtrEntry( TList , Entry );
+	   Vec_IntForEachEntry( tObjFanout->Fanins , Fanin , k )
+         Vec_IntWriteEntry( vFailed , Fanin , 0 );
+	}
+}
+
+void
+Th_WorklistPush( Vec_Int_t * vQueue , Vec_Int_t * vInQueue , int Id )
+{
+   if ( Id >= Vec_IntSize( vInQueue ) ) Vec_IntFillExtra( vInQueue , Id + 1 , 0 );
+   if ( Vec_IntEntry( vInQueue , Id ) ) return;
+   Vec_IntWriteEntry( vInQueue , Id , 1 );
+   Vec_IntPush( vQueue , Id );
+}
+
+void
+Th_WorklistPushFanio( Vec_Ptr_t * TList , Vec_Int_t * vQueue , Vec_Int_t * vInQueue , Thre_S * tObj )
+{
+   Thre_S * tObjFanio;
+	int Entry , i;
+
+   Th_WorklistPush( vQueue , vInQueue , tObj->Id );
+	Vec_IntForEachEntry( tObj->Fanins , Entry , i )
+	{
+      tObjFanio = (Thre_S*)Vec_PtrEntry( TList , Entry );
+		if ( tObjFanio && tObjFanio->Type == Th_Node ) Th_WorklistPush( vQueue , vInQueue , Entry );
+	}
+	Vec_IntForEachEntry( tObj->Fanouts , Entry , i )
+	{
+      tObjFanio = (Thre_S*)Vec_PtrEntry( TList , Entry );
+		if ( tObjFanio && tObjFanio->Type == Th_Node ) Th_WorklistPush( vQueue , vInQueue , Entry );
+	}
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Priority-ordered multi-fanout collapsing.]
+
+  Description [Single-pass replacement of the "merge_th -B" loop, which
+               calls Th_CollapseNtk() once for every fanout bound from 1 to
+               fOutBound. Candidates (nodes to be collapsed into all their
+               fanouts) are kept in a priority queue keyed by their fanout
+               number, smaller first, ties broken by the topological order.
+               The key is the integer (fanout number << 32 | id) in a binary
+               min-heap; re-queuing pushes a new key and the old entry is
+               dropped when popped, since it no longer matches vKeys.
+               After a collapse the merged nodes, their fanins (whose fanout
+               numbers changed) and their fanouts are re-queued with their
+               new keys; the network is at a fixed point when the queue is
+               empty.]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+void
+Th_CollapseNtkPriority( Vec_Ptr_t * TList , int fOutBound , int nLevelBound )
+{
+   Vec_Wrd_t * vHeap , * vKeys;
+   Vec_Wrd_t * vRow = Vec_WrdAlloc( 16 ); // subset sum scratch of Th_subSumSolveBits()
+   Vec_Int_t * vFaninMap = Vec_IntStart( Vec_PtrSize( TList ) ); // scratch of Th_ObjFaninMapStart()
+   Vec_Int_t * vLevelQueue  = Vec_IntAlloc( 100 ); // scratch of Th_NtkLevelUpdate()
+   Vec_Int_t * vLevelQueued = Vec_IntAlloc( 100 );
+   Thre_S    * tObj;
+	word Key;
+	int i , j , Entry , sizeBeforeCollapse;
+
+   // no black nodes in the priority mode
+   Th_UnmarkAllNode();
+   Th_NtkBuildFanioIndex( TList );
+   vKeys = Vec_WrdStartFull( 2 * Vec_PtrSize( TList ) ); // current key of a queued id , ~0 otherwise
+   vHeap = Vec_WrdAlloc( 2 * Vec_PtrSize( TList ) );
+   Vec_PtrForEachEntry( Thre_S* , TList , tObj , i )
+      Th_PriorityPush( vHeap , vKeys , tObj , fOutBound );
+
+   while ( Vec_WrdSize( vHeap ) > 0 )
+   {
+      Key   = Th_PriorityHeapPop( vHeap );
+      Entry = (int)(Key & 0xFFFFFFFF);
+      if ( Vec_WrdEntry( vKeys , Entry ) != Key ) continue; // re-queued with another key
+      Vec_WrdWriteEntry( vKeys , Entry , ~(word)0 );
+      tObj = (Thre_S*)Vec_PtrEntry( TList , Entry );
+      // Following nodes are skipped:
+      if ( !tObj )                    continue; // NULL  node (already collapsed)
+      if ( !Th_ObjNormalCheck(tObj) ) continue; // Abnormal node : const or 0-weight
+      if ( !Th_CheckMultiFoutCollapse( tObj , fOutBound , nLevelBound , vRow , vFaninMap ) ) continue;
+
+      sizeBeforeCollapse = Vec_PtrSize( TList );
+      Th_CalKLCollapse( tObj , vRow , vFaninMap );
+      Th_DeleteClpObj_tcad( tObj );
+      if ( nLevelBound ) Th_NtkLevelUpdate( TList , sizeBeforeCollapse , vLevelQueue , vLevelQueued );
+      // re-queue the merged nodes and their neighbors with updated keys
+      for ( i = sizeBeforeCollapse ; i < Vec_PtrSize( TList ) ; ++i )
+      {
+         tObj = (Thre_S*)Vec_PtrEntry( TList , i );
+         if ( !tObj ) continue;
+         Th_PriorityPush( vHeap , vKeys , tObj , fOutBound );
+	      Vec_IntForEachEntry( tObj->Fanins , Entry , j )
+		      Th_PriorityPush( vHeap , vKeys , (Thre_S*)Vec_PtrEntry( TList , Entry ) , fOutBound );
+	      Vec_IntForEachEntry( tObj->Fanouts , Entry , j )
+		      Th_PriorityPush( vHeap , vKeys , (Thre_S*)Vec_PtrEntry( TList , Entry ) , fOutBound );
+      }
+   }
+   Vec_WrdFree( vHeap );
+   Vec_WrdFree( vKeys );
+   Vec_WrdFree( vRow );
+   Vec_IntFree( vFaninMap );
+   Vec_IntFree( vLevelQueue );
+   Vec_IntFree( vLevelQueued );
+}
+
+void
+Th_PriorityPush( Vec_Wrd_t * vHeap , Vec_Wrd_t * vKeys , Thre_S * tObj , int fOutBound )
+{
+   word Key;
+   int nFouts;
+   if ( !tObj || tObj->Type != Th_Node ) return;
+   nFouts = Vec_IntSize( tObj->Fanouts );
+   // out of bound now, re-queued if its fanout number drops later
+   if ( fOutBound != -1 && nFouts > fOutBound ) return;
+   // min-heap: fewer fanouts first, then smaller id (topological order)
+   Key = ((word)nFouts << 32) | (word)tObj->Id;
+   if ( tObj->Id >= Vec_WrdSize( vKeys ) ) Vec_WrdFillExtra( vKeys , 2 * tObj->Id + 1 , ~(word)0 );
+   if ( Vec_WrdEntry( vKeys , tObj->Id ) == Key ) return;
+   Vec_WrdWriteEntry( vKeys , tObj->Id , Key );
+   Th_PriorityHeapPush( vHeap , Key );
+}
+
+void
+Th_PriorityHeapPush( Vec_Wrd_t * vHeap , word Key )
+{
+   word * pHeap;
+   int i , parent;
+   Vec_WrdPush( vHeap , Key );
+   pHeap = Vec_WrdArray( vHeap );
+   for ( i = Vec_WrdSize( vHeap ) - 1 ; i > 0 ; i = parent ) {
+      parent = (i - 1) >> 1;
+      if ( pHeap[parent] <= Key ) break;
+      pHeap[i] = pHeap[parent];
+   }
+   pHeap[i] = Key;
+}
+
+word
+Th_PriorityHeapPop( Vec_Wrd_t * vHeap )
+{
+   word * pHeap = Vec_WrdArray( vHeap ) , Top = pHeap[0] , Key = Vec_WrdPop( vHeap );
+   int i , child , nSize = Vec_WrdSize( vHeap );
+   for ( i = 0 ; (child = 2 * i + 1) < nSize ; i = child ) {
+      if ( child + 1 < nSize && pHeap[child+1] < pHeap[child] ) ++child;
+      if ( Key <= pHeap[child] ) break;
+      pHeap[i] = pHeap[child];
+   }
+   if ( nSize > 0 ) pHeap[i] = Key;
+   return Top;
+}
+
 int
 Th_NtkMaxFanout()
 {
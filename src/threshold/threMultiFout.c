@@ -40,14 +40,22 @@
 
 // extern functions
 extern  Thre_S* Th_GetObjById       ( Vec_Ptr_t * , int );
+extern  int     Th_ObjIsConst       ( const Thre_S * );
+extern  void    Th_KLCheckCond      ( const Thre_S * , int , int , int , int * );
+extern  void    Th_IfCoeffVal       ( int , int , int , int , int * , int * );
+extern  void    Th_IfSolveKLPair    ( int * , int * , int , Pair_S * );
+extern  void    Th_KLObjView        ( const Thre_S * , int , int * , int * , int * );
+extern  int     Th_KLObjSubSum      ( const Thre_S * , int , int , Vec_Wrd_t * );
+extern  void    Th_DPCoeffVal       ( int , int , int , int , const Thre_S * , int , int , int , int * , int * , Vec_Wrd_t * );
+extern  void    Th_DPSolveKLPair    ( int * , int * , int , Pair_S * );
 // main functions
-int     Th_Check2FoutCollapse       ( const Thre_S * , const Thre_S * , int );
-int     Th_CheckMultiFoutCollapse   ( const Thre_S * , int );
+int     Th_Check2FoutCollapse       ( const Thre_S * , const Thre_S * , int , Vec_Wrd_t * , Vec_Int_t * );
+int     Th_CheckMultiFoutCollapse   ( const Thre_S * , int , int , Vec_Wrd_t * , Vec_Int_t * );
 // helper functions
 Thre_S* Th_2FoutGetOther            ( const Thre_S * , const Thre_S * );
 int     Th_ObjFanoutFaninNum        ( const Thre_S * , const Thre_S * );
-int     Th_CheckPairCollapse        ( const Thre_S * , const Thre_S * , int );
-int     Th_KLClpCheck               ( const Thre_S * , const Thre_S * , const Pair_S * , int , int );
+int     Th_CheckPairCollapse        ( const Thre_S * , const Thre_S * , int , Vec_Wrd_t * , Vec_Int_t * );
+int     Th_KLClpCheck               ( const Thre_S * , const Thre_S * , const Pair_S * , int , int , int , Vec_Int_t * );
 
 ////////////////////////////////////////////////////////////////////////
 ///                     FUNCTION DEFINITIONS                         ///
@@ -66,7 +74,7 @@ int     Th_KLClpCheck               ( const Thre_S * , const Thre_S * , const Pa
 ***********************************************************************/
 
 int 
-Th_Check2FoutCollapse( const Thre_S * tObj1 , const Thre_S * tObj2 , int nFanin21 )
+Th_Check2FoutCollapse( const Thre_S * tObj1 , const Thre_S * tObj2 , int nFanin21 , Vec_Wrd_t * vRow , Vec_Int_t * vFaninMap )
 {
 	assert( Vec_IntSize(tObj1->Fanouts) == 2 );
 	Thre_S * tObj3;
@@ -77,8 +85,8 @@ Th_Check2FoutCollapse( const Thre_S * tObj1 , const Thre_S * tObj2 , int nFanin2
 	if ( tObj3->nId == globalRef || tObj3->Type != Th_Node ) return 0;
 	nFanin31 = Th_ObjFanoutFaninNum( tObj1 , tObj3 );
 	assert( nFanin31 >=0 && nFanin31 < Vec_IntSize(tObj3->Fanins) );
-   return ( Th_CheckPairCollapse( tObj1 , tObj2 , nFanin21 ) &&
-		      Th_CheckPairCollapse( tObj1 , tObj3 , nFanin31 ) );
+   return ( Th_CheckPairCollapse( tObj1 , tObj2 , nFanin21 , vRow , vFaninMap ) &&
+		      Th_CheckPairCollapse( tObj1 , tObj3 , nFanin31 , vRow , vFaninMap ) );
 
 }
 
@@ -108,90 +116,98 @@ Th_ObjFanoutFaninNum( const Thre_S * tObj1 , const Thre_S * tObj2 )
 
   Synopsis    [Check if a pair of nodes can be collapsed.]
 
-  Description []
+  Description [Allocation-free feasibility check. A negative weight w means
+               tObj1 is seen inverted (weights negated, threshold 1-T1)
+               without copying it; K and L are solved into a local pair by
+               the iff (thKLDP) or if conditions, and the merged threshold
+               and weights are bounded in place. vRow and vFaninMap are
+               the subset sum and fanin map scratch of the caller.]
                
-  SideEffects []
+  SideEffects [Updates the pair-check counters of thProfiler.]
 
-  SeeAlso     []
+  SeeAlso     [Th_CollapsePair()]
 
 ***********************************************************************/
 
 int
-Th_CheckPairCollapse( const Thre_S * tObj1 , const Thre_S * tObj2 , int nFanin )
+Th_CheckPairCollapse( const Thre_S * tObj1 , const Thre_S * tObj2 , int nFanin , Vec_Wrd_t * vRow , Vec_Int_t * vFaninMap )
 {
-	Thre_S * tObjInv;
-	Pair_S * pair;
-	int w , fInvert , RetValue;
+	Pair_S  pair;
+	abctime clk;
+	int cond[2] , n[6];
+	int w , fInvert , T1 , maxf1 , minf1 , sum1 , RetValue;
 	
-	tObjInv       = tObj1;
-	w             = Vec_IntEntry( tObj2->weights , nFanin );
-	fInvert       = 0;
-	RetValue      = 0;
-	
-	if ( w < 0 ) {
-	   tObjInv      = Th_InvertObj(tObj1);
-		w           *= -1;
-      fInvert      = 1;
+	clk      = Abc_Clock();
+	w        = Vec_IntEntry( tObj2->weights , nFanin );
+	fInvert  = ( w < 0 );
+	RetValue = 0;
+	if ( fInvert ) w *= -1;
+
+	// bounds of tObj1 , inverted view if needed
+	Th_KLObjView( tObj1 , fInvert , &T1 , &maxf1 , &minf1 );
+	// constant nodes are not collapsed , see Th_ObjIsConst()
+	if ( maxf1 < T1 || minf1 >= T1 || Th_ObjIsConst( tObj2 ) ) goto finish;
+
+	cond[0] = cond[1] = 0;
+	n[0] = n[1] = n[2] = n[3] = n[4] = n[5] = 0;
+	Th_KLCheckCond( tObj2 , nFanin , w , fInvert , cond );
+	if ( thKLDP ) {
+		sum1 = Th_KLObjSubSum( tObj1 , T1 , fInvert , vRow );
+		Th_DPCoeffVal( T1 , maxf1 , minf1 , sum1 , tObj2 , nFanin , w , fInvert , cond , n , vRow );
+		Th_DPSolveKLPair( cond , n , w , &pair );
+	}
+	else {
+		Th_IfCoeffVal( T1 , maxf1 , minf1 , w , cond , n );
+		Th_IfSolveKLPair( cond , n , w , &pair );
 	}
 
-	//pair = Th_CalKLDP( tObjInv , tObj2 , nFanin , w , fInvert );
-	pair = Th_CalKLIf( tObjInv , tObj2 , nFanin , w , fInvert );
-
-	if ( pair && pair->IntK > 0 && pair->IntL > 0 && 
-	     Th_KLClpCheck( tObjInv , tObj2 , pair , w , fInvert ) ) {
+	if ( pair.IntK > 0 && pair.IntL > 0 && 
+	     Th_KLClpCheck( tObj1 , tObj2 , &pair , nFanin , w , fInvert , vFaninMap ) ) {
 		RetValue = 1; 
 	}
-   if ( fInvert ) Th_DeleteObjNoInsert( tObjInv ); // delete the inverted object created in this function
-	ABC_FREE( pair );
-
+finish:
+	++thProfiler.numPairCheck;
+	if ( RetValue ) ++thProfiler.numPairCheckOk;
+	thProfiler.clkPairCheck += Abc_Clock() - clk;
 	return RetValue;
 }
 
 int 
-Th_KLClpCheck( const Thre_S * tObj1 , const Thre_S * tObj2 , const Pair_S * pair , int w , int fInvert )
+Th_KLClpCheck( const Thre_S * tObj1 , const Thre_S * tObj2 , const Pair_S * pair , int nFanin , int w , int fInvert , Vec_Int_t * vFaninMap )
 {	
-	Thre_S * tObjMerge;
-	int T1 , T2 , fMark , Entry , i , limit;
+	int T1 , T2 , sign , value , fMark , Entry , i , limit , RetValue;
    
 	limit = 255;
-	T1    = tObj1->thre;
+	sign  = (fInvert) ? -1 : 1;
+	T1    = (fInvert) ? (1 - tObj1->thre) : (tObj1->thre);
 	T2    = (fInvert) ? (tObj2->thre + w) : (tObj2->thre);
 
-	tObjMerge = Th_CreateObjNoInsert( Th_Node );
-	tObjMerge->thre = pair->IntK * T1 + pair->IntL * (T2 - w);
-	if ( tObjMerge->thre > limit || tObjMerge->thre < -limit ) {
-	   Th_DeleteObjNoInsert( tObjMerge );
-		return 0;
-	}
-	// set merged weights and fanins , tObj1 part
-	Vec_IntForEachEntry( tObj1->weights , Entry , i )
-		Vec_IntPush( tObjMerge->weights , pair->IntK * Entry );
-	Vec_IntForEachEntry( tObj1->Fanins , Entry , i )
-		Vec_IntPush( tObjMerge->Fanins , Entry );
-
-	// set merged weights and fanins , tObj2 part , take care of joint fanins
+	value = pair->IntK * T1 + pair->IntL * (T2 - w);
+	if ( value > limit || value < -limit ) return 0;
+	// merged weights , tObj2 part , joint fanins summed up
+	RetValue = 1;
+	Th_ObjFaninMapStart( vFaninMap , tObj1 );
 	Vec_IntForEachEntry( tObj2->Fanins , Entry , i )
 	{
-		if ( Entry == tObj1->Id ) continue;
-      fMark = Th_ObjIsFanin( tObj1 , Entry );
-		if ( fMark > -1 ) { // joint fanin , sum weights up
-		   Vec_IntWriteEntry( tObjMerge->weights , fMark , Vec_IntEntry( tObjMerge->weights , fMark ) + 
-					                                          pair->IntL * Vec_IntEntry( tObj2->weights , i ));
-		}
-		else {
-			Vec_IntPush( tObjMerge->weights , pair->IntL * Vec_IntEntry( tObj2->weights , i ) );
-         Vec_IntPush( tObjMerge->Fanins  , Entry );
-		}
-   }
-	Vec_IntForEachEntry( tObjMerge->weights , Entry , i )
+		if ( i == nFanin ) continue;
+		value = pair->IntL * Vec_IntEntry( tObj2->weights , i );
+      fMark = Th_ObjFaninMapFind( vFaninMap , Entry );
+		if ( fMark > -1 )
+			value += pair->IntK * sign * Vec_IntEntry( tObj1->weights , fMark );
+		if ( value > limit || value < -limit ) { RetValue = 0; break; }
+	}
+	Th_ObjFaninMapStop( vFaninMap , tObj1 );
+	if ( !RetValue ) return 0;
+	// merged weights , tObj1 part , joint fanins already checked
+	Th_ObjFaninMapStart( vFaninMap , tObj2 );
+	Vec_IntForEachEntry( tObj1->Fanins , Entry , i )
 	{
-	   if ( Entry > limit || Entry < -limit ) {
-	      Th_DeleteObjNoInsert( tObjMerge );
-		   return 0;
-		}
+		if ( Th_ObjFaninMapFind( vFaninMap , Entry ) > -1 ) continue;
+		value = pair->IntK * sign * Vec_IntEntry( tObj1->weights , i );
+		if ( value > limit || value < -limit ) { RetValue = 0; break; }
 	}
-	Th_DeleteObjNoInsert( tObjMerge );
-	return 1;
+	Th_ObjFaninMapStop( vFaninMap , tObj2 );
+	return RetValue;
 }
 
 /**Function*************************************************************
@@ -207,24 +223,27 @@ Th_KLClpCheck( const Thre_S * tObj1 , const Thre_S * tObj2 , const Pair_S * pair
 ***********************************************************************/
 
 int
-Th_CheckMultiFoutCollapse( const Thre_S * tObj1 , int fOutBound )
+Th_CheckMultiFoutCollapse( const Thre_S * tObj1 , int fOutBound , int nLevelBound , Vec_Wrd_t * vRow , Vec_Int_t * vFaninMap )
 {
 	// controlling multi-fanout number
 	//int foutBound = 30;
 	if ( fOutBound == -1 ); // -1 --> no limit
 	else if ( Vec_IntSize( tObj1->Fanouts ) > fOutBound ) return 0;
+	// depth-bounded collapse ( 0 = no bound ) , levels kept by Th_NtkLevelUpdate()
+	if ( nLevelBound && tObj1->level > nLevelBound ) return 0;
 
 	Thre_S * tObj2;
 	int RetValue , nFanin , Entry , i;
 	RetValue = 1;
+	assert( Th_ObjHasFanioIndex( tObj1 ) );
 
 	Vec_IntForEachEntry( tObj1->Fanouts , Entry , i )
 	{
 		tObj2 = Th_GetObjById( current_TList , Entry );
 		assert(tObj2);
-	   nFanin = Th_ObjFanoutFaninNum( tObj1 , tObj2 );
-	   assert( nFanin >=0 && nFanin < Vec_IntSize(tObj2->Fanins) );
-		if ( tObj2->nId == globalRef || tObj2->Type != Th_Node || !Th_CheckPairCollapse(tObj1 , tObj2 , nFanin) ) {
+	   nFanin = Vec_IntEntry( tObj1->FanoutPos , i );
+	   assert( Vec_IntEntry( tObj2->Fanins , nFanin ) == tObj1->Id );
+		if ( tObj2->nId == globalRef || tObj2->Type != Th_Node || !Th_CheckPairCollapse(tObj1 , tObj2 , nFanin , vRow , vFaninMap) ) {
 		   RetValue = 0;
 			break;
 		}
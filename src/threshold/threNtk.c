@@ -0,0 +1,390 @@
+/**CFile****************************************************************
+
+  FileName    [threNtk.c]
+
+  SystemName  [ABC: Logic synthesis and verification system.]
+
+  PackageName [threshold.]
+
+  Synopsis    [Compact (structure-of-arrays) threshold network.]
+
+  Author      [ALCom Lab]
+
+  Affiliation [NTU]
+
+  Date        [Oct 16, 2026.]
+
+  Revision    [$Id: abc.c,v 1.00 2005/06/20 00:00:00 alanmi Exp $]
+
+***********************************************************************/
+
+////////////////////////////////////////////////////////////////////////
+///                          INCLUDES                                ///
+////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include "base/abc/abc.h"
+#include "threshold.h"
+
+////////////////////////////////////////////////////////////////////////
+///                        DECLARATIONS                              ///
+////////////////////////////////////////////////////////////////////////
+
+// main functions
+Th_Ntk_t*  Th_NtkAlloc            ( int , int );
+void       Th_NtkFree             ( Th_Ntk_t * );
+Th_Ntk_t*  Th_NtkFromList         ( Vec_Ptr_t * );
+Vec_Ptr_t* Th_NtkToList           ( Th_Ntk_t * );
+double     Th_NtkMemory           ( Th_Ntk_t * );
+double     Th_ListMemory          ( Vec_Ptr_t * );
+// ported passes
+int        Th_NtkCountGate        ( Th_Ntk_t * , Th_Gate_Type );
+Vec_Int_t* Th_NtkCountFanio       ( Th_Ntk_t * , int );
+int        Th_NtkCountLevel       ( Th_Ntk_t * );
+void       Th_NtkPrintStat        ( Th_Ntk_t * );
+void       Th_NtkWriteTh          ( Th_Ntk_t * , char * );
+
+extern void Th_PrintData          ( int , int , int , int , Vec_Int_t * , Vec_Int_t * );
+
+////////////////////////////////////////////////////////////////////////
+///                     FUNCTION DEFINITIONS                         ///
+////////////////////////////////////////////////////////////////////////
+
+/**Function*************************************************************
+
+  Synopsis    [Constructor and destructor.]
+
+  Description [Objects keep the ids of the Vec_Ptr_t list; deleted (NULL)
+               entries become Th_Unknown objects without fanins. Fanins
+               and weights of object i are stored in CSR form at positions
+               [vFaninStart[i], vFaninStart[i+1]), fanouts likewise.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+Th_Ntk_t*
+Th_NtkAlloc( int nObjs , int nEdges )
+{
+	Th_Ntk_t * p;
+	p = ABC_CALLOC( Th_Ntk_t , 1 );
+	p->nObjs        = nObjs;
+	p->vType        = Vec_IntStart( nObjs );
+	p->vThre        = Vec_IntStart( nObjs );
+	p->vFaninStart  = Vec_IntStart( nObjs + 1 );
+	p->vFanoutStart = Vec_IntStart( nObjs + 1 );
+	p->vFanins      = Vec_IntAlloc( nEdges );
+	p->vWeights     = Vec_IntAlloc( nEdges );
+	p->vFanouts     = Vec_IntAlloc( nEdges );
+	p->vNameStart   = Vec_IntStartFull( nObjs );
+	p->vNames       = Vec_StrAlloc( 16 * nObjs );
+	return p;
+}
+
+void
+Th_NtkFree( Th_Ntk_t * p )
+{
+	Vec_IntFree( p->vType );
+	Vec_IntFree( p->vThre );
+	Vec_IntFree( p->vFaninStart );
+	Vec_IntFree( p->vFanoutStart );
+	Vec_IntFree( p->vFanins );
+	Vec_IntFree( p->vWeights );
+	Vec_IntFree( p->vFanouts );
+	Vec_IntFree( p->vNameStart );
+	Vec_StrFree( p->vNames );
+	ABC_FREE( p );
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Conversion from/to the list of Thre_S.]
+
+  Description [Both directions are linear in the network size. The
+               fanout order of every object is preserved.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+Th_Ntk_t*
+Th_NtkFromList( Vec_Ptr_t * tList )
+{
+	Th_Ntk_t * p;
+	Thre_S   * tObj;
+	int i , k , Entry , nEdges;
+
+	nEdges = 0;
+	Vec_PtrForEachEntry( Thre_S * , tList , tObj , i )
+		if ( tObj ) nEdges += Vec_IntSize( tObj->Fanins );
+	p = Th_NtkAlloc( Vec_PtrSize( tList ) , nEdges );
+	Vec_PtrForEachEntry( Thre_S * , tList , tObj , i )
+	{
+		Vec_IntWriteEntry( p->vFaninStart  , i , Vec_IntSize( p->vFanins  ) );
+		Vec_IntWriteEntry( p->vFanoutStart , i , Vec_IntSize( p->vFanouts ) );
+		if ( !tObj ) continue;
+		assert( tObj->Id == i );
+		assert( Vec_IntSize( tObj->Fanins ) == Vec_IntSize( tObj->weights ) );
+		Vec_IntWriteEntry( p->vType , i , tObj->Type );
+		Vec_IntWriteEntry( p->vThre , i , tObj->thre );
+		Vec_IntForEachEntry( tObj->Fanins , Entry , k )
+		{
+			Vec_IntPush( p->vFanins  , Entry );
+			Vec_IntPush( p->vWeights , Vec_IntEntry( tObj->weights , k ) );
+		}
+		Vec_IntAppend( p->vFanouts , tObj->Fanouts );
+		if ( tObj->pName ) {
+			Vec_IntWriteEntry( p->vNameStart , i , Vec_StrSize( p->vNames ) );
+			Vec_StrPrintStr( p->vNames , tObj->pName );
+			Vec_StrPush( p->vNames , '\0' );
+		}
+	}
+	Vec_IntWriteEntry( p->vFaninStart  , p->nObjs , Vec_IntSize( p->vFanins  ) );
+	Vec_IntWriteEntry( p->vFanoutStart , p->nObjs , Vec_IntSize( p->vFanouts ) );
+	return p;
+}
+
+Vec_Ptr_t*
+Th_NtkToList( Th_Ntk_t * p )
+{
+	Vec_Ptr_t * tList;
+	Thre_S    * tObj;
+	int i , k , iFanin , Weight , iFanout;
+
+	tList = Vec_PtrAlloc( p->nObjs );
+	for ( i = 0 ; i < p->nObjs ; ++i )
+	{
+		if ( Th_NtkObjType( p , i ) == Th_Unknown ) {
+			Vec_PtrPush( tList , NULL );
+			continue;
+		}
+		tObj = Th_ObjAlloc();
+		tObj->Id      = i;
+		tObj->Type    = Th_NtkObjType( p , i );
+		tObj->thre    = Th_NtkObjThre( p , i );
+		Th_NtkObjForEachFanin( p , i , iFanin , Weight , k )
+		{
+			Vec_IntPush( tObj->Fanins  , iFanin );
+			Vec_IntPush( tObj->weights , Weight );
+		}
+		Th_NtkObjForEachFanout( p , i , iFanout , k )
+			Vec_IntPush( tObj->Fanouts , iFanout );
+		if ( Th_NtkObjName( p , i ) ) tObj->pName = Abc_UtilStrsav( Th_NtkObjName( p , i ) );
+		Vec_PtrPush( tList , tObj );
+	}
+	return tList;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Memory usage in bytes.]
+
+  Description [Th_ListMemory() is the allocated size of the Thre_S list,
+               for comparison.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+double
+Th_NtkMemory( Th_Ntk_t * p )
+{
+	double Mem = sizeof(Th_Ntk_t);
+	Mem += Vec_IntMemory( p->vType );
+	Mem += Vec_IntMemory( p->vThre );
+	Mem += Vec_IntMemory( p->vFaninStart );
+	Mem += Vec_IntMemory( p->vFanoutStart );
+	Mem += Vec_IntMemory( p->vFanins );
+	Mem += Vec_IntMemory( p->vWeights );
+	Mem += Vec_IntMemory( p->vFanouts );
+	Mem += Vec_IntMemory( p->vNameStart );
+	Mem += Vec_StrMemory( p->vNames );
+	return Mem;
+}
+
+double
+Th_ListMemory( Vec_Ptr_t * tList )
+{
+	Thre_S * tObj;
+	double Mem;
+	int i;
+	Mem = Vec_PtrMemory( tList );
+	Vec_PtrForEachEntry( Thre_S * , tList , tObj , i )
+	{
+		if ( !tObj ) continue;
+		Mem += sizeof(Thre_S);
+		Mem += Vec_IntMemory( tObj->weights );
+		Mem += Vec_IntMemory( tObj->Fanins );
+		Mem += Vec_IntMemory( tObj->Fanouts );
+		if ( tObj->pName ) Mem += strlen( tObj->pName ) + 1;
+	}
+	return Mem;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Network statistics on Th_Ntk_t.]
+
+  Description [Same numbers as Th_PrintStat() on the list.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+int
+Th_NtkCountGate( Th_Ntk_t * p , Th_Gate_Type type )
+{
+	int i , numGate = 0;
+	Th_NtkForEachObj( p , i )
+		if ( Th_NtkObjType( p , i ) == type ) numGate++;
+	return numGate;
+}
+
+Vec_Int_t*
+Th_NtkCountFanio( Th_Ntk_t * p , int fFanin )
+{
+	Vec_Int_t * fanSizeList;
+	int i , numFan , maxFanNum;
+
+	maxFanNum = 0;
+	Th_NtkForEachNode( p , i )
+	{
+		numFan    = fFanin ? Th_NtkObjFaninNum( p , i ) : Th_NtkObjFanoutNum( p , i );
+		maxFanNum = Abc_MaxInt( maxFanNum , numFan );
+	}
+	fanSizeList = Vec_IntStart( maxFanNum + 1 );
+	Th_NtkForEachNode( p , i )
+		Vec_IntAddToEntry( fanSizeList , fFanin ? Th_NtkObjFaninNum( p , i ) : Th_NtkObjFanoutNum( p , i ) , 1 );
+	return fanSizeList;
+}
+
+int
+Th_NtkCountLevel( Th_Ntk_t * p )
+{
+	// level of an object : longest path to a PO (POs are at level 0) ,
+	// computed in reverse topological order from the POs in O(V+E)
+	Vec_Int_t * vLevel , * vRef , * vQueue;
+	int i , k , iObj , iFanin , Weight , head , level;
+	vLevel = Vec_IntStart( p->nObjs );
+	vRef   = Vec_IntStart( p->nObjs );
+	vQueue = Vec_IntAlloc( p->nObjs );
+	Th_NtkForEachObj( p , i )
+	{
+		if ( Th_NtkObjType( p , i ) != Th_Po )
+			Vec_IntWriteEntry( vRef , i , Th_NtkObjFanoutNum( p , i ) );
+		if ( Vec_IntEntry( vRef , i ) == 0 ) Vec_IntPush( vQueue , i );
+	}
+	for ( head = 0 ; head < Vec_IntSize( vQueue ) ; ++head )
+	{
+		iObj = Vec_IntEntry( vQueue , head );
+		Th_NtkObjForEachFanin( p , iObj , iFanin , Weight , k )
+		{
+			if ( Th_NtkObjType( p , iFanin ) == Th_Po ) continue;
+			if ( Vec_IntEntry( vLevel , iFanin ) < Vec_IntEntry( vLevel , iObj ) + 1 )
+				Vec_IntWriteEntry( vLevel , iFanin , Vec_IntEntry( vLevel , iObj ) + 1 );
+			Vec_IntAddToEntry( vRef , iFanin , -1 );
+			if ( Vec_IntEntry( vRef , iFanin ) == 0 ) Vec_IntPush( vQueue , iFanin );
+		}
+	}
+	level = 0;
+	Th_NtkForEachObj( p , i )
+		if ( Th_NtkObjType( p , i ) == Th_Pi )
+			level = Abc_MaxInt( level , Vec_IntEntry( vLevel , i ) );
+	Vec_IntFree( vLevel );
+	Vec_IntFree( vRef );
+	Vec_IntFree( vQueue );
+	return level;
+}
+
+void
+Th_NtkPrintStat( Th_Ntk_t * p )
+{
+	Vec_Int_t * faninSizeList , * fanoutSizeList;
+	faninSizeList  = Th_NtkCountFanio( p , 1 );
+	fanoutSizeList = Th_NtkCountFanio( p , 0 );
+	Th_PrintData( Th_NtkCountGate( p , Th_Pi ) , Th_NtkCountGate( p , Th_Po ) ,
+			        Th_NtkCountGate( p , Th_Node ) , Th_NtkCountLevel( p ) ,
+					  faninSizeList , fanoutSizeList );
+   Vec_IntFree( faninSizeList );
+   Vec_IntFree( fanoutSizeList );
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Write Th_Ntk_t as a .th file.]
+
+  Description [Same format as dumpTh2FileNZ().]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+void
+Th_NtkWriteTh( Th_Ntk_t * p , char * name )
+{
+	Th_Out_t * pFile;
+	int i , k , iFanin , Weight;
+
+	pFile = Th_OutStart( name , Th_OutFileMode(name) );
+	if ( pFile == NULL ) {
+		printf( "Th_NtkWriteTh() : cannot open file %s for writing.\n" , name );
+		return;
+	}
+	Th_OutStr( pFile , "Threshold logic gate list written by NZ.\n" );
+	Th_OutStr( pFile , ".model " );
+	Th_OutStr( pFile , name );
+	Th_OutStr( pFile , "\n.input" );
+	Th_NtkForEachObj( p , i )
+		if ( Th_NtkObjType( p , i ) == Th_Pi ) { Th_OutChar( pFile , ' ' ); Th_OutInt( pFile , i ); }
+	Th_OutStr( pFile , "\n.output" );
+	Th_NtkForEachObj( p , i )
+		if ( Th_NtkObjType( p , i ) == Th_Po ) { Th_OutChar( pFile , ' ' ); Th_OutInt( pFile , i ); }
+	Th_OutChar( pFile , '\n' );
+	Th_NtkForEachObj( p , i )
+	{
+		if ( Th_NtkObjType( p , i ) != Th_Po ) continue;
+		Th_OutStr( pFile , ".threshold " );
+		if ( Th_NtkObjFanin( p , i , 0 ) == 0 ) Th_OutStr( pFile , "CONST1" );
+		else Th_OutInt( pFile , Th_NtkObjFanin( p , i , 0 ) );
+		Th_OutChar( pFile , ' ' );
+		Th_OutInt( pFile , i );
+		Th_OutChar( pFile , '\n' );
+		Th_OutInt( pFile , Th_NtkObjWeight( p , i , 0 ) );
+		Th_OutChar( pFile , ' ' );
+		Th_OutInt( pFile , Th_NtkObjThre( p , i ) );
+		Th_OutChar( pFile , '\n' );
+	}
+	Th_NtkForEachNode( p , i )
+	{
+		Th_OutStr( pFile , ".threshold" );
+		Th_NtkObjForEachFanin( p , i , iFanin , Weight , k ) {
+			Th_OutChar( pFile , ' ' );
+			if ( iFanin == 0 ) Th_OutStr( pFile , "CONST1" );
+			else Th_OutInt( pFile , iFanin );
+		}
+		Th_OutChar( pFile , ' ' );
+		Th_OutInt( pFile , i );
+		Th_OutChar( pFile , '\n' );
+		Th_NtkObjForEachFanin( p , i , iFanin , Weight , k ) {
+			Th_OutInt( pFile , Weight );
+			Th_OutChar( pFile , ' ' );
+		}
+		Th_OutInt( pFile , Th_NtkObjThre( p , i ) );
+		Th_OutChar( pFile , '\n' );
+	}
+	Th_OutStop( pFile );
+}
+
+////////////////////////////////////////////////////////////////////////
+///                       END OF FILE                                ///
+////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,317 @@
+/**CFile****************************************************************
+
+  FileName    [threOut.c]
+
+  SystemName  [ABC: Logic synthesis and verification system.]
+
+  PackageName [threshold.]
+
+  Synopsis    [Buffered output of the text writers.]
+
+  Author      [ALCom Lab]
+
+  Affiliation [NTU]
+
+  Date        [Oct 16, 2026.]
+
+  Revision    [$Id: abc.c,v 1.00 2005/06/20 00:00:00 alanmi Exp $]
+
+***********************************************************************/
+
+////////////////////////////////////////////////////////////////////////
+///                          INCLUDES                                ///
+////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include "base/abc/abc.h"
+#include "misc/zlib/zlib.h"
+#include "misc/bzlib/bzlib.h"
+#include "threshold.h"
+
+////////////////////////////////////////////////////////////////////////
+///                        DECLARATIONS                              ///
+////////////////////////////////////////////////////////////////////////
+
+// the size of the output chunks
+#define TH_OUT_CHUNK  (1 << 20)
+
+// the text is collected in one chunk , which goes to the file ( or to
+// the compressor ) in a single call when it is full
+struct Th_Out_t_
+{
+    char *       pFileName;   // the file name
+    int          Mode;        // Th_OutMode_t
+    FILE *       pFile;       // the plain or bzip2 file
+    gzFile       pGz;         // the zlib stream
+    BZFILE *     pBz;         // the bzip2 stream
+    char *       pBuffer;     // the chunk
+    int          nSize;       // the bytes in the chunk
+    int          fError;      // a write has failed
+};
+
+////////////////////////////////////////////////////////////////////////
+///                     FUNCTION DEFINITIONS                         ///
+////////////////////////////////////////////////////////////////////////
+
+/**Function*************************************************************
+
+  Synopsis    [Compression of a file by its name.]
+
+  Description [Names ending with .gz are written through zlib and
+               names ending with .bz2 through bzip2.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+int Th_OutFileMode( char * pFileName )
+{
+    int nLen = strlen( pFileName );
+    if ( nLen > 3 && !strcmp( pFileName + nLen - 3, ".gz" ) )
+        return TH_OUT_GZ;
+    if ( nLen > 4 && !strcmp( pFileName + nLen - 4, ".bz2" ) )
+        return TH_OUT_BZ2;
+    return TH_OUT_PLAIN;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Opens a file for writing.]
+
+  Description [Mode is one of Th_OutMode_t. Returns NULL if the file
+               cannot be opened.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+Th_Out_t * Th_OutStart( char * pFileName, int Mode )
+{
+    Th_Out_t * p;
+    FILE * pFile = NULL;
+    gzFile pGz = NULL;
+    BZFILE * pBz = NULL;
+    int bzError;
+    assert( Mode >= 0 && Mode < TH_OUT_NUM );
+    if ( Mode == TH_OUT_GZ ) {
+        // the fastest level , which keeps pace with the writers
+        if ( (pGz = gzopen( pFileName, "wb1" )) == NULL )
+            return NULL;
+    }
+    else {
+        if ( (pFile = fopen( pFileName, Mode == TH_OUT_BZ2 ? "wb" : "w" )) == NULL )
+            return NULL;
+        if ( Mode == TH_OUT_BZ2 ) {
+            pBz = BZ2_bzWriteOpen( &bzError, pFile, 9, 0, 0 );
+            if ( bzError != BZ_OK ) {
+                BZ2_bzWriteClose( &bzError, pBz, 0, NULL, NULL );
+                fclose( pFile );
+                return NULL;
+            }
+        }
+    }
+    p = ABC_CALLOC( Th_Out_t, 1 );
+    p->pFileName = Abc_UtilStrsav( pFileName );
+    p->Mode      = Mode;
+    p->pFile     = pFile;
+    p->pGz       = pGz;
+    p->pBz       = pBz;
+    p->pBuffer   = ABC_ALLOC( char, TH_OUT_CHUNK );
+    return p;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Writes the chunk.]
+
+  Description []
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+static void Th_OutWrite( Th_Out_t * p, const char * pData, int nData )
+{
+    int bzError;
+    if ( nData == 0 || p->fError )
+        return;
+    if ( p->Mode == TH_OUT_GZ )
+        p->fError = ( gzwrite( p->pGz, (voidpc)pData, (unsigned)nData ) != nData );
+    else if ( p->Mode == TH_OUT_BZ2 ) {
+        BZ2_bzWrite( &bzError, p->pBz, (void *)pData, nData );
+        p->fError = ( bzError != BZ_OK );
+    }
+    else
+        p->fError = ( fwrite( pData, 1, (size_t)nData, p->pFile ) != (size_t)nData );
+}
+
+static inline void Th_OutFlush( Th_Out_t * p )
+{
+    Th_OutWrite( p, p->pBuffer, p->nSize );
+    p->nSize = 0;
+}
+
+// returns room for nBytes more bytes in the chunk
+static inline char * Th_OutReserve( Th_Out_t * p, int nBytes )
+{
+    assert( nBytes <= TH_OUT_CHUNK );
+    if ( p->nSize + nBytes > TH_OUT_CHUNK )
+        Th_OutFlush( p );
+    return p->pBuffer + p->nSize;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Closes the file.]
+
+  Description [Returns 1 if everything was written and 0 otherwise ;
+               the failure is reported.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+int Th_OutStop( Th_Out_t * p )
+{
+    int bzError, RetValue;
+    Th_OutFlush( p );
+    if ( p->Mode == TH_OUT_GZ ) {
+        if ( gzclose( p->pGz ) != Z_OK )
+            p->fError = 1;
+    }
+    else {
+        if ( p->Mode == TH_OUT_BZ2 ) {
+            BZ2_bzWriteClose( &bzError, p->pBz, p->fError, NULL, NULL );
+            if ( bzError != BZ_OK )
+                p->fError = 1;
+        }
+        if ( fclose( p->pFile ) != 0 )
+            p->fError = 1;
+    }
+    if ( p->fError )
+        printf( "Th_OutStop() : writing file \"%s\" has failed.\n", p->pFileName );
+    RetValue = !p->fError;
+    ABC_FREE( p->pBuffer );
+    ABC_FREE( p->pFileName );
+    ABC_FREE( p );
+    return RetValue;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Writes a character or a string.]
+
+  Description []
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+void Th_OutChar( Th_Out_t * p, char c )
+{
+    *Th_OutReserve( p, 1 ) = c;
+    p->nSize++;
+}
+
+void Th_OutStr( Th_Out_t * p, const char * pStr )
+{
+    int nLen = strlen( pStr );
+    if ( nLen > TH_OUT_CHUNK / 2 ) {
+        Th_OutFlush( p );
+        Th_OutWrite( p, pStr, nLen );
+        return;
+    }
+    memcpy( Th_OutReserve( p, nLen ), pStr, (size_t)nLen );
+    p->nSize += nLen;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Writes a decimal integer.]
+
+  Description [Th_OutCoef() also writes '+' before a positive number ,
+               as the coefficients of PB constraints are written.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+static inline void Th_OutNum( Th_Out_t * p, int Num, int fPlus )
+{
+    char Digits[12], * pCur = Th_OutReserve( p, 12 );
+    unsigned uNum = Num < 0 ? 0u - (unsigned)Num : (unsigned)Num;
+    int i = 0;
+    do Digits[i++] = (char)('0' + uNum % 10); while ( (uNum /= 10) );
+    if ( Num < 0 )
+        *pCur++ = '-';
+    else if ( fPlus && Num > 0 )
+        *pCur++ = '+';
+    while ( i )
+        *pCur++ = Digits[--i];
+    p->nSize = pCur - p->pBuffer;
+}
+
+void Th_OutInt( Th_Out_t * p, int Num )  { Th_OutNum( p, Num, 0 ); }
+void Th_OutCoef( Th_Out_t * p, int Num ) { Th_OutNum( p, Num, 1 ); }
+
+/**Function*************************************************************
+
+  Synopsis    [Writes a term of a PB constraint.]
+
+  Description [Writes Coef*<pName><Id> , or Coef*<pName> if Id is
+               negative.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+void Th_OutTerm( Th_Out_t * p, int Coef, const char * pName, int Id )
+{
+    Th_OutCoef( p, Coef );
+    Th_OutChar( p, '*' );
+    Th_OutStr( p, pName );
+    if ( Id >= 0 )
+        Th_OutInt( p, Id );
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Writes a DIMACS clause.]
+
+  Description [The literals are signed variables ; the clause ends with
+               " 0" and a new line.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+void Th_OutClause( Th_Out_t * p, int * pLits, int nLits )
+{
+    int k;
+    for ( k = 0; k < nLits; k++ ) {
+        // a number takes at most 11 of the 12 bytes reserved
+        Th_OutNum( p, pLits[k], 0 );
+        p->pBuffer[p->nSize++] = ' ';
+    }
+    Th_OutStr( p, "0\n" );
+}
+
+////////////////////////////////////////////////////////////////////////
+///                       END OF FILE                                ///
+////////////////////////////////////////////////////////////////////////
@@ -75,6 +75,15 @@ Th_ProfileInit()
 	thProfiler.numTwoFout         = 0;
 	thProfiler.numTwoFoutOk       = 0;
 	thProfiler.numNotThNode       = 0;
+   thProfiler.numPairCheck       = 0;
+   thProfiler.numPairCheckOk     = 0;
+   thProfiler.clkPairCheck       = 0;
+   thProfiler.numClpCheck        = 0;
+   thProfiler.numClpCheckTt      = 0;
+   thProfiler.numClpCheckSat     = 0;
+   thProfiler.numClpCheckUndec   = 0;
+   thProfiler.numClpCheckFail    = 0;
+   thProfiler.clkClpCheck        = 0;
 	// threshold --> mux redundancy test
    thProfiler.numRedundancy      = 0;
    for ( i = 0 ; i < 50 ; ++i ) thProfiler.redund[i] = 0;
@@ -109,6 +118,12 @@ Th_ProfilePrint()
 	printf( "\tNumber of two fanouts        = %d\n" , thProfiler.numTwoFout          );
 	printf( "\tNumber of two fanouts Ok     = %d\n" , thProfiler.numTwoFoutOk        );
 	printf( "\tNumber of none Th nodes      = %d\n" , thProfiler.numNotThNode        );
+	printf( "\tNumber of pair checks        = %d\n" , thProfiler.numPairCheck        );
+	printf( "\tNumber of pair checks Ok     = %d\n" , thProfiler.numPairCheckOk      );
+	Abc_PrintTime( 1 , "\tTime of pair checks         " , thProfiler.clkPairCheck );
+	printf( "\tNumber of local certificates = %d\n" , thProfiler.numClpCheck         );
+	printf( "\tNumber of local cert. failed = %d\n" , thProfiler.numClpCheckFail     );
+	Abc_PrintTime( 1 , "\tTime of local certificates  " , thProfiler.clkClpCheck );
 }
 
 int
@@ -0,0 +1,707 @@
+/**CFile****************************************************************
+
+  FileName    [threSim.c]
+
+  SystemName  [ABC: Logic synthesis and verification system.]
+
+  PackageName [threshold.]
+
+  Synopsis    [Bit-parallel simulation of TL networks.]
+
+  Author      [ALCom Lab]
+
+  Affiliation [NTU]
+
+  Date        [Oct 16, 2026.]
+
+  Revision    [$Id: abc.c,v 1.00 2005/06/20 00:00:00 alanmi Exp $]
+
+***********************************************************************/
+
+////////////////////////////////////////////////////////////////////////
+///                          INCLUDES                                ///
+////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include "base/abc/abc.h"
+#include "aig/gia/gia.h"
+#include "misc/util/utilTruth.h"
+#include "threshold.h"
+
+// the vector kernels are compiled for their own targets , so the rest of
+// ABC keeps the default flags ; arch_flags defines these on x86 hosts
+#if defined(ABC_USE_SSE2) || defined(ABC_USE_AVX2)
+#include <immintrin.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////
+///                        DECLARATIONS                              ///
+////////////////////////////////////////////////////////////////////////
+
+// the sum of a gate is kept bit-sliced : slice b holds bit b of the sums
+// of 64 patterns , so adding a weight costs a ripple over its set bits
+#define TH_SIM_SLICE_MAX  32
+#define TH_SIM_FANIN_MAX  256
+
+static char * Th_SimKernelNames[TH_SIM_NUM] = { "auto", "word", "sse2", "avx2" };
+
+////////////////////////////////////////////////////////////////////////
+///                     FUNCTION DEFINITIONS                         ///
+////////////////////////////////////////////////////////////////////////
+
+/**Function*************************************************************
+
+  Synopsis    [Topological order of the PO cones.]
+
+  Description [Iterative DFS from the POs over the fanins ; the list
+               order is not topological after collapsing. Returns the
+               ids of the objects other than the constant.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+Vec_Int_t * Th_SimOrder( Vec_Ptr_t * TList )
+{
+    Vec_Int_t * vOrder = Vec_IntAlloc( Vec_PtrSize(TList) );
+    Vec_Int_t * vStack = Vec_IntAlloc( 100 );
+    Vec_Str_t * vMark  = Vec_StrStart( Vec_PtrSize(TList) ); // 1 : entered ; 2 : done
+    Thre_S * tObj, * tRoot;
+    int i, Id, finId, k;
+    Vec_PtrForEachEntry( Thre_S*, TList, tRoot, i ) {
+        if ( tRoot == NULL || tRoot->Type != Th_Po ) continue;
+        Vec_IntPush( vStack, tRoot->Id );
+        while ( Vec_IntSize(vStack) ) {
+            Id   = Vec_IntEntryLast( vStack );
+            tObj = (Thre_S*)Vec_PtrEntry( TList, Id );
+            if ( Vec_StrEntry(vMark, Id) == 2 ) {
+                Vec_IntPop( vStack );
+                continue;
+            }
+            if ( Vec_StrEntry(vMark, Id) == 1 ) {
+                Vec_StrWriteEntry( vMark, Id, 2 );
+                Vec_IntPop( vStack );
+                if ( tObj->Type != Th_CONST1 )
+                    Vec_IntPush( vOrder, Id );
+                continue;
+            }
+            Vec_StrWriteEntry( vMark, Id, 1 );
+            Vec_IntForEachEntry( tObj->Fanins, finId, k )
+                if ( Vec_StrEntry(vMark, finId) == 0 )
+                    Vec_IntPush( vStack, finId );
+        }
+    }
+    Vec_IntFree( vStack );
+    Vec_StrFree( vMark );
+    return vOrder;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Gate evaluation kernels.]
+
+  Description [Each kernel evaluates tObj over the pattern words from
+               kStart on , ppFans[i] giving the words of the i-th fanin ,
+               and returns where it stopped ; the vector ones
+               stop before a partial vector and leave the tail to the
+               word kernel. A negative weight w is applied as |w| on
+               the complemented fanin , thre being raised by |w| by the
+               caller. The weighted sum is accumulated in nSlices
+               bit-sliced vertical counters and compared with thre
+               slice by slice from the most significant one.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+static int Th_SimObjWord( Thre_S * tObj, word ** ppFans, word * pOut, int nWords, int thre, int nSlices, int kStart )
+{
+    word Slices[TH_SIM_SLICE_MAX], Carry, Fan, Gt, Eq, Tmp;
+    int i, j, b, k, w;
+    for ( k = kStart; k < nWords; k++ ) {
+        for ( b = 0; b < nSlices; b++ )
+            Slices[b] = 0;
+        Vec_IntForEachEntry( tObj->weights, w, i ) {
+            Fan = ppFans[i][k];
+            if ( w < 0 ) { Fan = ~Fan; w = -w; }
+            for ( b = 0; w; b++, w >>= 1 ) {
+                if ( !(w & 1) ) continue;
+                for ( Carry = Fan, j = b; Carry; j++ ) {
+                    Tmp = Slices[j] & Carry;
+                    Slices[j] ^= Carry;
+                    Carry = Tmp;
+                }
+            }
+        }
+        // sum >= thre
+        Gt = 0; Eq = ~(word)0;
+        for ( b = nSlices - 1; b >= 0; b-- ) {
+            if ( (thre >> b) & 1 )
+                Eq &= Slices[b];
+            else {
+                Gt |= Eq & Slices[b];
+                Eq &= ~Slices[b];
+            }
+        }
+        pOut[k] = Gt | Eq;
+    }
+    return k;
+}
+
+#ifdef ABC_USE_SSE2
+
+__attribute__((target("sse2")))
+static int Th_SimObjSse2( Thre_S * tObj, word ** ppFans, word * pOut, int nWords, int thre, int nSlices, int kStart )
+{
+    __m128i Slices[TH_SIM_SLICE_MAX], Carry, Fan, Gt, Eq, Tmp;
+    __m128i Zero = _mm_setzero_si128(), Ones = _mm_set1_epi32( -1 );
+    int i, j, b, k, w;
+    for ( k = kStart; k + 2 <= nWords; k += 2 ) {
+        for ( b = 0; b < nSlices; b++ )
+            Slices[b] = Zero;
+        Vec_IntForEachEntry( tObj->weights, w, i ) {
+            Fan = _mm_loadu_si128( (__m128i *)(ppFans[i] + k) );
+            if ( w < 0 ) { Fan = _mm_xor_si128( Fan, Ones ); w = -w; }
+            for ( b = 0; w; b++, w >>= 1 ) {
+                if ( !(w & 1) ) continue;
+                for ( Carry = Fan, j = b; j < nSlices; j++ ) {
+                    Tmp = _mm_and_si128( Slices[j], Carry );
+                    Slices[j] = _mm_xor_si128( Slices[j], Carry );
+                    Carry = Tmp;
+                    if ( _mm_movemask_epi8( _mm_cmpeq_epi8(Carry, Zero) ) == 0xFFFF )
+                        break;
+                }
+            }
+        }
+        Gt = Zero; Eq = Ones;
+        for ( b = nSlices - 1; b >= 0; b-- ) {
+            if ( (thre >> b) & 1 )
+                Eq = _mm_and_si128( Eq, Slices[b] );
+            else {
+                Gt = _mm_or_si128( Gt, _mm_and_si128(Eq, Slices[b]) );
+                Eq = _mm_andnot_si128( Slices[b], Eq );
+            }
+        }
+        _mm_storeu_si128( (__m128i *)(pOut + k), _mm_or_si128(Gt, Eq) );
+    }
+    return k;
+}
+
+#endif
+
+#ifdef ABC_USE_AVX2
+
+__attribute__((target("avx2")))
+static int Th_SimObjAvx2( Thre_S * tObj, word ** ppFans, word * pOut, int nWords, int thre, int nSlices, int kStart )
+{
+    __m256i Slices[TH_SIM_SLICE_MAX], Carry, Fan, Gt, Eq, Tmp;
+    __m256i Zero = _mm256_setzero_si256(), Ones = _mm256_set1_epi32( -1 );
+    int i, j, b, k, w;
+    for ( k = kStart; k + 4 <= nWords; k += 4 ) {
+        for ( b = 0; b < nSlices; b++ )
+            Slices[b] = Zero;
+        Vec_IntForEachEntry( tObj->weights, w, i ) {
+            Fan = _mm256_loadu_si256( (__m256i *)(ppFans[i] + k) );
+            if ( w < 0 ) { Fan = _mm256_xor_si256( Fan, Ones ); w = -w; }
+            for ( b = 0; w; b++, w >>= 1 ) {
+                if ( !(w & 1) ) continue;
+                for ( Carry = Fan, j = b; j < nSlices; j++ ) {
+                    Tmp = _mm256_and_si256( Slices[j], Carry );
+                    Slices[j] = _mm256_xor_si256( Slices[j], Carry );
+                    Carry = Tmp;
+                    if ( _mm256_testz_si256( Carry, Carry ) )
+                        break;
+                }
+            }
+        }
+        Gt = Zero; Eq = Ones;
+        for ( b = nSlices - 1; b >= 0; b-- ) {
+            if ( (thre >> b) & 1 )
+                Eq = _mm256_and_si256( Eq, Slices[b] );
+            else {
+                Gt = _mm256_or_si256( Gt, _mm256_and_si256(Eq, Slices[b]) );
+                Eq = _mm256_andnot_si256( Slices[b], Eq );
+            }
+        }
+        _mm256_storeu_si256( (__m256i *)(pOut + k), _mm256_or_si256(Gt, Eq) );
+    }
+    return k;
+}
+
+#endif
+
+/**Function*************************************************************
+
+  Synopsis    [Kernels compiled into this build.]
+
+  Description []
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+int Th_SimKernelAvail( int Kernel )
+{
+    if ( Kernel == TH_SIM_AUTO || Kernel == TH_SIM_WORD )
+        return 1;
+#ifdef ABC_USE_SSE2
+    if ( Kernel == TH_SIM_SSE2 )
+        return 1;
+#endif
+#ifdef ABC_USE_AVX2
+    if ( Kernel == TH_SIM_AVX2 )
+        return 1;
+#endif
+    return 0;
+}
+
+char * Th_SimKernelName( int Kernel )
+{
+    assert( Kernel >= 0 && Kernel < TH_SIM_NUM );
+    return Th_SimKernelNames[Kernel];
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Evaluates one gate over nWords words of patterns.]
+
+  Description [Th_SimObjFans() reads the words of the i-th fanin from
+               ppFans[i] and writes pOut ; Th_SimObj() reads them from
+               pSims , which holds nWords words per object id. The
+               kernel is thSimKernel , the widest one available if it is
+               TH_SIM_AUTO.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+void Th_SimObjFans( Thre_S * tObj, word ** ppFans, word * pOut, int nWords )
+{
+    int i, w, k = 0, Kernel = thSimKernel, thre = tObj->thre, Sum = 0, nSlices;
+    Vec_IntForEachEntry( tObj->weights, w, i ) {
+        if ( w < 0 ) thre -= w;
+        Sum += Abc_AbsInt( w );
+    }
+    if ( thre <= 0 || thre > Sum ) {
+        for ( k = 0; k < nWords; k++ )
+            pOut[k] = thre <= 0 ? ~(word)0 : 0;
+        return;
+    }
+    nSlices = Abc_Base2Log( Sum + 1 );
+    assert( nSlices <= TH_SIM_SLICE_MAX );
+    if ( Kernel == TH_SIM_AUTO )
+        Kernel = Th_SimKernelAvail(TH_SIM_AVX2) ? TH_SIM_AVX2 : (Th_SimKernelAvail(TH_SIM_SSE2) ? TH_SIM_SSE2 : TH_SIM_WORD);
+#ifdef ABC_USE_AVX2
+    if ( Kernel == TH_SIM_AVX2 )
+        k = Th_SimObjAvx2( tObj, ppFans, pOut, nWords, thre, nSlices, k );
+#endif
+#ifdef ABC_USE_SSE2
+    if ( Kernel == TH_SIM_SSE2 || Kernel == TH_SIM_AVX2 )
+        k = Th_SimObjSse2( tObj, ppFans, pOut, nWords, thre, nSlices, k );
+#endif
+    Th_SimObjWord( tObj, ppFans, pOut, nWords, thre, nSlices, k );
+}
+
+void Th_SimObj( Thre_S * tObj, word * pSims, int nWords )
+{
+    word * pFans[TH_SIM_FANIN_MAX], ** ppFans = pFans;
+    int i, finId;
+    if ( Vec_IntSize(tObj->Fanins) > TH_SIM_FANIN_MAX )
+        ppFans = ABC_ALLOC( word *, Vec_IntSize(tObj->Fanins) );
+    Vec_IntForEachEntry( tObj->Fanins, finId, i )
+        ppFans[i] = pSims + finId * nWords;
+    Th_SimObjFans( tObj, ppFans, pSims + tObj->Id * nWords, nWords );
+    if ( ppFans != pFans )
+        ABC_FREE( ppFans );
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Simulates a network.]
+
+  Description [pPiSims holds nWords words per PI , in the order of the
+               PIs in the list , which is how the two networks of a
+               check share their inputs. Returns nWords words per
+               object id ; objects outside the PO cones are left at 0.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+Vec_Wrd_t * Th_SimNtk( Vec_Ptr_t * TList, word * pPiSims, int nWords )
+{
+    Vec_Wrd_t * vSims  = Vec_WrdStart( Vec_PtrSize(TList) * nWords );
+    Vec_Int_t * vOrder = Th_SimOrder( TList );
+    word * pSims = Vec_WrdArray( vSims );
+    Thre_S * tObj;
+    int i, k, Id, iPi = 0;
+    Vec_PtrForEachEntry( Thre_S*, TList, tObj, i ) {
+        if ( tObj && tObj->Type == Th_CONST1 )
+            for ( k = 0; k < nWords; k++ )
+                pSims[i * nWords + k] = ~(word)0;
+        if ( tObj && tObj->Type == Th_Pi )
+            memcpy( pSims + i * nWords, pPiSims + (iPi++) * nWords, sizeof(word) * nWords );
+    }
+    Vec_IntForEachEntry( vOrder, Id, i ) {
+        tObj = (Thre_S*)Vec_PtrEntry( TList, Id );
+        if ( tObj->Type != Th_Pi )
+            Th_SimObj( tObj, pSims, nWords );
+    }
+    Vec_IntFree( vOrder );
+    return vSims;
+}
+
+static int Th_SimPiNum( Vec_Ptr_t * TList )
+{
+    Thre_S * tObj;
+    int i, nPis = 0;
+    Vec_PtrForEachEntry( Thre_S*, TList, tObj, i )
+        nPis += ( tObj && tObj->Type == Th_Pi );
+    return nPis;
+}
+
+static Vec_Ptr_t * Th_SimPos( Vec_Ptr_t * TList )
+{
+    Vec_Ptr_t * vPos = Vec_PtrAlloc( 100 );
+    Thre_S * tObj;
+    int i;
+    Vec_PtrForEachEntry( Thre_S*, TList, tObj, i )
+        if ( tObj && tObj->Type == Th_Po )
+            Vec_PtrPush( vPos, tObj );
+    return vPos;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Reads input patterns.]
+
+  Description [One pattern per line , a 0/1 character per PI in the
+               order of the PIs ; empty lines and lines starting with
+               '#' are skipped. Pattern j goes to bit j of the PI words
+               in vPiSims. Returns the number of patterns or -1 on
+               error.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+static int Th_SimReadPatterns( char * pFileName, Vec_Wrd_t * vPiSims, int nPis )
+{
+    Th_Tok_t * pTok = Th_TokStart( pFileName );
+    char * pBeg, * pEnd;
+    int i, nWords, nPats = 0;
+    if ( pTok == NULL ) {
+        printf( "\tCannot open pattern file \"%s\".\n", pFileName );
+        return -1;
+    }
+    Vec_WrdFill( vPiSims, nPis, 0 );
+    while ( Th_TokNext( pTok, &pBeg, &pEnd ) ) {
+        if ( *pBeg == '#' ) {
+            Th_TokSkipLine( pTok );
+            continue;
+        }
+        for ( i = 0; pBeg + i < pEnd && (pBeg[i] == '0' || pBeg[i] == '1'); i++ );
+        if ( i != nPis || pBeg + i != pEnd ) {
+            printf( "\tLine %d of \"%s\" is not a pattern of %d PIs.\n", Th_TokLine(pTok), pFileName, nPis );
+            nPats = -1;
+            break;
+        }
+        // make room for 64 more patterns
+        nWords = Vec_WrdSize(vPiSims) / nPis;
+        if ( nPats == 64 * nWords ) {
+            Vec_Wrd_t * vNew = Vec_WrdStart( nPis * (nWords + 1) );
+            for ( i = 0; i < nPis; i++ )
+                memcpy( Vec_WrdEntryP(vNew, i * (nWords + 1)), Vec_WrdEntryP(vPiSims, i * nWords), sizeof(word) * nWords );
+            ABC_SWAP( Vec_Wrd_t, *vNew, *vPiSims );
+            Vec_WrdFree( vNew );
+            nWords++;
+        }
+        for ( i = 0; i < nPis; i++ )
+            if ( pBeg[i] == '1' )
+                Abc_TtSetBit( Vec_WrdEntryP(vPiSims, i * nWords), nPats );
+        nPats++;
+    }
+    Th_TokStop( pTok );
+    return nPats;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Random PI patterns.]
+
+  Description [Returns nWords words per PI ; the first nUser patterns
+               are taken from vUser if given. The generator is reset ,
+               so the same call gives the same patterns.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+static Vec_Wrd_t * Th_SimPiPatterns( int nPis, int nWords, Vec_Wrd_t * vUser, int nUser )
+{
+    Vec_Wrd_t * vPiSims = Vec_WrdStart( nPis * nWords );
+    int i, k, nOld = vUser && nPis ? Vec_WrdSize(vUser) / nPis : 0;
+    Gia_ManRandomW( 1 );
+    for ( i = 0; i < nPis; i++ ) {
+        word * pSim = Vec_WrdEntryP( vPiSims, i * nWords );
+        for ( k = 0; k < nWords; k++ )
+            pSim[k] = Gia_ManRandomW( 0 );
+        for ( k = 0; k < nUser / 64; k++ )
+            pSim[k] = Vec_WrdEntry( vUser, i * nOld + k );
+        // the bits after the user patterns of the last user word stay random
+        if ( nUser % 64 )
+            pSim[k] = (Vec_WrdEntry(vUser, i * nOld + k) & Abc_Tt6Mask(nUser % 64)) | (pSim[k] & ~Abc_Tt6Mask(nUser % 64));
+    }
+    return vPiSims;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Compares two networks by simulation.]
+
+  Description [Simulates nRandWords words of random patterns , after
+               the patterns of pFileName if given. The POs and the PIs
+               are matched by position. vCexes gets one entry per PO :
+               the first input pattern under which the outputs differ ,
+               as a 0/1 string over the PIs , or NULL. Returns the
+               number of differing POs or -1 on error.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+int Th_SimCompare( Vec_Ptr_t * tList_1, Vec_Ptr_t * tList_2, char * pFileName, int nRandWords, Vec_Ptr_t * vCexes )
+{
+    abctime clk = Abc_Clock();
+    Vec_Ptr_t * vPos_1 = Th_SimPos( tList_1 );
+    Vec_Ptr_t * vPos_2 = Th_SimPos( tList_2 );
+    Vec_Wrd_t * vUser = NULL, * vPiSims, * vSims_1, * vSims_2;
+    Thre_S * tObj, * tPo_2;
+    int nPis = Th_SimPiNum( tList_1 );
+    int i, k, j, iBit, nWords, nUser = 0, nDiff = 0;
+    word * pSim_1, * pSim_2;
+
+    Vec_PtrClear( vCexes );
+    if ( Vec_PtrSize(vPos_1) != Vec_PtrSize(vPos_2) || nPis != Th_SimPiNum(tList_2) ) {
+        printf("\tERROR: two network have different # of PIs or POs\n");
+        Vec_PtrFree( vPos_1 );
+        Vec_PtrFree( vPos_2 );
+        return -1;
+    }
+    // the user patterns first , then the random ones
+    if ( pFileName ) {
+        vUser = Vec_WrdAlloc( 0 );
+        nUser = Th_SimReadPatterns( pFileName, vUser, nPis );
+        if ( nUser < 0 ) {
+            Vec_WrdFree( vUser );
+            Vec_PtrFree( vPos_1 );
+            Vec_PtrFree( vPos_2 );
+            return -1;
+        }
+    }
+    nWords  = Abc_MaxInt( (nUser + 63) / 64 + nRandWords, 1 );
+    vPiSims = Th_SimPiPatterns( nPis, nWords, vUser, nUser );
+    if ( vUser ) Vec_WrdFree( vUser );
+
+    vSims_1 = Th_SimNtk( tList_1, Vec_WrdArray(vPiSims), nWords );
+    vSims_2 = Th_SimNtk( tList_2, Vec_WrdArray(vPiSims), nWords );
+    Vec_PtrForEachEntry( Thre_S*, vPos_1, tObj, i ) {
+        tPo_2  = (Thre_S*)Vec_PtrEntry( vPos_2, i );
+        pSim_1 = Vec_WrdEntryP( vSims_1, tObj->Id * nWords );
+        pSim_2 = Vec_WrdEntryP( vSims_2, tPo_2->Id * nWords );
+        for ( k = 0; k < nWords; k++ )
+            if ( pSim_1[k] != pSim_2[k] )
+                break;
+        if ( k == nWords ) {
+            Vec_PtrPush( vCexes, NULL );
+            continue;
+        }
+        iBit = 64 * k + Abc_Tt6FirstBit( pSim_1[k] ^ pSim_2[k] );
+        {
+            char * pCex = ABC_ALLOC( char, nPis + 1 );
+            for ( j = 0; j < nPis; j++ )
+                pCex[j] = '0' + Abc_TtGetBit( Vec_WrdEntryP(vPiSims, j * nWords), iBit );
+            pCex[nPis] = '\0';
+            Vec_PtrPush( vCexes, pCex );
+        }
+        nDiff++;
+    }
+    printf( "\tSimulation : %d patterns ( %d given ) , %d of %d outputs differ.  ", 64 * nWords, nUser, nDiff, Vec_PtrSize(vPos_1) );
+    Abc_PrintTime( 1, "Time", Abc_Clock() - clk );
+    Vec_WrdFree( vSims_1 );
+    Vec_WrdFree( vSims_2 );
+    Vec_WrdFree( vPiSims );
+    Vec_PtrFree( vPos_1 );
+    Vec_PtrFree( vPos_2 );
+    return nDiff;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Reports the first output refuted by Th_SimCompare().]
+
+  Description []
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+void Th_SimPrintCex( Vec_Ptr_t * tList_1, Vec_Ptr_t * vCexes )
+{
+    Thre_S * tObj;
+    int i, iPo = 0;
+    Vec_PtrForEachEntry( Thre_S*, tList_1, tObj, i ) {
+        if ( tObj == NULL || tObj->Type != Th_Po ) continue;
+        if ( Vec_PtrEntry(vCexes, iPo) ) {
+            printf("\tNetworks are NOT EQUIVALENT. Output \"%s\" differs under the input pattern:\n", tObj->pName );
+            printf("\t%s\n", (char*)Vec_PtrEntry(vCexes, iPo) );
+            return;
+        }
+        iPo++;
+    }
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Replays a counterexample.]
+
+  Description [pCex gives a 0/1 character per PI , '-' being taken as
+               0. Returns 1 if PO iPo of the two networks differs under
+               it.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+int Th_SimCexCheck( Vec_Ptr_t * tList_1, Vec_Ptr_t * tList_2, char * pCex, int iPo )
+{
+    Vec_Ptr_t * vPos_1 = Th_SimPos( tList_1 );
+    Vec_Ptr_t * vPos_2 = Th_SimPos( tList_2 );
+    int i, nPis = Th_SimPiNum( tList_1 ), RetValue;
+    Vec_Wrd_t * vPiSims = Vec_WrdStart( nPis ), * vSims_1, * vSims_2;
+    assert( (int)strlen(pCex) == nPis );
+    for ( i = 0; i < nPis; i++ )
+        Vec_WrdWriteEntry( vPiSims, i, pCex[i] == '1' ? ~(word)0 : 0 );
+    vSims_1 = Th_SimNtk( tList_1, Vec_WrdArray(vPiSims), 1 );
+    vSims_2 = Th_SimNtk( tList_2, Vec_WrdArray(vPiSims), 1 );
+    RetValue = Vec_WrdEntry( vSims_1, ((Thre_S*)Vec_PtrEntry(vPos_1, iPo))->Id ) !=
+               Vec_WrdEntry( vSims_2, ((Thre_S*)Vec_PtrEntry(vPos_2, iPo))->Id );
+    Vec_WrdFree( vSims_1 );
+    Vec_WrdFree( vSims_2 );
+    Vec_WrdFree( vPiSims );
+    Vec_PtrFree( vPos_1 );
+    Vec_PtrFree( vPos_2 );
+    return RetValue;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Signature of a network.]
+
+  Description [The PO words under nWords words of the fixed random
+               patterns , in the order of the POs. Networks with the
+               same PIs and POs have the same signature if they are
+               equivalent ; merge_th -c compares the signatures taken
+               before and after collapsing.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+Vec_Wrd_t * Th_SimSignature( Vec_Ptr_t * TList, int nWords )
+{
+    Vec_Ptr_t * vPos    = Th_SimPos( TList );
+    Vec_Wrd_t * vPiSims = Th_SimPiPatterns( Th_SimPiNum(TList), nWords, NULL, 0 );
+    Vec_Wrd_t * vSims   = Th_SimNtk( TList, Vec_WrdArray(vPiSims), nWords );
+    Vec_Wrd_t * vSign   = Vec_WrdAlloc( Vec_PtrSize(vPos) * nWords );
+    Thre_S * tObj;
+    int i, k;
+    Vec_PtrForEachEntry( Thre_S*, vPos, tObj, i )
+        for ( k = 0; k < nWords; k++ )
+            Vec_WrdPush( vSign, Vec_WrdEntry(vSims, tObj->Id * nWords + k) );
+    Vec_WrdFree( vSims );
+    Vec_WrdFree( vPiSims );
+    Vec_PtrFree( vPos );
+    return vSign;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Measures the simulation speed.]
+
+  Description [Simulates TList nRounds times over nWords words of
+               random patterns with every kernel in this build , or
+               with Kernel alone , checks that they agree and reports
+               the patterns per second.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+void Th_SimBench( Vec_Ptr_t * TList, int nWords, int nRounds, int Kernel )
+{
+    Vec_Wrd_t * vPiSims = Th_SimPiPatterns( Th_SimPiNum(TList), nWords, NULL, 0 );
+    Vec_Wrd_t * vSims = NULL, * vGold = NULL;
+    int i, r, KernelOld = thSimKernel, KernelGold = -1, nGates = 0;
+    Thre_S * tObj;
+    abctime clk;
+    Vec_PtrForEachEntry( Thre_S*, TList, tObj, i )
+        nGates += ( tObj && (tObj->Type == Th_Node || tObj->Type == Th_Po) );
+    printf( "\tSimulating %d gates over %d patterns %d times.\n", nGates, 64 * nWords, nRounds );
+    for ( i = TH_SIM_WORD; i < TH_SIM_NUM; i++ ) {
+        if ( !Th_SimKernelAvail(i) || (Kernel != TH_SIM_AUTO && Kernel != i) )
+            continue;
+        thSimKernel = i;
+        clk = Abc_Clock();
+        for ( r = 0; r < nRounds; r++ ) {
+            if ( vSims ) Vec_WrdFree( vSims );
+            vSims = Th_SimNtk( TList, Vec_WrdArray(vPiSims), nWords );
+        }
+        clk = Abc_Clock() - clk;
+        printf( "\tKernel %-5s : %10.3f Mpatterns/sec  %12.3f Mgate-patterns/sec  ", Th_SimKernelName(i),
+            1.0 * nRounds * 64 * nWords / Abc_MaxInt(1, clk) * CLOCKS_PER_SEC / 1000000,
+            1.0 * nRounds * 64 * nWords * nGates / Abc_MaxInt(1, clk) * CLOCKS_PER_SEC / 1000000 );
+        Abc_PrintTime( 1, "Time", clk );
+        if ( vGold == NULL ) {
+            vGold = vSims;
+            KernelGold = i;
+        }
+        else {
+            if ( !Vec_WrdEqual( vGold, vSims ) )
+                printf( "\tKernel %-5s : MISMATCH with kernel %s.\n", Th_SimKernelName(i), Th_SimKernelName(KernelGold) );
+            Vec_WrdFree( vSims );
+        }
+        vSims = NULL;
+    }
+    thSimKernel = KernelOld;
+    if ( vGold ) Vec_WrdFree( vGold );
+    Vec_WrdFree( vPiSims );
+}
+
+////////////////////////////////////////////////////////////////////////
+///                       END OF FILE                                ///
+////////////////////////////////////////////////////////////////////////
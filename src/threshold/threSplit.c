@@ -0,0 +1,413 @@
+/**CFile****************************************************************
+
+  FileName    [threSplit.c]
+
+  SystemName  [ABC: Logic synthesis and verification system.]
+
+  PackageName [threshold.]
+
+  Synopsis    [Output-partitioned equivalence checking of TL networks.]
+
+  Author      [ALCom Lab]
+
+  Affiliation [NTU]
+
+  Date        [Oct 16, 2026.]
+
+  Revision    [$Id: abc.c,v 1.00 2005/06/20 00:00:00 alanmi Exp $]
+
+***********************************************************************/
+
+////////////////////////////////////////////////////////////////////////
+///                          INCLUDES                                ///
+////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include "base/abc/abc.h"
+#include "threshold.h"
+
+#ifdef ABC_USE_PTHREADS
+
+#ifdef _WIN32
+#include "../lib/pthread.h"
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#endif
+
+////////////////////////////////////////////////////////////////////////
+///                        DECLARATIONS                              ///
+////////////////////////////////////////////////////////////////////////
+
+#define TH_SPLIT_THR_MAX 100
+
+// the check of one pair of primary outputs
+typedef struct Th_SplitJob_t_ Th_SplitJob_t;
+struct Th_SplitJob_t_
+{
+    int         iPo;       // the index of the output pair
+    int         Status;    // 1 : differ ; 0 : equivalent ; -1 : undecided
+    int         nVars;     // variables of the miter
+    int         nClauses;  // clauses of the miter
+    int         nConfs;    // conflicts of the SAT call
+    abctime     Time;      // runtime of the whole job
+    int         fSim;      // refuted by simulation , not solved
+    char      * pCex;      // values of the PIs of the first network ( '-' outside the cone )
+};
+
+// the problem shared by all jobs ; read-only while the jobs run
+typedef struct Th_SplitMan_t_ Th_SplitMan_t;
+struct Th_SplitMan_t_
+{
+    Vec_Ptr_t * tList_1;
+    Vec_Ptr_t * tList_2;
+    Vec_Ptr_t * vPos_1;    // Th_Po objects of the first network
+    Vec_Ptr_t * vPos_2;    // Th_Po objects of the second network
+    int         Encoding;
+    int         nConfLimit;
+    int         nTimeLimit;
+};
+
+////////////////////////////////////////////////////////////////////////
+///                     FUNCTION DEFINITIONS                         ///
+////////////////////////////////////////////////////////////////////////
+
+/**Function*************************************************************
+
+  Synopsis    [Writes the cone of one output.]
+
+  Description [Th_SplitMarkCone() marks the transitive fanin of pRoot
+               in vMark and returns the number of marked objects other
+               than the constant. Th_SplitWriteCone() then writes the
+               marked gates in the list order ; the variables are given
+               on demand , from vMapPi for the PIs ( matched by Id
+               between the two networks ) and from vMap for the gates.
+               It returns the variable of pRoot.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+static int Th_SplitMarkCone( Vec_Ptr_t * TList, Thre_S * pRoot, Vec_Int_t * vMark )
+{
+    Vec_Int_t * vStack = Vec_IntAlloc( 100 );
+    Thre_S * tObj;
+    int j, finId, nObjs = 0;
+    Vec_IntFill( vMark, Vec_PtrSize(TList), 0 );
+    Vec_IntWriteEntry( vMark, pRoot->Id, 1 );
+    Vec_IntPush( vStack, pRoot->Id );
+    while ( Vec_IntSize(vStack) ) {
+        tObj = (Thre_S*)Vec_PtrEntry( TList, Vec_IntPop(vStack) );
+        nObjs += (tObj->Type != Th_CONST1);
+        Vec_IntForEachEntry( tObj->Fanins, finId, j )
+            if ( !Vec_IntEntry(vMark, finId) ) {
+                Vec_IntWriteEntry( vMark, finId, 1 );
+                Vec_IntPush( vStack, finId );
+            }
+    }
+    Vec_IntFree( vStack );
+    return nObjs;
+}
+
+static inline int Th_SplitVar( Vec_Int_t * vMap, int Id, int * pnVars )
+{
+    if ( Vec_IntEntry(vMap, Id) == 0 )
+        Vec_IntWriteEntry( vMap, Id, ++(*pnVars) );
+    return Vec_IntEntry( vMap, Id );
+}
+
+static int Th_SplitWriteCone( Th_CnfMan_t * pCnf, Vec_Ptr_t * TList, Thre_S * pRoot, Vec_Int_t * vMapPi, Vec_Int_t * vMap, Vec_Int_t * vMark, int * pnVars )
+{
+    Vec_Int_t * vFanVars = Vec_IntAlloc( 10 );
+    Thre_S * tObj, * finObj;
+    int i, j, finId;
+    Vec_PtrForEachEntry( Thre_S*, TList, tObj, i ) {
+        if ( tObj == NULL || !Vec_IntEntry(vMark, i) ) continue;
+        if ( tObj->Type == Th_Pi || tObj->Type == Th_CONST1 ) continue;
+        Vec_IntClear( vFanVars );
+        Vec_IntForEachEntry( tObj->Fanins, finId, j ) {
+            finObj = (Thre_S*)Vec_PtrEntry( TList, finId );
+            if ( finObj->Type == Th_CONST1 )
+                Vec_IntPush( vFanVars, 0 );
+            else
+                Vec_IntPush( vFanVars, Th_SplitVar( finObj->Type == Th_Pi ? vMapPi : vMap, finId, pnVars ) );
+        }
+        Th_CnfWriteObj( pCnf, tObj, vFanVars, Th_SplitVar( vMap, i, pnVars ) );
+    }
+    Vec_IntFree( vFanVars );
+    return Vec_IntEntry( vMap, pRoot->Id );
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Checks one pair of outputs.]
+
+  Description [Builds the miter of the two output cones alone and
+               solves it under the per-output budgets. Touches nothing
+               but its own job , so the jobs may run in parallel.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+static void Th_SplitSolveOne( Th_SplitMan_t * p, Th_SplitJob_t * pJob )
+{
+    abctime clk = Abc_Clock();
+    Thre_S * pPo_1 = (Thre_S*)Vec_PtrEntry( p->vPos_1, pJob->iPo );
+    Thre_S * pPo_2 = (Thre_S*)Vec_PtrEntry( p->vPos_2, pJob->iPo );
+    Vec_Int_t * vMapPi = Vec_IntStart( Abc_MaxInt(Vec_PtrSize(p->tList_1), Vec_PtrSize(p->tList_2)) );
+    Vec_Int_t * vMap_1 = Vec_IntStart( Vec_PtrSize(p->tList_1) );
+    Vec_Int_t * vMap_2 = Vec_IntStart( Vec_PtrSize(p->tList_2) );
+    Vec_Int_t * vMark_1 = Vec_IntAlloc( 0 );
+    Vec_Int_t * vMark_2 = Vec_IntAlloc( 0 );
+    Th_CnfMan_t * pCnf;
+    Thre_S * tObj;
+    int i, Var_1, Var_2, Lit, nVars = 0;
+
+    // the cone variables ( an upper bound as the PIs are shared ) and the
+    // miter output come first , the auxiliary variables of the encodings after
+    nVars += Th_SplitMarkCone( p->tList_1, pPo_1, vMark_1 );
+    nVars += Th_SplitMarkCone( p->tList_2, pPo_2, vMark_2 );
+    pCnf  = Th_CnfManStart( NULL, nVars + 1, p->Encoding, 1 );
+    nVars = 0;
+    Var_1 = Th_SplitWriteCone( pCnf, p->tList_1, pPo_1, vMapPi, vMap_1, vMark_1, &nVars );
+    Var_2 = Th_SplitWriteCone( pCnf, p->tList_2, pPo_2, vMapPi, vMap_2, vMark_2, &nVars );
+    Th_CnfWriteXor( pCnf, Var_1, Var_2, ++nVars );
+    Lit = nVars;
+    Th_CnfManAddClause( pCnf, &Lit, 1 );
+
+    pJob->Status   = Th_CnfManSolve( pCnf, p->nConfLimit, p->nTimeLimit );
+    pJob->nVars    = Th_CnfManVarNum( pCnf );
+    pJob->nClauses = Th_CnfManClauseNum( pCnf );
+    pJob->nConfs   = Th_CnfManConflictNum( pCnf );
+    if ( pJob->Status == 1 ) {
+        Vec_Str_t * vCex = Vec_StrAlloc( 100 );
+        Vec_PtrForEachEntry( Thre_S*, p->tList_1, tObj, i )
+            if ( tObj && tObj->Type == Th_Pi )
+                Vec_StrPush( vCex, Vec_IntEntry(vMapPi, i) ? '0' + Th_CnfManVarValue(pCnf, Vec_IntEntry(vMapPi, i)) : '-' );
+        Vec_StrPush( vCex, '\0' );
+        pJob->pCex = Vec_StrReleaseArray( vCex );
+        Vec_StrFree( vCex );
+    }
+    Th_CnfManStop( pCnf );
+    Vec_IntFree( vMapPi );
+    Vec_IntFree( vMap_1 );
+    Vec_IntFree( vMap_2 );
+    Vec_IntFree( vMark_1 );
+    Vec_IntFree( vMark_2 );
+    pJob->Time = Abc_Clock() - clk;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Runs the jobs on worker threads.]
+
+  Description [Follows the manager/worker scheme of cecSplit.c : the
+               calling thread hands the next output to any idle worker
+               until all outputs are done.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+#ifdef ABC_USE_PTHREADS
+
+typedef struct Th_SplitThData_t_
+{
+    Th_SplitMan_t * p;
+    Th_SplitJob_t * pJob;      // the job to run or NULL to stop
+    int             fWorking;
+} Th_SplitThData_t;
+
+void * Th_SplitWorkerThread( void * pArg )
+{
+    Th_SplitThData_t * pThData = (Th_SplitThData_t *)pArg;
+    volatile int * pPlace = &pThData->fWorking;
+    while ( 1 )
+    {
+        while ( *pPlace == 0 );
+        assert( pThData->fWorking );
+        if ( pThData->pJob == NULL )
+        {
+            pthread_exit( NULL );
+            assert( 0 );
+            return NULL;
+        }
+        Th_SplitSolveOne( pThData->p, pThData->pJob );
+        pThData->fWorking = 0;
+    }
+    assert( 0 );
+    return NULL;
+}
+
+static void Th_SplitRunThreads( Th_SplitMan_t * p, Th_SplitJob_t * pJobs, int nJobs, int nProcs )
+{
+    Th_SplitThData_t ThData[TH_SPLIT_THR_MAX];
+    pthread_t WorkerThread[TH_SPLIT_THR_MAX];
+    int i, status, iNext = 0, fWorkToDo = 1;
+    assert( nProcs >= 1 && nProcs <= TH_SPLIT_THR_MAX );
+    for ( i = 0; i < nProcs; i++ )
+    {
+        ThData[i].p        = p;
+        ThData[i].pJob     = NULL;
+        ThData[i].fWorking = 0;
+        status = pthread_create( WorkerThread + i, NULL, Th_SplitWorkerThread, (void *)(ThData + i) );  assert( status == 0 );
+    }
+    while ( fWorkToDo )
+    {
+        while ( iNext < nJobs && pJobs[iNext].fSim )
+            iNext++;
+        fWorkToDo = (int)(iNext < nJobs);
+        for ( i = 0; i < nProcs; i++ )
+        {
+            if ( ThData[i].fWorking )
+            {
+                fWorkToDo = 1;
+                continue;
+            }
+            while ( iNext < nJobs && pJobs[iNext].fSim )
+                iNext++;
+            if ( iNext == nJobs )
+                continue;
+            ThData[i].pJob     = pJobs + iNext++;
+            ThData[i].fWorking = 1;
+        }
+    }
+    // stop threads
+    for ( i = 0; i < nProcs; i++ )
+    {
+        assert( !ThData[i].fWorking );
+        ThData[i].pJob     = NULL;
+        ThData[i].fWorking = 1;
+    }
+    // ThData lives on this stack
+    for ( i = 0; i < nProcs; i++ )
+        pthread_join( WorkerThread[i], NULL );
+}
+
+#endif // pthreads are used
+
+/**Function*************************************************************
+
+  Synopsis    [Checks the two networks output by output.]
+
+  Description [Every pair of POs gets its own miter over the two output
+               cones , so a hard output no longer holds back the easy
+               ones ; nConfLimit and nTimeLimit apply to each output.
+               With nProcs > 1 and pthreads , nProcs-1 workers solve the
+               outputs while the calling thread dispatches them ;
+               otherwise they are solved one after another. Returns 1
+               if some output differs , 0 if all are equivalent and -1
+               if some output is undecided. The outputs with an entry
+               in vSimCexes ( may be NULL ) were already refuted by
+               simulation under that pattern and are not solved.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+int Th_SplitCompare( Vec_Ptr_t * tList_1, Vec_Ptr_t * tList_2, Vec_Ptr_t * vSimCexes, int Encoding, int nProcs, int nConfLimit, int nTimeLimit, int fVerbose )
+{
+    abctime clkTotal = Abc_Clock();
+    Th_SplitMan_t Man, * p = &Man;
+    Th_SplitJob_t * pJobs, * pJob;
+    Thre_S * tObj;
+    int i, nJobs, nEquiv = 0, nDiff = 0, nUndec = 0, RetValue;
+
+    p->tList_1    = tList_1;
+    p->tList_2    = tList_2;
+    p->vPos_1     = Vec_PtrAlloc( 100 );
+    p->vPos_2     = Vec_PtrAlloc( 100 );
+    p->Encoding   = Encoding;
+    p->nConfLimit = nConfLimit;
+    p->nTimeLimit = nTimeLimit;
+    Vec_PtrForEachEntry( Thre_S*, tList_1, tObj, i )
+        if ( tObj && tObj->Type == Th_Po )
+            Vec_PtrPush( p->vPos_1, tObj );
+    Vec_PtrForEachEntry( Thre_S*, tList_2, tObj, i )
+        if ( tObj && tObj->Type == Th_Po )
+            Vec_PtrPush( p->vPos_2, tObj );
+    printf("\tchecking Equalivance of cut_TList and current_TList output by output...\n");
+    if ( Vec_PtrSize(p->vPos_1) != Vec_PtrSize(p->vPos_2) ) {
+        printf("\tERROR: two network have different # of POs\n");
+        printf("\tEC_check : stopped\n");
+        Vec_PtrFree( p->vPos_1 );
+        Vec_PtrFree( p->vPos_2 );
+        return -1;
+    }
+    nJobs = Vec_PtrSize( p->vPos_1 );
+    pJobs = ABC_CALLOC( Th_SplitJob_t, nJobs );
+    for ( i = 0; i < nJobs; i++ ) {
+        pJobs[i].iPo = i;
+        if ( vSimCexes && Vec_PtrEntry(vSimCexes, i) ) {
+            pJobs[i].fSim   = 1;
+            pJobs[i].Status = 1;
+            pJobs[i].pCex   = Abc_UtilStrsav( (char*)Vec_PtrEntry(vSimCexes, i) );
+        }
+    }
+
+#ifdef ABC_USE_PTHREADS
+    if ( nProcs > 1 )
+        // subtract manager thread
+        Th_SplitRunThreads( p, pJobs, nJobs, Abc_MinInt(nProcs - 1, TH_SPLIT_THR_MAX) );
+    else
+#endif
+    for ( i = 0; i < nJobs; i++ )
+        if ( !pJobs[i].fSim )
+            Th_SplitSolveOne( p, pJobs + i );
+
+    // report the outputs in order
+    for ( i = 0; i < nJobs; i++ ) {
+        pJob = pJobs + i;
+        tObj = (Thre_S*)Vec_PtrEntry( p->vPos_1, i );
+        nEquiv += (pJob->Status == 0);
+        nDiff  += (pJob->Status == 1);
+        nUndec += (pJob->Status == -1);
+        if ( !fVerbose && pJob->Status == 0 )
+            continue;
+        if ( pJob->fSim ) {
+            printf( "\tOutput %5d %-16s : %-15s  by simulation\n", i, tObj->pName, "NOT EQUIVALENT" );
+            printf( "\t             input pattern : %s\n", pJob->pCex );
+            continue;
+        }
+        printf( "\tOutput %5d %-16s : %-15s  vars = %7d  clauses = %8d  confs = %8d  ", i, tObj->pName,
+            pJob->Status == 0 ? "EQUIVALENT" : (pJob->Status == 1 ? "NOT EQUIVALENT" : "UNDECIDED"),
+            pJob->nVars, pJob->nClauses, pJob->nConfs );
+        Abc_PrintTime( 1, "Time", pJob->Time );
+        if ( pJob->pCex ) {
+            printf( "\t             input pattern : %s\n", pJob->pCex );
+            if ( !Th_SimCexCheck( tList_1, tList_2, pJob->pCex, i ) )
+                printf( "\t             Warning: the pattern does not replay in simulation.\n" );
+        }
+    }
+    printf( "\t%d outputs : %d equivalent , %d not equivalent , %d undecided.\n", nJobs, nEquiv, nDiff, nUndec );
+    if ( nDiff )
+        printf("\tNetworks are NOT EQUIVALENT.\n");
+    else if ( nUndec )
+        printf("\tNetworks are UNDECIDED (resource limit reached).\n");
+    else
+        printf("\tNetworks are EQUIVALENT.\n");
+    Abc_PrintTime( 1, "\tTotal time", Abc_Clock() - clkTotal );
+    RetValue = nDiff ? 1 : (nUndec ? -1 : 0);
+
+    for ( i = 0; i < nJobs; i++ )
+        ABC_FREE( pJobs[i].pCex );
+    ABC_FREE( pJobs );
+    Vec_PtrFree( p->vPos_1 );
+    Vec_PtrFree( p->vPos_2 );
+    return RetValue;
+}
+
+////////////////////////////////////////////////////////////////////////
+///                       END OF FILE                                ///
+////////////////////////////////////////////////////////////////////////
@@ -14,8 +14,9 @@ int        Th_CountGate          ( Vec_Ptr_t * , Th_Gate_Type );
 int        Th_CountLevel         ( Vec_Ptr_t * );
 void       Th_SetLevel           ( Vec_Ptr_t * );
 void       Th_ComputeLevel       ( Vec_Ptr_t * );
-void       Th_ComputeLevel_rec   ( Vec_Ptr_t * , Thre_S * );
 int        Th_FindMaxLevel       ( Vec_Ptr_t * );
+void       Th_NtkLevelForward    ( Vec_Ptr_t * );
+void       Th_NtkLevelUpdate     ( Vec_Ptr_t * , int , Vec_Int_t * , Vec_Int_t * );
 Vec_Int_t* Th_CountFanio         ( Vec_Ptr_t * , int );
 void       Th_PrintData          ( int , int , int , int , Vec_Int_t * , Vec_Int_t * );
 
@@ -70,64 +71,146 @@ void Th_SetLevel( Vec_Ptr_t * tList )
 	}
 }
 
-void Th_ComputeLevel_rec( Vec_Ptr_t * tList , Thre_S * tObj )
+void Th_ComputeLevel( Vec_Ptr_t * tList )
 {
-   Thre_S * tObjFanin;
-	int i , Entry;
-  
-	//printf( "Dump tObj: \n");
-	//Th_DumpObj( tObj );
-	if ( tObj->Type == Th_Po || tObj->Type == Th_Node ) {
-	   Vec_IntForEachEntry( tObj->Fanins , Entry , i ) 
+	// level of an object = longest path to a PO (POs are at level 0);
+	// objects are processed in reverse topological order (Kahn) , so each
+	// fanin edge is visited once : O(V+E)
+	Vec_Int_t * vRef , * vQueue;
+	Vec_Str_t * vReach;
+	Thre_S    * tObj , * tObjFanin;
+	int i , k , Entry , head;
+
+	vRef   = Vec_IntStart( Vec_PtrSize( tList ) );
+	vReach = Vec_StrStart( Vec_PtrSize( tList ) );
+	vQueue = Vec_IntAlloc( Vec_PtrSize( tList ) );
+	// count the fanouts (as fanin references) of each object
+	Vec_PtrForEachEntry( Thre_S * , tList , tObj , i )
+	{
+		if ( !tObj || ( tObj->Type != Th_Po && tObj->Type != Th_Node ) ) continue;
+		Vec_IntForEachEntry( tObj->Fanins , Entry , k )
+			Vec_IntAddToEntry( vRef , Entry , 1 );
+	}
+	Vec_PtrForEachEntry( Thre_S * , tList , tObj , i )
+	{
+		if ( !tObj ) continue;
+		if ( tObj->Type == Th_Po ) Vec_StrWriteEntry( vReach , i , 1 );
+		if ( Vec_IntEntry( vRef , i ) == 0 ) Vec_IntPush( vQueue , i );
+	}
+	// only objects reachable from POs pass their levels on
+	for ( head = 0 ; head < Vec_IntSize( vQueue ) ; ++head )
+	{
+		tObj = Th_GetObjById( tList , Vec_IntEntry( vQueue , head ) );
+		if ( tObj->Type != Th_Po && tObj->Type != Th_Node ) continue;
+		Vec_IntForEachEntry( tObj->Fanins , Entry , k )
 		{
 			tObjFanin = Th_GetObjById( tList , Entry );
-	      //printf( "Dump tObjFanin: \n");
-	      //Th_DumpObj( tObjFanin );
 			assert(tObjFanin);
-			if ( tObjFanin-> level < tObj->level + 1 ) {
-			   tObjFanin->level = tObj->level + 1;
-				Th_ComputeLevel_rec( tList , tObjFanin );
+			if ( Vec_StrEntry( vReach , tObj->Id ) ) {
+				Vec_StrWriteEntry( vReach , Entry , 1 );
+				if ( tObjFanin->level < tObj->level + 1 ) tObjFanin->level = tObj->level + 1;
 			}
+			Vec_IntAddToEntry( vRef , Entry , -1 );
+			if ( Vec_IntEntry( vRef , Entry ) == 0 ) Vec_IntPush( vQueue , Entry );
 		}
 	}
+	Vec_IntFree( vRef );
+	Vec_StrFree( vReach );
+	Vec_IntFree( vQueue );
 }
 
-void Th_ComputeLevel( Vec_Ptr_t * tList )
+int Th_FindMaxLevel( Vec_Ptr_t * tList )
 {
+	int level , i;
 	Thre_S * tObj;
-	Vec_Ptr_t * vPo;
-	int i;
 
-	vPo = Vec_PtrAlloc(16);
+	level = 0;
 
 	Vec_PtrForEachEntry( Thre_S * , tList , tObj , i )
 	{
-		if ( tObj && tObj->Type == Th_Po )
-			Vec_PtrPush( vPo , tObj );
-	}
-   
-	Vec_PtrForEachEntry( Thre_S * , vPo , tObj , i )
-	{
-		Th_ComputeLevel_rec( tList , tObj );
+		if ( tObj && tObj->Type == Th_Pi ) {
+		   if ( tObj->level > level ) level = tObj->level;
+		}
 	}
-
-	Vec_PtrFree(vPo);
+	return level;
 }
 
-int Th_FindMaxLevel( Vec_Ptr_t * tList )
-{
-	int level , i;
-	Thre_S * tObj;
+/*************************************************************
+Forward levels (depth from PIs) used by merge_th -L : PIs and
+const are at level 0 , others at 1 + max level of their fanins.
+Th_NtkLevelForward() levelizes the whole network in O(V+E);
+Th_NtkLevelUpdate() restores the levels after a collapse added the
+objects from iStart on , visiting only the fanout cone whose levels
+change ; a gate waiting in the queue is not queued again by its other
+fanins. vQueue and vQueued are scratch owned by the caller.
+*************************************************************/
 
-	level = 0;
+void Th_NtkLevelForward( Vec_Ptr_t * tList )
+{
+	Vec_Int_t * vRef , * vQueue;
+	Thre_S    * tObj , * tObjFanout;
+	int i , k , Entry , head;
 
+	vRef   = Vec_IntStart( Vec_PtrSize( tList ) );
+	vQueue = Vec_IntAlloc( Vec_PtrSize( tList ) );
 	Vec_PtrForEachEntry( Thre_S * , tList , tObj , i )
 	{
-		if ( tObj && tObj->Type == Th_Pi ) {
-		   if ( tObj->level > level ) level = tObj->level;
+		if ( !tObj ) continue;
+		tObj->level = 0;
+		if ( tObj->Type == Th_Po || tObj->Type == Th_Node )
+			Vec_IntWriteEntry( vRef , i , Vec_IntSize( tObj->Fanins ) );
+		if ( Vec_IntEntry( vRef , i ) == 0 ) Vec_IntPush( vQueue , i );
+	}
+	for ( head = 0 ; head < Vec_IntSize( vQueue ) ; ++head )
+	{
+		tObj = Th_GetObjById( tList , Vec_IntEntry( vQueue , head ) );
+		Vec_IntForEachEntry( tObj->Fanouts , Entry , k )
+		{
+			tObjFanout = Th_GetObjById( tList , Entry );
+			assert(tObjFanout);
+			if ( tObjFanout->level < tObj->level + 1 ) tObjFanout->level = tObj->level + 1;
+			Vec_IntAddToEntry( vRef , Entry , -1 );
+			if ( Vec_IntEntry( vRef , Entry ) == 0 ) Vec_IntPush( vQueue , Entry );
 		}
 	}
-	return level;
+	Vec_IntFree( vRef );
+	Vec_IntFree( vQueue );
+}
+
+void Th_NtkLevelUpdate( Vec_Ptr_t * tList , int iStart , Vec_Int_t * vQueue , Vec_Int_t * vQueued )
+{
+	Thre_S * tObjCur , * tObjFanin;
+	int i , k , Entry , level , head , nSeeds;
+
+	// vQueued : objects in the queue not yet processed
+	Vec_IntFillExtra( vQueued , Vec_PtrSize( tList ) , 0 );
+	Vec_IntClear( vQueue );
+	for ( i = iStart ; i < Vec_PtrSize( tList ) ; ++i )
+		if ( Vec_PtrEntry( tList , i ) )
+		{
+			Vec_IntWriteEntry( vQueued , i , 1 );
+			Vec_IntPush( vQueue , i );
+		}
+	nSeeds = Vec_IntSize( vQueue );
+	for ( head = 0 ; head < Vec_IntSize( vQueue ) ; ++head )
+	{
+		tObjCur = Th_GetObjById( tList , Vec_IntEntry( vQueue , head ) );
+		Vec_IntWriteEntry( vQueued , tObjCur->Id , 0 );
+		level   = 0;
+		Vec_IntForEachEntry( tObjCur->Fanins , Entry , k )
+		{
+			tObjFanin = Th_GetObjById( tList , Entry );
+			if ( tObjFanin->level + 1 > level ) level = tObjFanin->level + 1;
+		}
+		if ( head >= nSeeds && level == tObjCur->level ) continue;
+		tObjCur->level = level;
+		Vec_IntForEachEntry( tObjCur->Fanouts , Entry , i )
+			if ( !Vec_IntEntry( vQueued , Entry ) )
+			{
+				Vec_IntWriteEntry( vQueued , Entry , 1 );
+				Vec_IntPush( vQueue , Entry );
+			}
+	}
 }
 
 int Th_CountLevel( Vec_Ptr_t * tList )
@@ -47,12 +47,12 @@ extern int      Thre_LocalMin              (Thre_S * , int );
 
 // main function
 void   Th_WriteBlif            ( Vec_Ptr_t * thre_list , const char * );
-void   Th_WriteBlifInput       ( FILE * , Vec_Ptr_t * );
-void   Th_WriteBlifOutput      ( FILE * , Vec_Ptr_t * );
-void   Th_WriteBlifName        ( FILE * , Vec_Ptr_t * );
-void   Th_WriteBlifOneName     ( FILE * , Thre_S * );
-void   Th_ObjBuildSop          ( FILE * , Thre_S * , Vec_Str_t * , int , int );
-void   Th_StrOnFinalize        ( Vec_Str_t * , int );
+void   Th_WriteBlifInput       ( Th_Out_t * , Vec_Ptr_t * );
+void   Th_WriteBlifOutput      ( Th_Out_t * , Vec_Ptr_t * );
+void   Th_WriteBlifName        ( Th_Out_t * , Vec_Ptr_t * );
+void   Th_WriteBlifOneName     ( Th_Out_t * , Thre_S * );
+void   Th_ObjBuildSop          ( Th_Out_t * , Thre_S * , char * , int , int );
+void   Th_StrOnFinalize        ( Th_Out_t * , char * , int , int );
 
 
 /**Function*************************************************************
@@ -70,14 +70,18 @@ void   Th_StrOnFinalize        ( Vec_Str_t * , int );
 void
 Th_WriteBlif( Vec_Ptr_t * thre_list , const char * name )
 {
-	FILE * out;
+	Th_Out_t * out;
 	Vec_Ptr_t * vPi , * vPo , * vTh;
 	Thre_S * tObj;
 	int i;
 
 	printf( "Write out threshold network as blif file...\n" );
 	
-	out = fopen( name , "w" );
+	out = Th_OutStart( (char *)name , Th_OutFileMode((char *)name) );
+	if ( !out ) {
+		printf( "Cannot open output file \"%s\".\n" , name );
+		return;
+	}
 	vPi = Vec_PtrAlloc( 100 );
 	vPo = Vec_PtrAlloc( 100 );
 	vTh = Vec_PtrAlloc( 100 );
@@ -90,57 +94,71 @@ Th_WriteBlif( Vec_Ptr_t * thre_list , const char * name )
       else if ( tObj-> Type == Th_Node )  Vec_PtrPush( vTh , tObj );
 	}
 
-   fprintf( out , ".model %s\n" , name );
+   Th_OutStr( out , ".model " );
+   Th_OutStr( out , name );
+   Th_OutChar( out , '\n' );
 	Th_WriteBlifInput     ( out , vPi );
 	Th_WriteBlifOutput    ( out , vPo );
 	Th_WriteBlifName      ( out , vTh );
-   fprintf( out , ".end\n" );
+   Th_OutStr( out , ".end\n" );
 	
 	Vec_PtrFree(vPi);
 	Vec_PtrFree(vPo);
 	Vec_PtrFree(vTh);
-	fclose( out );
+	Th_OutStop( out );
 }
 
 void 
-Th_WriteBlifInput( FILE * out , Vec_Ptr_t * vPi )
+Th_WriteBlifInput( Th_Out_t * out , Vec_Ptr_t * vPi )
 {
 	Thre_S * tObj;
 	int i;
 
-	Vec_PtrForEachEntry( Thre_S * , vPi , tObj , i )
-		fprintf( out , ".inputs %d\n" , tObj->Id );
+	Vec_PtrForEachEntry( Thre_S * , vPi , tObj , i ) {
+		Th_OutStr( out , ".inputs " );
+		Th_OutInt( out , tObj->Id );
+		Th_OutChar( out , '\n' );
+	}
 }
 
 void 
-Th_WriteBlifOutput( FILE * out , Vec_Ptr_t * vPo )
+Th_WriteBlifOutput( Th_Out_t * out , Vec_Ptr_t * vPo )
 {
 	Thre_S * tObj;
 	int i;
 
-	Vec_PtrForEachEntry( Thre_S * , vPo , tObj , i )
-		fprintf( out , ".outputs %d\n" , tObj->Id );
+	Vec_PtrForEachEntry( Thre_S * , vPo , tObj , i ) {
+		Th_OutStr( out , ".outputs " );
+		Th_OutInt( out , tObj->Id );
+		Th_OutChar( out , '\n' );
+	}
 	
 	Vec_PtrForEachEntry( Thre_S * , vPo , tObj , i )
 	{
       if ( Vec_IntEntry( tObj->Fanins , 0 ) == 0 ) {
 			//printf( "[Warning] constant output!\n" );
-			fprintf( out , ".names %d\n" , tObj->Id );
-			if ( tObj->thre == 1 ) fprintf( out , " 1\n" );
-			else if ( tObj->thre == 0 )  fprintf( out , " 0\n" );
+			Th_OutStr( out , ".names " );
+			Th_OutInt( out , tObj->Id );
+			Th_OutChar( out , '\n' );
+			if ( tObj->thre == 1 ) Th_OutStr( out , " 1\n" );
+			else if ( tObj->thre == 0 )  Th_OutStr( out , " 0\n" );
 			else printf( "[Error] wrong output threshold!\n" );
 		}
 		else {
-			fprintf( out , ".names %d %d\n" , Vec_IntEntry( tObj->Fanins , 0 ) , tObj->Id );
-			if ( tObj->thre == 1 )       fprintf( out , "1 1\n" );
-			else if ( tObj->thre == 0 )  fprintf( out , "0 1\n" );
+			Th_OutStr( out , ".names " );
+			Th_OutInt( out , Vec_IntEntry( tObj->Fanins , 0 ) );
+			Th_OutChar( out , ' ' );
+			Th_OutInt( out , tObj->Id );
+			Th_OutChar( out , '\n' );
+			if ( tObj->thre == 1 )       Th_OutStr( out , "1 1\n" );
+			else if ( tObj->thre == 0 )  Th_OutStr( out , "0 1\n" );
 			else printf( "[Error] wrong output threshold!\n" );
 		}
 	}
 }
 
 void 
-Th_WriteBlifName( FILE * out , Vec_Ptr_t * vTh )
+Th_WriteBlifName( Th_Out_t * out , Vec_Ptr_t * vTh )
 {
 	Thre_S * tObj;
 	int i;
@@ -153,7 +171,9 @@ Th_WriteBlifName( FILE * out , Vec_Ptr_t * vTh )
 
   Synopsis    [Write one threshold gate into SOP]
 
-  Description []
+  Description [The cube under construction is kept in one buffer of
+               the fanin count ; the recursion sets the entry of its
+               level.]
                
   SideEffects []
 
@@ -162,80 +182,75 @@ Th_WriteBlifName( FILE * out , Vec_Ptr_t * vTh )
 ***********************************************************************/
 
 void
-Th_WriteBlifOneName( FILE * out , Thre_S * tObj )
+Th_WriteBlifOneName( Th_Out_t * out , Thre_S * tObj )
 {
-	Vec_Str_t * Sop;
+	char * pCube;
 	Thre_S * tObjSort;
 	int Entry , i;
 
-	Sop      = Vec_StrAlloc( 10 );
    //tObjSort = slow_sortByWeights( tObj );
    tObjSort = slow_sortByAbsWeights( tObj );
+	pCube    = ABC_ALLOC( char , Vec_IntSize( tObjSort->Fanins ) );
 
-	fprintf( out , ".names" );
-   Vec_IntForEachEntry( tObjSort->Fanins , Entry , i ) fprintf( out , " %d" , Entry );
-	fprintf( out , " %d\n" , tObjSort->Id );
+	Th_OutStr( out , ".names" );
+   Vec_IntForEachEntry( tObjSort->Fanins , Entry , i ) {
+      Th_OutChar( out , ' ' );
+      Th_OutInt( out , Entry );
+   }
+	Th_OutChar( out , ' ' );
+	Th_OutInt( out , tObjSort->Id );
+	Th_OutChar( out , '\n' );
 
-   Vec_StrClear( Sop );
-   Th_ObjBuildSop( out , tObjSort , Sop , tObjSort->thre , 0 );
+   Th_ObjBuildSop( out , tObjSort , pCube , tObjSort->thre , 0 );
    delete_sortedNode( tObjSort );
-	Vec_StrFree( Sop );
+	ABC_FREE( pCube );
 }
 
 void
-Th_ObjBuildSop( FILE * out , Thre_S * tObj , Vec_Str_t * Sop , int thre , int lvl )
+Th_ObjBuildSop( Th_Out_t * out , Thre_S * tObj , char * pCube , int thre , int lvl )
 {
    assert( lvl < Vec_IntSize( tObj->Fanins ) );
 
-	Vec_Str_t * posSop , * negSop;
 	int curW , maxF , minF , posT , negT;
 
-	posSop = Vec_StrDup( Sop );
-   Vec_StrPrintNum( posSop , 1 ); 
-	negSop = Vec_StrDup( Sop );
-   Vec_StrPrintNum( negSop , 0 ); 
-
 	curW  = Vec_IntEntry( tObj->weights , lvl );
    maxF  = Thre_LocalMax( tObj , lvl );
    minF  = Thre_LocalMin( tObj , lvl );
 
 	posT = thre - curW;
+	pCube[lvl] = '1';
    if ( posT <= minF ) {
       // on-set
-		Th_StrOnFinalize( posSop , Vec_IntSize( tObj->Fanins )-lvl-1 );
-      fprintf( out , "%s\n" , posSop->pArray );
+		Th_StrOnFinalize( out , pCube , lvl+1 , Vec_IntSize( tObj->Fanins ) );
    }
    else if ( maxF < posT ) {
       // off-set : do nothing
    }
-   else Th_ObjBuildSop( out , tObj , posSop , posT , lvl+1 );
+   else Th_ObjBuildSop( out , tObj , pCube , posT , lvl+1 );
    
 	negT = thre;
+	pCube[lvl] = '0';
    if ( negT <= minF ) {
       // on-set
-		Th_StrOnFinalize( negSop , Vec_IntSize( tObj->Fanins )-lvl-1 );
-      fprintf( out , "%s\n" , negSop->pArray );
+		Th_StrOnFinalize( out , pCube , lvl+1 , Vec_IntSize( tObj->Fanins ) );
    }
    else if ( maxF < negT ) {
       // off-set : do nothing
    }
-   else Th_ObjBuildSop( out , tObj , negSop , negT , lvl+1 );
-    
-	Vec_StrFree( posSop );
-   Vec_StrFree( negSop );
+   else Th_ObjBuildSop( out , tObj , pCube , negT , lvl+1 );
 }
 
+// writes the cube of the first nLits entries with the rest don't-cares
 void
-Th_StrOnFinalize( Vec_Str_t * Sop , int numDc )
+Th_StrOnFinalize( Th_Out_t * out , char * pCube , int nLits , int nVars )
 {
 	int i;
 
-	for ( i = 0 ; i < numDc ; ++i ) 
-      Vec_StrAppend( Sop , "-" );
-	
-	Vec_StrAppend   ( Sop , " " );
-   Vec_StrPrintNum ( Sop , 1 );
-   Vec_StrPush     ( Sop , '\0');
+	for ( i = nLits ; i < nVars ; ++i ) 
+      pCube[i] = '-';
+	for ( i = 0 ; i < nVars ; ++i ) 
+      Th_OutChar( out , pCube[i] );
+	Th_OutStr( out , " 1\n" );
 }
 
 ////////////////////////////////////////////////////////////////////////
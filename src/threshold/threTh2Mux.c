@@ -39,6 +39,17 @@
 ///                        DECLARATIONS                              ///
 ////////////////////////////////////////////////////////////////////////
 
+// cofactors of one gate already built : the cofactor over the fanins
+// head..tail with residual threshold r stays the same function over an
+// interval of r , so each range keeps (lo, hi, node) of its cofactors
+typedef struct Th_MuxMemo_t_ Th_MuxMemo_t;
+struct Th_MuxMemo_t_
+{
+   int         nFanins;
+   Vec_Ptr_t * vRanges;   // per head : per tail , Vec_Int_t of (lo, hi, node index) ; on demand
+   Vec_Ptr_t * vNodes;    // AIG nodes of the cofactors
+};
+
 // extern functions
 extern Thre_S * slow_sortByWeights          ( Thre_S * );
 extern void     delete_sortedNode           ( Thre_S * );
@@ -51,9 +62,9 @@ Abc_Ntk_t*      Th_Ntk2Mux                  ( Vec_Ptr_t * , int , int );
 static void         Th_Ntk2MuxCreatePio     ( Vec_Ptr_t * , Abc_Ntk_t * , Vec_Ptr_t * , Vec_Ptr_t * );
 static void         Th_Ntk2MuxCreateMux     ( Vec_Ptr_t * , Abc_Ntk_t * , Vec_Ptr_t * , int , int );
 static Abc_Obj_t*   Th_Node2Mux             ( Vec_Ptr_t * , Thre_S * , Abc_Ntk_t * , int , int );
-static Abc_Obj_t*   Th_Node2Mux_rec         ( Vec_Ptr_t * , Thre_S * , Abc_Ntk_t * , int , int );
-static Abc_Obj_t*   Th_Node2MuxDyn_rec      ( Vec_Ptr_t * , Thre_S * , Abc_Ntk_t * , int , int , int );
-static Abc_Obj_t*   Th_Node2MuxAhead_rec    ( Vec_Ptr_t * , Thre_S * , Abc_Ntk_t * , int , int , int );
+static Abc_Obj_t*   Th_Node2Mux_rec         ( Vec_Ptr_t * , Thre_S * , Abc_Ntk_t * , int , int , Th_MuxMemo_t * , int * , int * );
+static Abc_Obj_t*   Th_Node2MuxDyn_rec      ( Vec_Ptr_t * , Thre_S * , Abc_Ntk_t * , int , int , int , Th_MuxMemo_t * , int * , int * );
+static Abc_Obj_t*   Th_Node2MuxAhead_rec    ( Vec_Ptr_t * , Thre_S * , Abc_Ntk_t * , int , int , int , Th_MuxMemo_t * , int * , int * );
 static int          Th_SelectVar            ( Thre_S * , int , int );
 static int          Th_SelectVar_Ahead      ( Thre_S * , int , int , int );
 static void         Th_Ntk2MuxFinalize      ( Vec_Ptr_t * , Vec_Ptr_t * );
@@ -202,23 +213,139 @@ Th_Ntk2MuxCreateMux( Vec_Ptr_t * thre_list , Abc_Ntk_t * pNtkMux ,
    }
 }
 
+/**Function*************************************************************
+
+  Synopsis    [Memo of the cofactors of one gate.]
+
+  Description [Th_MuxMemoLookup() returns the node of the cofactor over
+               head..tail at residual threshold thre and its interval ,
+               or NULL if it is not built yet ; Th_MuxMemoInsert()
+               records a new one. Every distinct cofactor is built once ,
+               so the expansion takes at most one node per range and
+               distinct residual interval , instead of one per path.]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+static Th_MuxMemo_t*
+Th_MuxMemoStart( int nFanins )
+{
+   Th_MuxMemo_t * p = ABC_CALLOC( Th_MuxMemo_t , 1 );
+   p->nFanins = nFanins;
+   p->vRanges = Vec_PtrStart( nFanins + 1 );
+   p->vNodes  = Vec_PtrAlloc( 100 );
+   return p;
+}
+
+static void
+Th_MuxMemoStop( Th_MuxMemo_t * p )
+{
+   Vec_Ptr_t * vTails;
+   int i;
+   Vec_PtrForEachEntry( Vec_Ptr_t * , p->vRanges , vTails , i )
+      if ( vTails ) Vec_VecFree( (Vec_Vec_t *)vTails );
+   Vec_PtrFree( p->vRanges );
+   Vec_PtrFree( p->vNodes );
+   ABC_FREE( p );
+}
+
+static Vec_Int_t*
+Th_MuxMemoRange( Th_MuxMemo_t * p , int head , int tail )
+{
+   Vec_Ptr_t * vTails;
+   int i;
+   // the empty ranges are terminal
+   assert( head <= tail && tail < p->nFanins );
+   vTails = (Vec_Ptr_t *)Vec_PtrEntry( p->vRanges , head );
+   if ( vTails == NULL ) {
+      vTails = Vec_PtrAlloc( p->nFanins - head );
+      for ( i = head ; i < p->nFanins ; ++i )
+         Vec_PtrPush( vTails , Vec_IntAlloc( 0 ) );
+      Vec_PtrWriteEntry( p->vRanges , head , vTails );
+   }
+   return (Vec_Int_t *)Vec_PtrEntry( vTails , tail - head );
+}
+
+static Abc_Obj_t*
+Th_MuxMemoLookup( Th_MuxMemo_t * p , int head , int tail , int thre , int * pLo , int * pHi )
+{
+   Vec_Int_t * vMemo = Th_MuxMemoRange( p , head , tail );
+   int k;
+   for ( k = 0 ; k < Vec_IntSize( vMemo ) ; k += 3 )
+      if ( Vec_IntEntry( vMemo , k ) <= thre && thre <= Vec_IntEntry( vMemo , k+1 ) ) {
+         *pLo = Vec_IntEntry( vMemo , k );
+         *pHi = Vec_IntEntry( vMemo , k+1 );
+         return (Abc_Obj_t *)Vec_PtrEntry( p->vNodes , Vec_IntEntry( vMemo , k+2 ) );
+      }
+   return NULL;
+}
+
+static void
+Th_MuxMemoInsert( Th_MuxMemo_t * p , int head , int tail , int lo , int hi , Abc_Obj_t * pObj )
+{
+   Vec_Int_t * vMemo = Th_MuxMemoRange( p , head , tail );
+   Vec_IntPush( vMemo , lo );
+   Vec_IntPush( vMemo , hi );
+   Vec_IntPush( vMemo , Vec_PtrSize( p->vNodes ) );
+   Vec_PtrPush( p->vNodes , pObj );
+}
+
+// terminal cofactors over head..tail : returns NULL if thre is not terminal
+static Abc_Obj_t*
+Th_MuxTerminal( Thre_S * tObjSort , Abc_Ntk_t * pNtkMux , int thre , int head , int tail , int * pLo , int * pHi )
+{
+   int curMax , curMin;
+   curMax = Th_LocalMax( tObjSort , head , tail );
+   curMin = Th_LocalMin( tObjSort , head , tail );
+   if ( curMax <  thre ) {
+      *pLo = curMax + 1; *pHi = ABC_INFINITY;
+      return Abc_ObjNot( Abc_AigConst1( pNtkMux ) );
+   }
+   if ( curMin >= thre ) {
+      *pLo = -ABC_INFINITY; *pHi = curMin;
+      return Abc_AigConst1( pNtkMux );
+   }
+   return NULL;
+}
+
+// builds the cofactor split on splitVar from its two children
+static Abc_Obj_t*
+Th_MuxBuild( Thre_S * tObjSort , Abc_Ntk_t * pNtkMux , Th_MuxMemo_t * pMemo , int head , int tail , int splitVar , 
+             Abc_Obj_t * pCtrl , Abc_Obj_t * pObj1 , int lo1 , int hi1 , Abc_Obj_t * pObj0 , int lo0 , int hi0 , int * pLo , int * pHi )
+{
+   Abc_Obj_t * pObjMux;
+   int curW = Vec_IntEntry( tObjSort->weights , splitVar );
+   *pLo = Abc_MaxInt( Th_IntervalShift( lo1 , curW ) , lo0 );
+   *pHi = Abc_MinInt( Th_IntervalShift( hi1 , curW ) , hi0 );
+   pObjMux = Abc_AigMux( pNtkMux->pManFunc , pCtrl , pObj1 , pObj0 );
+   Th_MuxMemoInsert( pMemo , head , tail , *pLo , *pHi , pObjMux );
+   return pObjMux;
+}
+
 Abc_Obj_t*
 Th_Node2Mux( Vec_Ptr_t * thre_list , Thre_S * tObj ,  Abc_Ntk_t * pNtkMux , int fDynamic , int fAhead )
 {
-   Thre_S    * tObjSort;
-   Abc_Obj_t * pObjMux;
+   Thre_S       * tObjSort;
+   Abc_Obj_t    * pObjMux;
+   Th_MuxMemo_t * pMemo;
+   int lo , hi;
 
    tObjSort = slow_sortByWeights( tObj );
+   pMemo    = Th_MuxMemoStart( Vec_IntSize( tObjSort->weights ) );
 
    if ( fAhead ) 
       pObjMux = Th_Node2MuxAhead_rec( thre_list , tObjSort , pNtkMux , tObjSort->thre , 0 , 
-                                      Vec_IntSize( tObjSort->weights )-1 );
+                                      Vec_IntSize( tObjSort->weights )-1 , pMemo , &lo , &hi );
    else if ( fDynamic ) 
       pObjMux = Th_Node2MuxDyn_rec( thre_list , tObjSort , pNtkMux , tObjSort->thre , 0 , 
-                                    Vec_IntSize( tObjSort->weights )-1 );
+                                    Vec_IntSize( tObjSort->weights )-1 , pMemo , &lo , &hi );
    else            
-      pObjMux = Th_Node2Mux_rec( thre_list , tObjSort , pNtkMux , tObjSort->thre , 0 );
+      pObjMux = Th_Node2Mux_rec( thre_list , tObjSort , pNtkMux , tObjSort->thre , 0 , pMemo , &lo , &hi );
    
+   Th_MuxMemoStop( pMemo );
    delete_sortedNode( tObjSort );
    if ( !pObjMux ) {
       printf( "[Error] convert Th node to mux trees fail.\n" );
@@ -228,55 +355,50 @@ Th_Node2Mux( Vec_Ptr_t * thre_list , Thre_S * tObj ,  Abc_Ntk_t * pNtkMux , int
 }
 
 Abc_Obj_t*
-Th_Node2Mux_rec( Vec_Ptr_t * list , Thre_S * tObjSort , Abc_Ntk_t * pNtkMux , int thre , int lvl )
+Th_Node2Mux_rec( Vec_Ptr_t * list , Thre_S * tObjSort , Abc_Ntk_t * pNtkMux , int thre , int lvl ,
+                 Th_MuxMemo_t * pMemo , int * pLo , int * pHi )
 {
    assert( lvl <= Vec_IntSize( tObjSort->Fanins ) );
-   Abc_Obj_t * pObjMux; 
+   Abc_Obj_t * pObjMux , * pObj1 , * pObj0; 
    Thre_S    * tObjC;
-   int curMax , curMin , curW;
-
-   curMax = Th_LocalMax( tObjSort , lvl , Vec_IntSize( tObjSort->weights )-1 );
-   curMin = Th_LocalMin( tObjSort , lvl , Vec_IntSize( tObjSort->weights )-1 );
+   int curW , tail , lo1 , hi1 , lo0 , hi0;
 
-   if ( curMax <  thre ) return Abc_ObjNot( Abc_AigConst1( pNtkMux ) );
-   if ( curMin >= thre ) return Abc_AigConst1( pNtkMux );
+   tail = Vec_IntSize( tObjSort->weights )-1;
+   if ( (pObjMux = Th_MuxTerminal( tObjSort , pNtkMux , thre , lvl , tail , pLo , pHi )) ) return pObjMux;
+   if ( (pObjMux = Th_MuxMemoLookup( pMemo , lvl , tail , thre , pLo , pHi )) ) return pObjMux;
    
    curW    = Vec_IntEntry( tObjSort->weights , lvl );
    tObjC   = Th_GetObjById( list , Vec_IntEntry( tObjSort->Fanins , lvl ) );
-   pObjMux = Abc_AigMux( pNtkMux->pManFunc , tObjC->pCopy , 
-                         Th_Node2Mux_rec( list , tObjSort , pNtkMux , thre-curW , lvl+1 ) ,
-                         Th_Node2Mux_rec( list , tObjSort , pNtkMux , thre      , lvl+1 ) );
-   return pObjMux;
+   pObj1   = Th_Node2Mux_rec( list , tObjSort , pNtkMux , thre-curW , lvl+1 , pMemo , &lo1 , &hi1 );
+   pObj0   = Th_Node2Mux_rec( list , tObjSort , pNtkMux , thre      , lvl+1 , pMemo , &lo0 , &hi0 );
+   return Th_MuxBuild( tObjSort , pNtkMux , pMemo , lvl , tail , lvl , tObjC->pCopy , pObj1 , lo1 , hi1 , pObj0 , lo0 , hi0 , pLo , pHi );
 }
 
 Abc_Obj_t*
 Th_Node2MuxDyn_rec( Vec_Ptr_t * list , Thre_S * tObjSort , Abc_Ntk_t * pNtkMux ,
-                    int thre , int head , int tail )
+                    int thre , int head , int tail , Th_MuxMemo_t * pMemo , int * pLo , int * pHi )
 {
    assert( head <= tail + 1 );
-   Abc_Obj_t * pObjMux; 
+   Abc_Obj_t * pObjMux , * pObj1 , * pObj0; 
    Thre_S    * tObjC;
-   int curMax , curMin , curW , splitVar;
+   int curW , splitVar , head0 , tail0 , lo1 , hi1 , lo0 , hi0;
 
-   curMax = Th_LocalMax( tObjSort , head , tail );
-   curMin = Th_LocalMin( tObjSort , head , tail );
-
-   if ( curMax <  thre ) return Abc_ObjNot( Abc_AigConst1( pNtkMux ) );
-   if ( curMin >= thre ) return Abc_AigConst1( pNtkMux );
+   if ( (pObjMux = Th_MuxTerminal( tObjSort , pNtkMux , thre , head , tail , pLo , pHi )) ) return pObjMux;
+   if ( (pObjMux = Th_MuxMemoLookup( pMemo , head , tail , thre , pLo , pHi )) ) return pObjMux;
    
    splitVar = Th_SelectVar( tObjSort , head , tail );
 #ifdef PROFILE
    thProfiler.redund[splitVar] = 1;
 #endif
    assert( splitVar == head || splitVar == tail );
+   head0 = head; tail0 = tail;
    if ( splitVar == head ) ++head;
    else --tail;
    curW     = Vec_IntEntry( tObjSort->weights , splitVar );
    tObjC    = Th_GetObjById( list , Vec_IntEntry( tObjSort->Fanins , splitVar ) );
-   pObjMux  = Abc_AigMux( pNtkMux->pManFunc , tObjC->pCopy , 
-                          Th_Node2MuxDyn_rec( list , tObjSort , pNtkMux , thre-curW , head , tail ) ,
-                          Th_Node2MuxDyn_rec( list , tObjSort , pNtkMux , thre      , head , tail ) );
-   return pObjMux;
+   pObj1    = Th_Node2MuxDyn_rec( list , tObjSort , pNtkMux , thre-curW , head , tail , pMemo , &lo1 , &hi1 );
+   pObj0    = Th_Node2MuxDyn_rec( list , tObjSort , pNtkMux , thre      , head , tail , pMemo , &lo0 , &hi0 );
+   return Th_MuxBuild( tObjSort , pNtkMux , pMemo , head0 , tail0 , splitVar , tObjC->pCopy , pObj1 , lo1 , hi1 , pObj0 , lo0 , hi0 , pLo , pHi );
 }
 
 int
@@ -290,29 +412,26 @@ Th_SelectVar( Thre_S * t , int head , int tail )
 
 Abc_Obj_t*
 Th_Node2MuxAhead_rec( Vec_Ptr_t * list , Thre_S * tObjSort , Abc_Ntk_t * pNtkMux ,
-                      int thre , int head , int tail )
+                      int thre , int head , int tail , Th_MuxMemo_t * pMemo , int * pLo , int * pHi )
 {
    assert( head <= tail + 1 );
-   Abc_Obj_t * pObjMux; 
+   Abc_Obj_t * pObjMux , * pObj1 , * pObj0; 
    Thre_S    * tObjC;
-   int curMax , curMin , curW , splitVar;
-
-   curMax = Th_LocalMax( tObjSort , head , tail );
-   curMin = Th_LocalMin( tObjSort , head , tail );
+   int curW , splitVar , head0 , tail0 , lo1 , hi1 , lo0 , hi0;
 
-   if ( curMax <  thre ) return Abc_ObjNot( Abc_AigConst1( pNtkMux ) );
-   if ( curMin >= thre ) return Abc_AigConst1( pNtkMux );
+   if ( (pObjMux = Th_MuxTerminal( tObjSort , pNtkMux , thre , head , tail , pLo , pHi )) ) return pObjMux;
+   if ( (pObjMux = Th_MuxMemoLookup( pMemo , head , tail , thre , pLo , pHi )) ) return pObjMux;
    
    splitVar = Th_SelectVar_Ahead( tObjSort , head , tail , thre );
    assert( splitVar == head || splitVar == tail );
+   head0 = head; tail0 = tail;
    if ( splitVar == head ) ++head;
    else --tail;
    curW     = Vec_IntEntry( tObjSort->weights , splitVar );
    tObjC    = Th_GetObjById( list , Vec_IntEntry( tObjSort->Fanins , splitVar ) );
-   pObjMux  = Abc_AigMux( pNtkMux->pManFunc , tObjC->pCopy , 
-                          Th_Node2MuxDyn_rec( list , tObjSort , pNtkMux , thre-curW , head , tail ) ,
-                          Th_Node2MuxDyn_rec( list , tObjSort , pNtkMux , thre      , head , tail ) );
-   return pObjMux;
+   pObj1    = Th_Node2MuxDyn_rec( list , tObjSort , pNtkMux , thre-curW , head , tail , pMemo , &lo1 , &hi1 );
+   pObj0    = Th_Node2MuxDyn_rec( list , tObjSort , pNtkMux , thre      , head , tail , pMemo , &lo0 , &hi0 );
+   return Th_MuxBuild( tObjSort , pNtkMux , pMemo , head0 , tail0 , splitVar , tObjC->pCopy , pObj1 , lo1 , hi1 , pObj0 , lo0 , hi0 , pLo , pHi );
 }
 
 int
@@ -40,16 +40,17 @@
 ////////////////////////////////////////////////////////////////////////
 
 // main function
-void Th_PBPGEncoding(Vec_Ptr_t*, int);
+void Th_PBPGEncoding(Vec_Ptr_t*, int, char*);
 // helper functions
-void Th_PGEncoding_rec(FILE*, Vec_Ptr_t*, Thre_S*, int);
-void Th_PGWriteNode(FILE*, Thre_S*, int);
+void Th_PGEncoding_rec(Th_Out_t*, Vec_Ptr_t*, Thre_S*, int);
+void Th_PGWriteNode(Th_Out_t*, Thre_S*, int);
 
 /**Function*************************************************************
 
   Synopsis    [Main function to for PG encoding.]
 
-  Description []
+  Description [Writes to fileName , or to pg.opb/no_pg.opb if it is
+               NULL.]
                
   SideEffects []
 
@@ -58,20 +59,27 @@ void Th_PGWriteNode(FILE*, Thre_S*, int);
 ***********************************************************************/
 
 void
-Th_PBPGEncoding(Vec_Ptr_t * current_TList, int fPG)
+Th_PBPGEncoding(Vec_Ptr_t * current_TList, int fPG, char *fileName)
 {
-   char *fileName = fPG ? "pg.opb" : "no_pg.opb";
-   FILE *out      = fopen(fileName, "w");
+   if (!fileName) fileName = fPG ? "pg.opb" : "no_pg.opb";
+   Th_Out_t *out  = Th_OutStart(fileName, Th_OutFileMode(fileName));
    Thre_S *tObj, *tObjPo = NULL;
    int i;
 
+   if (!out) {
+      Abc_Print(-1, "Cannot open output file \"%s\".\n", fileName);
+      return;
+   }
+
 	Vec_PtrForEachEntry( Thre_S * , current_TList , tObj , i )
       tObj->pos = tObj->neg = 0;
 	Vec_PtrForEachEntry( Thre_S * , current_TList , tObj , i )
    {
       if (tObj->Type == Th_Po) {
          tObjPo = tObj;
-         fprintf(out, "min: -1*x_%d;\n", tObj->Id);
+         Th_OutStr(out, "min: -1*x_");
+         Th_OutInt(out, tObj->Id);
+         Th_OutStr(out, ";\n");
          break;
       }
    }
@@ -81,11 +89,11 @@ Th_PBPGEncoding(Vec_Ptr_t * current_TList, int fPG)
    }
    Th_PGEncoding_rec(out, current_TList, tObjPo, 1);
    if (!fPG) Th_PGEncoding_rec(out, current_TList, tObjPo, 0);
-   fclose(out);
+   Th_OutStop(out);
 }
 
 void
-Th_PGEncoding_rec(FILE *out, Vec_Ptr_t *current_TList, Thre_S *tObj, int phase)
+Th_PGEncoding_rec(Th_Out_t *out, Vec_Ptr_t *current_TList, Thre_S *tObj, int phase)
 {
    Thre_S *tObjFin;
    int Entry, i, w;
@@ -110,7 +118,7 @@ Th_PGEncoding_rec(FILE *out, Vec_Ptr_t *current_TList, Thre_S *tObj, int phase)
 }
 
 void
-Th_PGWriteNode(FILE *out, Thre_S *tObj, int phase)
+Th_PGWriteNode(Th_Out_t *out, Thre_S *tObj, int phase)
 {
    int Entry, w, i, M, m;
    int T = tObj->thre;
@@ -120,9 +128,15 @@ Th_PGWriteNode(FILE *out, Thre_S *tObj, int phase)
       Vec_IntForEachEntry(tObj->Fanins, Entry, i)
       {
          w = Vec_IntEntry(tObj->weights, i);
-         fprintf(out, "%s%d*x_%d ", w>0 ? "+" : "", w, Entry);
+         Th_OutTerm(out, w, "x_", Entry);
+         Th_OutChar(out, ' ');
       }
-      fprintf(out, "%d*x_%d >= %d;\n", m-T, tObj->Id, m);
+      Th_OutInt(out, m-T);
+      Th_OutStr(out, "*x_");
+      Th_OutInt(out, tObj->Id);
+      Th_OutStr(out, " >= ");
+      Th_OutInt(out, m);
+      Th_OutStr(out, ";\n");
    }
    else {
       M = 0;
@@ -130,9 +144,16 @@ Th_PGWriteNode(FILE *out, Thre_S *tObj, int phase)
       Vec_IntForEachEntry(tObj->Fanins, Entry, i)
       {
          w = Vec_IntEntry(tObj->weights, i);
-         fprintf(out, "%s%d*x_%d ", -w>0 ? "+" : "", -w, Entry);
+         Th_OutTerm(out, -w, "x_", Entry);
+         Th_OutChar(out, ' ');
       }
-      fprintf(out, "+%d*x_%d >= %d;\n", -T+1+M, tObj->Id, 1-T);
+      Th_OutChar(out, '+');
+      Th_OutInt(out, -T+1+M);
+      Th_OutStr(out, "*x_");
+      Th_OutInt(out, tObj->Id);
+      Th_OutStr(out, " >= ");
+      Th_OutInt(out, 1-T);
+      Th_OutStr(out, ";\n");
    }
 }
 
@@ -0,0 +1,409 @@
+/**CFile****************************************************************
+
+  FileName    [threThb.c]
+
+  SystemName  [ABC: Logic synthesis and verification system.]
+
+  PackageName [threshold.]
+
+  Synopsis    [Binary threshold network format (.thb).]
+
+  Author      [ALCom Lab]
+
+  Affiliation [NTU]
+
+  Date        [Oct 16, 2026.]
+
+  Revision    [$Id: abc.c,v 1.00 2005/06/20 00:00:00 alanmi Exp $]
+
+***********************************************************************/
+
+////////////////////////////////////////////////////////////////////////
+///                          INCLUDES                                ///
+////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <limits.h>
+#include "base/abc/abc.h"
+#include "aig/gia/gia.h"
+#include "threshold.h"
+
+////////////////////////////////////////////////////////////////////////
+///                        DECLARATIONS                              ///
+////////////////////////////////////////////////////////////////////////
+
+/*
+    The format follows the binary AIGER format (giaAiger.c).
+
+    header    "thb I O N\n" : I inputs , O outputs , N internal gates
+    outputs   O records of the outputs
+    gates     N records of the internal gates in topological order
+    symbols   optional lines "i<k> <name>" and "o<k> <name>"
+    comments  optional , after a line "c"
+
+    The file index of the constant is 0 , the inputs are 1..I and the
+    internal gates I+1..I+N ; outputs drive no gates and have none. The
+    records are unsigned LEB128 numbers :
+
+        nFanins
+        f[0] (output) or i - f[0] (internal gate with file index i)
+        zz(f[1] - f[0]) , ... , zz(f[n-1] - f[n-2])
+        zz(w[0]) , ... , zz(w[n-1])
+        zz(thre)
+
+    where f[k] are the file indices of the fanins , w[k] the weights and
+    zz() the zig-zag code of a signed number. Since the gates are in
+    topological order , i - f[0] is positive.
+
+    When read , objects are numbered as by the .th reader : the constant
+    is 0 , then the inputs , the outputs and the internal gates. This is
+    the order of the records , so they are read in place.
+*/
+
+static inline unsigned Th_ThbZig( int x )       { return ((unsigned)x << 1) ^ (unsigned)(x >> 31); }
+static inline int      Th_ThbUnzig( unsigned x ) { return (int)(x >> 1) ^ -(int)(x & 1);           }
+
+////////////////////////////////////////////////////////////////////////
+///                     FUNCTION DEFINITIONS                         ///
+////////////////////////////////////////////////////////////////////////
+
+/**Function*************************************************************
+
+  Synopsis    [Returns 1 if the file name has extension .thb.]
+
+  Description []
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+int Th_FileIsThb( char * pFileName )
+{
+    char * pExt = Extra_FileNameExtension( pFileName );
+    return pExt && !strcmp( pExt, "thb" );
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Topological order of the internal gates.]
+
+  Description [Iterative DFS from the outputs , then from the gates not
+               reachable from them. Returns NULL if the network has a
+               cycle or an output drives another gate.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+static Vec_Int_t * Th_ThbOrder( Th_Ntk_t * p )
+{
+    Vec_Int_t * vOrder = Vec_IntAlloc( Th_NtkObjNum(p) );
+    Vec_Int_t * vStack = Vec_IntAlloc( 1000 );
+    Vec_Int_t * vMark  = Vec_IntStart( Th_NtkObjNum(p) ); // 1 : on the stack , 2 : done
+    int i, j, k, iObj, iFanin, Weight, fOk = 1;
+    Vec_Int_t * vRoots = Vec_IntAlloc( Th_NtkObjNum(p) );
+    Th_NtkForEachObj( p, i )
+        if ( Th_NtkObjType(p, i) == Th_Po )
+            Th_NtkObjForEachFanin( p, i, iFanin, Weight, k )
+                Vec_IntPush( vRoots, iFanin );
+    Th_NtkForEachNode( p, i )
+        Vec_IntPush( vRoots, i );
+    Vec_IntForEachEntry( vRoots, i, j ) {
+        if ( Th_NtkObjType(p, i) == Th_Po ) {
+            printf( "Output %d drives another gate.\n", i );
+            fOk = 0;
+            break;
+        }
+        if ( Th_NtkObjType(p, i) != Th_Node || Vec_IntEntry(vMark, i) )
+            continue;
+        Vec_IntPush( vStack, i );
+        while ( fOk && Vec_IntSize(vStack) ) {
+            iObj = Vec_IntEntryLast( vStack );
+            if ( Vec_IntEntry(vMark, iObj) == 2 ) {
+                Vec_IntPop( vStack );
+                continue;
+            }
+            if ( Vec_IntEntry(vMark, iObj) == 1 ) {
+                Vec_IntWriteEntry( vMark, iObj, 2 );
+                Vec_IntPush( vOrder, iObj );
+                Vec_IntPop( vStack );
+                continue;
+            }
+            Vec_IntWriteEntry( vMark, iObj, 1 );
+            Th_NtkObjForEachFanin( p, iObj, iFanin, Weight, k ) {
+                if ( Th_NtkObjType(p, iFanin) == Th_Po ) {
+                    printf( "Output %d drives another gate.\n", iFanin );
+                    fOk = 0;
+                    break;
+                }
+                if ( Th_NtkObjType(p, iFanin) != Th_Node || Vec_IntEntry(vMark, iFanin) == 2 )
+                    continue;
+                if ( Vec_IntEntry(vMark, iFanin) == 1 ) {
+                    printf( "The network has a cycle through gate %d.\n", iFanin );
+                    fOk = 0;
+                    break;
+                }
+                Vec_IntPush( vStack, iFanin );
+            }
+        }
+        if ( !fOk )
+            break;
+    }
+    Vec_IntFree( vRoots );
+    Vec_IntFree( vStack );
+    Vec_IntFree( vMark );
+    if ( !fOk )
+        Vec_IntFreeP( &vOrder );
+    return vOrder;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Writes a .thb file.]
+
+  Description [Names of the inputs and outputs are written if fNames is
+               set. The file is built in memory and written at once.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+// iFile is 0 for the outputs
+static void Th_ThbWriteGate( Vec_Str_t * vStr, Th_Ntk_t * p, int iObj, int iFile, Vec_Int_t * vMap )
+{
+    int k, iFanin, Weight, f, fPrev = 0;
+    Gia_AigerWriteUnsigned( vStr, Th_NtkObjFaninNum(p, iObj) );
+    Th_NtkObjForEachFanin( p, iObj, iFanin, Weight, k ) {
+        f = Vec_IntEntry( vMap, iFanin );
+        assert( f >= 0 && (iFile == 0 || f < iFile) );
+        if ( k )
+            Gia_AigerWriteUnsigned( vStr, Th_ThbZig(f - fPrev) );
+        else
+            Gia_AigerWriteUnsigned( vStr, iFile ? (unsigned)(iFile - f) : (unsigned)f );
+        fPrev = f;
+    }
+    Th_NtkObjForEachFanin( p, iObj, iFanin, Weight, k )
+        Gia_AigerWriteUnsigned( vStr, Th_ThbZig(Weight) );
+    Gia_AigerWriteUnsigned( vStr, Th_ThbZig(Th_NtkObjThre(p, iObj)) );
+}
+
+int Th_NtkWriteThb( Th_Ntk_t * p, char * pFileName, int fNames )
+{
+    FILE * pFile;
+    Vec_Int_t * vOrder, * vMap;
+    Vec_Str_t * vStr;
+    char Buffer[100];
+    int i, k, iFile, nPis, nPos;
+    vOrder = Th_ThbOrder( p );
+    if ( vOrder == NULL ) {
+        printf( "Th_NtkWriteThb() : the network cannot be written.\n" );
+        return 0;
+    }
+    pFile = fopen( pFileName, "wb" );
+    if ( pFile == NULL ) {
+        printf( "Th_NtkWriteThb() : cannot open file %s for writing.\n", pFileName );
+        Vec_IntFree( vOrder );
+        return 0;
+    }
+    // file indices : constant , inputs , internal gates
+    vMap = Vec_IntStartFull( Th_NtkObjNum(p) );
+    iFile = 1;
+    nPos  = 0;
+    Th_NtkForEachObj( p, i )
+        if ( Th_NtkObjType(p, i) == Th_CONST1 )
+            Vec_IntWriteEntry( vMap, i, 0 );
+        else if ( Th_NtkObjType(p, i) == Th_Pi )
+            Vec_IntWriteEntry( vMap, i, iFile++ );
+        else if ( Th_NtkObjType(p, i) == Th_Po )
+            nPos++;
+    nPis = iFile - 1;
+    Vec_IntForEachEntry( vOrder, i, k )
+        Vec_IntWriteEntry( vMap, i, iFile++ );
+
+    vStr = Vec_StrAlloc( 4 * Vec_IntSize(p->vFanins) + 8 * Th_NtkObjNum(p) + 100 );
+    sprintf( Buffer, "thb %d %d %d\n", nPis, nPos, Vec_IntSize(vOrder) );
+    Vec_StrPrintStr( vStr, Buffer );
+    Th_NtkForEachObj( p, i )
+        if ( Th_NtkObjType(p, i) == Th_Po )
+            Th_ThbWriteGate( vStr, p, i, 0, vMap );
+    Vec_IntForEachEntry( vOrder, i, k )
+        Th_ThbWriteGate( vStr, p, i, Vec_IntEntry(vMap, i), vMap );
+    // symbols
+    if ( fNames ) {
+        int iPi = 0, iPo = 0;
+        Th_NtkForEachObj( p, i ) {
+            if ( Th_NtkObjType(p, i) == Th_Pi )
+                sprintf( Buffer, "i%d ", iPi++ );
+            else if ( Th_NtkObjType(p, i) == Th_Po )
+                sprintf( Buffer, "o%d ", iPo++ );
+            else
+                continue;
+            if ( Th_NtkObjName(p, i) == NULL )
+                continue;
+            Vec_StrPrintStr( vStr, Buffer );
+            Vec_StrPrintStr( vStr, Th_NtkObjName(p, i) );
+            Vec_StrPush( vStr, '\n' );
+        }
+    }
+    fwrite( Vec_StrArray(vStr), 1, Vec_StrSize(vStr), pFile );
+    fclose( pFile );
+    Vec_StrFree( vStr );
+    Vec_IntFree( vMap );
+    Vec_IntFree( vOrder );
+    return 1;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Reads a .thb file.]
+
+  Description [Inputs and outputs without a name in the file are named
+               by their object ids , as if written by write_th and read
+               back. Returns NULL if the file is malformed.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+static void Th_ThbSetName( Th_Ntk_t * p, int iObj, char * pName, int nLen )
+{
+    Vec_IntWriteEntry( p->vNameStart, iObj, Vec_StrSize(p->vNames) );
+    Vec_StrPushBuffer( p->vNames, pName, nLen );
+    Vec_StrPush( p->vNames, '\0' );
+}
+
+Th_Ntk_t * Th_NtkReadThb( char * pFileName )
+{
+    FILE * pFile;
+    Th_Ntk_t * p = NULL;
+    Vec_Int_t * vFill;
+    unsigned char * pContents, * pCur, * pEnd;
+    char * pName, Buffer[20];
+    int nFileSize, nPis, nPos, nNodes, nObjs;
+    int i, k, nFanins, f, iFile, iObj, iFanin, Weight, Pos;
+
+    pFile = fopen( pFileName, "rb" );
+    if ( pFile == NULL ) {
+        printf( "Cannot open file \"%s\".\n", pFileName );
+        return NULL;
+    }
+    fseek( pFile, 0, SEEK_END );
+    nFileSize = ftell( pFile );
+    rewind( pFile );
+    // zero padding stops a number running past the end of a truncated file
+    pContents = ABC_CALLOC( unsigned char, nFileSize + 16 );
+    nFileSize = fread( pContents, 1, nFileSize, pFile );
+    fclose( pFile );
+    pEnd = pContents + nFileSize;
+
+    if ( sscanf( (char *)pContents, "thb %d %d %d", &nPis, &nPos, &nNodes ) != 3 || nPis < 0 || nPos < 0 || nNodes < 0 ||
+         nPos > INT_MAX - 1 - nPis || nNodes > INT_MAX - 1 - nPis - nPos ) {
+        printf( "\"%s\" does not start with a .thb header.\n", pFileName );
+        ABC_FREE( pContents );
+        return NULL;
+    }
+    pCur = (unsigned char *)memchr( pContents, '\n', nFileSize );
+    pCur = pCur ? pCur + 1 : pEnd;
+
+    // objects : constant , inputs , outputs , internal gates ; a fanin
+    // with file index f is object f if f <= nPis and f + nPos otherwise
+    nObjs = 1 + nPis + nPos + nNodes;
+    p = Th_NtkAlloc( nObjs, nFileSize / 2 );
+    Vec_IntWriteEntry( p->vType, 0, Th_CONST1 );
+    for ( iObj = 1; iObj <= nPis; iObj++ )
+        Vec_IntWriteEntry( p->vType, iObj, Th_Pi );
+    Vec_IntFill( p->vFaninStart, nPis + 1, 0 );
+    for ( ; iObj < nObjs && pCur < pEnd; iObj++ ) {
+        iFile = iObj > nPis + nPos ? iObj - nPos : 0;
+        Vec_IntPush( p->vFaninStart, Vec_IntSize(p->vFanins) );
+        Vec_IntWriteEntry( p->vType, iObj, iFile ? Th_Node : Th_Po );
+        nFanins = Gia_AigerReadUnsigned( &pCur );
+        // an output has exactly one fanin , as in the .th reader
+        if ( !iFile && nFanins != 1 )
+            break;
+        for ( k = 0, f = 0; k < nFanins && pCur < pEnd; k++ ) {
+            if ( k )
+                f += Th_ThbUnzig( Gia_AigerReadUnsigned(&pCur) );
+            else if ( iFile )
+                f = iFile - (int)Gia_AigerReadUnsigned( &pCur );
+            else
+                f = (int)Gia_AigerReadUnsigned( &pCur );
+            if ( f < 0 || f >= (iFile ? iFile : nPis + 1 + nNodes) )
+                break;
+            Vec_IntPush( p->vFanins, f <= nPis ? f : f + nPos );
+        }
+        if ( k < nFanins )
+            break;
+        for ( k = 0; k < nFanins && pCur < pEnd; k++ )
+            Vec_IntPush( p->vWeights, Th_ThbUnzig( Gia_AigerReadUnsigned(&pCur) ) );
+        if ( k < nFanins || pCur >= pEnd )
+            break;
+        Vec_IntWriteEntry( p->vThre, iObj, Th_ThbUnzig( Gia_AigerReadUnsigned(&pCur) ) );
+    }
+    if ( iObj < nObjs || pCur > pEnd ) {
+        printf( "\"%s\" is truncated or has a bad record for object %d.\n", pFileName, iObj );
+        Th_NtkFree( p );
+        p = NULL;
+        goto finish;
+    }
+    Vec_IntPush( p->vFaninStart, Vec_IntSize(p->vFanins) );
+
+    // fanouts in the order of the object ids , as the .th reader does
+    Vec_IntFill( p->vFanouts, Vec_IntSize(p->vFanins), 0 );
+    for ( k = 0; k < Vec_IntSize(p->vFanins); k++ )
+        Vec_IntAddToEntry( p->vFanoutStart, Vec_IntEntry(p->vFanins, k) + 1, 1 );
+    for ( iObj = 0; iObj < nObjs; iObj++ )
+        Vec_IntAddToEntry( p->vFanoutStart, iObj + 1, Vec_IntEntry(p->vFanoutStart, iObj) );
+    vFill = Vec_IntDup( p->vFanoutStart );
+    for ( iObj = 0; iObj < nObjs; iObj++ )
+        Th_NtkObjForEachFanin( p, iObj, iFanin, Weight, k ) {
+            Pos = Vec_IntEntry( vFill, iFanin );
+            Vec_IntWriteEntry( vFill, iFanin, Pos + 1 );
+            Vec_IntWriteEntry( p->vFanouts, Pos, iObj );
+        }
+    Vec_IntFree( vFill );
+
+    // symbols
+    while ( pCur < pEnd && (*pCur == 'i' || *pCur == 'o') ) {
+        int fPi = (*pCur++ == 'i');
+        i = 0;
+        while ( pCur < pEnd && *pCur >= '0' && *pCur <= '9' )
+            i = 10 * i + (*pCur++ - '0');
+        if ( pCur == pEnd || *pCur++ != ' ' || i >= (fPi ? nPis : nPos) ) {
+            printf( "\"%s\" has a bad symbol line.\n", pFileName );
+            Th_NtkFree( p );
+            p = NULL;
+            goto finish;
+        }
+        pName = (char *)pCur;
+        while ( pCur < pEnd && *pCur != '\n' )
+            pCur++;
+        Th_ThbSetName( p, fPi ? 1 + i : 1 + nPis + i, pName, (char *)pCur - pName );
+        if ( pCur < pEnd )
+            pCur++;
+    }
+    if ( pCur < pEnd && *pCur != 'c' )
+        printf( "Warning : \"%s\" has %d unexpected bytes at the end.\n", pFileName, (int)(pEnd - pCur) );
+    for ( iObj = 1; iObj <= nPis + nPos; iObj++ )
+        if ( Th_NtkObjName(p, iObj) == NULL ) {
+            sprintf( Buffer, "%d", iObj );
+            Th_ThbSetName( p, iObj, Buffer, strlen(Buffer) );
+        }
+    printf( "\tPIcount:%d\n\tPOcount:%d\n\tTGcount:%d\n", nPis, nPos, nNodes + nPos );
+
+finish:
+    ABC_FREE( pContents );
+    return p;
+}
+
+////////////////////////////////////////////////////////////////////////
+///                       END OF FILE                                ///
+////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,339 @@
+/**CFile****************************************************************
+
+  FileName    [threTok.c]
+
+  SystemName  [ABC: Logic synthesis and verification system.]
+
+  PackageName [threshold.]
+
+  Synopsis    [Zero-copy tokenizer of text input files.]
+
+  Author      [ALCom Lab]
+
+  Affiliation [NTU]
+
+  Date        [Oct 16, 2026.]
+
+  Revision    [$Id: abc.c,v 1.00 2005/06/20 00:00:00 alanmi Exp $]
+
+***********************************************************************/
+
+////////////////////////////////////////////////////////////////////////
+///                          INCLUDES                                ///
+////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <limits.h>
+#include "base/abc/abc.h"
+#include "misc/zlib/zlib.h"
+#include "misc/bzlib/bzlib.h"
+#include "threshold.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////
+///                        DECLARATIONS                              ///
+////////////////////////////////////////////////////////////////////////
+
+// the file is scanned in place ; a token is the range [pBeg, pEnd) of
+// the buffer and is never copied or zero-terminated
+struct Th_Tok_t_
+{
+    char *       pFileName;   // the file name
+    char *       pBuffer;     // the contents of the file
+    size_t       nSize;       // the size of the file
+    int          fMapped;     // the buffer is mapped rather than read
+    char *       pCur;        // the current position
+    char *       pEnd;        // the end of the buffer
+    int          iLine;       // the line of the last token
+};
+
+static inline int Th_TokIsSpace( char c ) { return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\v'; }
+
+////////////////////////////////////////////////////////////////////////
+///                     FUNCTION DEFINITIONS                         ///
+////////////////////////////////////////////////////////////////////////
+
+/**Function*************************************************************
+
+  Synopsis    [Reads a gzip-compressed file.]
+
+  Description [Returns the decompressed contents or NULL if the file
+               cannot be opened or is corrupted.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+static char * Th_TokReadGz( char * pFileName, size_t * pnSize )
+{
+    gzFile pGz = gzopen( pFileName, "rb" );
+    size_t nCap = (1 << 20), nSize = 0;
+    char * pBuffer;
+    int nRead;
+    if ( pGz == NULL )
+        return NULL;
+    pBuffer = ABC_ALLOC( char, nCap );
+    // gzread() reads at most INT_MAX bytes at a time
+    while ( (nRead = gzread( pGz, pBuffer + nSize, nCap - nSize > (1u << 30) ? (1u << 30) : (unsigned)(nCap - nSize) )) > 0 ) {
+        nSize += (size_t)nRead;
+        if ( nSize == nCap )
+            pBuffer = ABC_REALLOC( char, pBuffer, (nCap *= 2) );
+    }
+    gzclose( pGz );
+    if ( nRead < 0 ) {
+        printf( "Th_TokStart() : file \"%s\" is not a valid gzip file.\n", pFileName );
+        ABC_FREE( pBuffer );
+        return NULL;
+    }
+    *pnSize = nSize;
+    return pBuffer;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Reads a bzip2-compressed file.]
+
+  Description [Returns the decompressed contents or NULL if the file
+               cannot be opened or is corrupted.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+static char * Th_TokReadBz2( char * pFileName, size_t * pnSize )
+{
+    FILE * pFile = fopen( pFileName, "rb" );
+    size_t nCap = (1 << 20), nSize = 0;
+    char * pBuffer;
+    BZFILE * pBz;
+    int bzError, bzStatus, nRead;
+    if ( pFile == NULL )
+        return NULL;
+    pBz = BZ2_bzReadOpen( &bzError, pFile, 0, 0, NULL, 0 );
+    if ( bzError != BZ_OK ) {
+        printf( "Th_TokStart() : file \"%s\" is not a valid bzip2 file.\n", pFileName );
+        fclose( pFile );
+        return NULL;
+    }
+    pBuffer = ABC_ALLOC( char, nCap );
+    // BZ2_bzRead() reads at most INT_MAX bytes at a time
+    do {
+        nRead = BZ2_bzRead( &bzError, pBz, pBuffer + nSize, nCap - nSize > (1u << 30) ? (1 << 30) : (int)(nCap - nSize) );
+        if ( nRead > 0 && (nSize += (size_t)nRead) == nCap )
+            pBuffer = ABC_REALLOC( char, pBuffer, (nCap *= 2) );
+    } while ( bzError == BZ_OK );
+    bzStatus = bzError;
+    BZ2_bzReadClose( &bzError, pBz );
+    fclose( pFile );
+    if ( bzStatus != BZ_STREAM_END ) {
+        printf( "Th_TokStart() : file \"%s\" is not a valid bzip2 file.\n", pFileName );
+        ABC_FREE( pBuffer );
+        return NULL;
+    }
+    *pnSize = nSize;
+    return pBuffer;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Opens a file for tokenizing.]
+
+  Description [The file is mapped into memory where mmap is available
+               and read in one piece otherwise ; a name ending with .gz
+               or .bz2 is decompressed into memory. Returns NULL if the file
+               cannot be opened.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+Th_Tok_t * Th_TokStart( char * pFileName )
+{
+    Th_Tok_t * p;
+    char * pBuffer = NULL;
+    size_t nSize = 0;
+    int fMapped = 0;
+    if ( Th_OutFileMode( pFileName ) == TH_OUT_GZ ) {
+        if ( (pBuffer = Th_TokReadGz( pFileName, &nSize )) == NULL )
+            return NULL;
+    }
+    else if ( Th_OutFileMode( pFileName ) == TH_OUT_BZ2 ) {
+        if ( (pBuffer = Th_TokReadBz2( pFileName, &nSize )) == NULL )
+            return NULL;
+    }
+    else {
+#ifndef _WIN32
+        struct stat st;
+        int fd = open( pFileName, O_RDONLY );
+        if ( fd == -1 )
+            return NULL;
+        if ( fstat( fd, &st ) == 0 && S_ISREG(st.st_mode) ) {
+            nSize = (size_t)st.st_size;
+            if ( nSize == 0 )
+                fMapped = 1;
+            else if ( (pBuffer = (char *)mmap( NULL, nSize, PROT_READ, MAP_PRIVATE, fd, 0 )) != MAP_FAILED ) {
+                madvise( pBuffer, nSize, MADV_SEQUENTIAL );
+                fMapped = 1;
+            }
+            else
+                pBuffer = NULL;
+        }
+        close( fd );
+#endif
+        if ( !fMapped ) {
+            FILE * pFile = fopen( pFileName, "rb" );
+            if ( pFile == NULL )
+                return NULL;
+            fseek( pFile, 0, SEEK_END );
+            nSize = (size_t)ftell( pFile );
+            rewind( pFile );
+            pBuffer = ABC_ALLOC( char, nSize + 1 );
+            nSize = fread( pBuffer, 1, nSize, pFile );
+            fclose( pFile );
+        }
+    }
+    p = ABC_CALLOC( Th_Tok_t, 1 );
+    p->pFileName = Abc_UtilStrsav( pFileName );
+    p->pBuffer   = pBuffer;
+    p->nSize     = nSize;
+    p->fMapped   = fMapped;
+    p->pCur      = pBuffer;
+    p->pEnd      = pBuffer + nSize;
+    p->iLine     = 1;
+    return p;
+}
+
+void Th_TokStop( Th_Tok_t * p )
+{
+#ifndef _WIN32
+    if ( p->fMapped ) {
+        if ( p->nSize )
+            munmap( p->pBuffer, p->nSize );
+    }
+    else
+#endif
+    ABC_FREE( p->pBuffer );
+    ABC_FREE( p->pFileName );
+    ABC_FREE( p );
+}
+
+char * Th_TokFileName( Th_Tok_t * p )  { return p->pFileName; }
+int    Th_TokFileSize( Th_Tok_t * p )  { return p->nSize > (size_t)ABC_INFINITY ? ABC_INFINITY : (int)p->nSize; }
+int    Th_TokLine( Th_Tok_t * p )      { return p->iLine;     }
+
+/**Function*************************************************************
+
+  Synopsis    [Returns the next token.]
+
+  Description [Skips white space and sets [*ppBeg, *ppEnd) to the next
+               token. Returns 0 at the end of the file.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+int Th_TokNext( Th_Tok_t * p, char ** ppBeg, char ** ppEnd )
+{
+    char * pCur = p->pCur, * pEnd = p->pEnd;
+    for ( ; pCur < pEnd && Th_TokIsSpace(*pCur); pCur++ )
+        if ( *pCur == '\n' )
+            p->iLine++;
+    *ppBeg = pCur;
+    for ( ; pCur < pEnd && !Th_TokIsSpace(*pCur); pCur++ );
+    *ppEnd = p->pCur = pCur;
+    return *ppBeg < *ppEnd;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Skips the rest of the current line.]
+
+  Description [Used for header and comment lines.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+void Th_TokSkipLine( Th_Tok_t * p )
+{
+    char * pNl = p->pCur < p->pEnd ? (char *)memchr( p->pCur, '\n', p->pEnd - p->pCur ) : NULL;
+    if ( pNl == NULL )
+        p->pCur = p->pEnd;
+    else {
+        p->pCur = pNl + 1;
+        p->iLine++;
+    }
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Compares a token with a string.]
+
+  Description [Returns 1 if the token starts with pStr.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+int Th_TokIsPrefix( char * pBeg, char * pEnd, char * pStr )
+{
+    for ( ; *pStr; pBeg++, pStr++ )
+        if ( pBeg == pEnd || *pBeg != *pStr )
+            return 0;
+    return 1;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Parses a token as a decimal integer.]
+
+  Description [An optional sign and decimal digits , independent of the
+               locale. Returns 0 if the token is not an integer or does
+               not fit in an int.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+int Th_TokReadInt( char * pBeg, char * pEnd, int * pValue )
+{
+    long long Value = 0;
+    int fNeg = 0;
+    if ( pBeg < pEnd && (*pBeg == '-' || *pBeg == '+') )
+        fNeg = (*pBeg++ == '-');
+    if ( pBeg == pEnd )
+        return 0;
+    for ( ; pBeg < pEnd; pBeg++ ) {
+        if ( (unsigned)(*pBeg - '0') > 9 )
+            return 0;
+        Value = 10 * Value + (*pBeg - '0');
+        if ( Value > (long long)INT_MAX + fNeg )
+            return 0;
+    }
+    *pValue = (int)(fNeg ? -Value : Value);
+    return 1;
+}
+
+////////////////////////////////////////////////////////////////////////
+///                       END OF FILE                                ///
+////////////////////////////////////////////////////////////////////////
@@ -43,9 +43,41 @@ typedef enum {
 	Th_CONST1 // const1 gate always has Id = 0
 }Th_Gate_Type;
 
+// CNF encodings of threshold gates (threCnfEnc.c)
+typedef enum {
+	TH_CNF_ENC_AUTO = 0,   // fewest estimated clauses per gate
+	TH_CNF_ENC_BDD,        // shared cofactors
+	TH_CNF_ENC_COUNTER,    // sequential weight counter
+	TH_CNF_ENC_TOTALIZER,  // generalized totalizer
+	TH_CNF_ENC_ADDER,      // binary adder and comparator
+	TH_CNF_ENC_PB,         // native PB constraints ( built-in solver only )
+	TH_CNF_ENC_NUM
+}Th_CnfEnc_t;
+
+// gate evaluation kernels of the bit-parallel simulator (threSim.c)
+typedef enum {
+	TH_SIM_AUTO = 0,       // widest kernel compiled in
+	TH_SIM_WORD,           // 64 patterns per step
+	TH_SIM_SSE2,           // 128 patterns per step
+	TH_SIM_AVX2,           // 256 patterns per step
+	TH_SIM_NUM
+}Th_SimKernel_t;
+
+// stream compression of the text writers (threOut.c)
+typedef enum {
+	TH_OUT_PLAIN = 0,      // no compression
+	TH_OUT_GZ,             // zlib
+	TH_OUT_BZ2,            // bzip2
+	TH_OUT_NUM
+}Th_OutMode_t;
+
 typedef struct Thre_S_       Thre_S;   
 typedef struct Pair_S_       Pair_S;
 typedef struct Th_Stat_      Th_Stat;
+typedef struct Th_Ntk_t_     Th_Ntk_t;
+typedef struct Th_CnfMan_t_  Th_CnfMan_t;
+typedef struct Th_Tok_t_     Th_Tok_t;
+typedef struct Th_Out_t_     Th_Out_t;
 
 struct Thre_S_
 {
@@ -64,6 +96,13 @@ struct Thre_S_
    Vec_Int_t * weights;
    Vec_Int_t * Fanins;
    Vec_Int_t * Fanouts;
+   // collapse index (Th_NtkBuildFanioIndex) : position at the other end
+   Vec_Int_t * FaninPos;   // FaninPos[j]  : position in Fanouts of j-th fanin
+   Vec_Int_t * FanoutPos;  // FanoutPos[k] : position in Fanins of k-th fanout
+   // cached weight sums (Th_ObjSumCompute) : prefix sums over fanins 0..i-1
+   int         fSumValid;  // reset by Th_ObjSumInvalidate() after in-place weight changes
+   Vec_Int_t * vSumPos;    // vSumPos[i] : sum of positive weights
+   Vec_Int_t * vSumNeg;    // vSumNeg[i] : sum of negative weights
    Abc_Obj_t * pCopy;
 };
 
@@ -84,20 +123,93 @@ struct Th_Stat_
 	int numTwoFout;
 	int numTwoFoutOk;
 	int numNotThNode;
+   // pair collapse feasibility checks
+   int     numPairCheck;
+   int     numPairCheckOk;
+   abctime clkPairCheck;
+   // local certificates of collapse steps (threCert.c)
+   int     numClpCheck;
+   int     numClpCheckTt;
+   int     numClpCheckSat;
+   int     numClpCheckUndec;
+   int     numClpCheckFail;
+   abctime clkClpCheck;
    // threshold --> mux redundancy check
    int numRedundancy;
    int redund[50];
 };
 
+// compact network : object ids are the ids of the Thre_S list,
+// deleted objects have type Th_Unknown and no fanins/fanouts
+struct Th_Ntk_t_
+{
+   int         nObjs;
+   Vec_Int_t * vType;         // object types
+   Vec_Int_t * vThre;         // thresholds
+   Vec_Int_t * vFaninStart;   // nObjs+1 offsets into vFanins/vWeights
+   Vec_Int_t * vFanins;       // fanin ids, object by object
+   Vec_Int_t * vWeights;      // fanin weights, aligned with vFanins
+   Vec_Int_t * vFanoutStart;  // nObjs+1 offsets into vFanouts
+   Vec_Int_t * vFanouts;      // fanout ids, object by object
+   Vec_Int_t * vNameStart;    // offset into vNames or -1
+   Vec_Str_t * vNames;        // zero-terminated object names
+};
+
+////////////////////////////////////////////////////////////////////////
+///                      MACRO DEFINITIONS                           ///
+////////////////////////////////////////////////////////////////////////
+
+static inline int    Th_NtkObjNum( Th_Ntk_t * p )                   { return p->nObjs;                                                                      }
+static inline int    Th_NtkObjType( Th_Ntk_t * p, int i )           { return Vec_IntEntry( p->vType, i );                                                   }
+static inline int    Th_NtkObjThre( Th_Ntk_t * p, int i )           { return Vec_IntEntry( p->vThre, i );                                                   }
+static inline int    Th_NtkObjFaninNum( Th_Ntk_t * p, int i )       { return Vec_IntEntry( p->vFaninStart, i+1 ) - Vec_IntEntry( p->vFaninStart, i );      }
+static inline int    Th_NtkObjFanoutNum( Th_Ntk_t * p, int i )      { return Vec_IntEntry( p->vFanoutStart, i+1 ) - Vec_IntEntry( p->vFanoutStart, i );    }
+static inline int *  Th_NtkObjFanins( Th_Ntk_t * p, int i )         { return Vec_IntArray( p->vFanins ) + Vec_IntEntry( p->vFaninStart, i );                  }
+static inline int *  Th_NtkObjWeights( Th_Ntk_t * p, int i )        { return Vec_IntArray( p->vWeights ) + Vec_IntEntry( p->vFaninStart, i );                 }
+static inline int *  Th_NtkObjFanouts( Th_Ntk_t * p, int i )        { return Vec_IntArray( p->vFanouts ) + Vec_IntEntry( p->vFanoutStart, i );                }
+static inline int    Th_NtkObjFanin( Th_Ntk_t * p, int i, int k )   { return Vec_IntEntry( p->vFanins, Vec_IntEntry( p->vFaninStart, i ) + k );             }
+static inline int    Th_NtkObjWeight( Th_Ntk_t * p, int i, int k )  { return Vec_IntEntry( p->vWeights, Vec_IntEntry( p->vFaninStart, i ) + k );            }
+static inline int    Th_NtkObjFanout( Th_Ntk_t * p, int i, int k )  { return Vec_IntEntry( p->vFanouts, Vec_IntEntry( p->vFanoutStart, i ) + k );           }
+static inline char * Th_NtkObjName( Th_Ntk_t * p, int i )           { return Vec_IntEntry( p->vNameStart, i ) < 0 ? NULL : Vec_StrEntryP( p->vNames, Vec_IntEntry( p->vNameStart, i ) ); }
+
+extern void Th_ObjSumCompute( Thre_S * tObj );
+
+// weight sums of a Thre_S , recomputed only if weights changed (pushes are detected by size) ;
+// the const getters refill the cache in place , so they are not thread-safe : the worker
+// threads of Th_SplitCompare() must not call them
+static inline void   Th_ObjSumInvalidate( Thre_S * tObj )           { tObj->fSumValid = 0;                                                                  }
+static inline void   Th_ObjSumUpdate( const Thre_S * tObj )         { if ( !tObj->fSumValid || Vec_IntSize(tObj->vSumPos) != Vec_IntSize(tObj->weights)+1 ) Th_ObjSumCompute( (Thre_S *)tObj ); }
+static inline int    Th_ObjSumPos( const Thre_S * tObj, int h, int t ) { Th_ObjSumUpdate( tObj ); return Vec_IntEntry( tObj->vSumPos, t+1 ) - Vec_IntEntry( tObj->vSumPos, h ); }
+static inline int    Th_ObjSumNeg( const Thre_S * tObj, int h, int t ) { Th_ObjSumUpdate( tObj ); return Vec_IntEntry( tObj->vSumNeg, t+1 ) - Vec_IntEntry( tObj->vSumNeg, h ); }
+// sums over all fanins but the nFanin-th one (nFanin < 0 : all fanins)
+static inline int    Th_ObjMaxF( const Thre_S * tObj, int nFanin )  { int n = Vec_IntSize(tObj->weights); return Th_ObjSumPos( tObj, 0, n-1 ) - ((nFanin >= 0 && nFanin < n) ? Th_ObjSumPos( tObj, nFanin, nFanin ) : 0); }
+static inline int    Th_ObjMinF( const Thre_S * tObj, int nFanin )  { int n = Vec_IntSize(tObj->weights); return Th_ObjSumNeg( tObj, 0, n-1 ) - ((nFanin >= 0 && nFanin < n) ? Th_ObjSumNeg( tObj, nFanin, nFanin ) : 0); }
+// collapse index of a Thre_S , built by Th_NtkBuildFanioIndex()
+static inline int    Th_ObjHasFanioIndex( const Thre_S * tObj )     { return tObj->FanoutPos && Vec_IntSize(tObj->FanoutPos) == Vec_IntSize(tObj->Fanouts); }
+// shifts an end of a residual threshold interval by w , the infinite ends stay infinite
+static inline int    Th_IntervalShift( int b, int w )               { return ( b <= -ABC_INFINITY || b >= ABC_INFINITY ) ? b : b + w;                      }
+
+#define Th_NtkForEachObj( p, i )                                                  \
+    for ( i = 0; i < Th_NtkObjNum(p); i++ ) if ( Th_NtkObjType(p, i) == Th_Unknown ) {} else
+#define Th_NtkForEachNode( p, i )                                                 \
+    for ( i = 0; i < Th_NtkObjNum(p); i++ ) if ( Th_NtkObjType(p, i) != Th_Node ) {} else
+#define Th_NtkObjForEachFanin( p, i, iFanin, Weight, k )                          \
+    for ( k = 0; k < Th_NtkObjFaninNum(p, i) && (((iFanin) = Th_NtkObjFanin(p, i, k)), ((Weight) = Th_NtkObjWeight(p, i, k)), 1); k++ )
+#define Th_NtkObjForEachFanout( p, i, iFanout, k )                                \
+    for ( k = 0; k < Th_NtkObjFanoutNum(p, i) && (((iFanout) = Th_NtkObjFanout(p, i, k)), 1); k++ )
+
 ////////////////////////////////////////////////////////////////////////
 ///                         GLOABAL VAR                              ///
 ////////////////////////////////////////////////////////////////////////
 
-Vec_Ptr_t * current_TList;
-//Vec_Ptr_t * another_TList;
-Vec_Ptr_t * cut_TList;
-int         globalRef; // for iterative collapse
-Th_Stat     thProfiler;
+extern Vec_Ptr_t * current_TList;
+//extern Vec_Ptr_t * another_TList;
+extern Vec_Ptr_t * cut_TList;
+extern int         globalRef; // for iterative collapse
+extern Th_Stat     thProfiler;
+extern int         thKLDP;    // solve K/L by iff (DP) conditions instead of if conditions
+extern int         thClpCheck; // check every collapse step on its local support
+extern int         thSimKernel; // gate evaluation kernel of the simulator (Th_SimKernel_t)
 
 ////////////////////////////////////////////////////////////////////////
 ///                    FUNCTION DECLARATIONS                         ///
@@ -113,12 +225,39 @@ extern Thre_S    *  getPtrByName(Vec_Ptr_t* , char*);
 extern void         printNodeStats(Vec_Ptr_t*);
 extern void         dumpTh2FileNZ(Vec_Ptr_t * , char*);
 
+//===threTok.c==================================//
+
+extern Th_Tok_t * Th_TokStart           ( char * );
+extern void       Th_TokStop            ( Th_Tok_t * );
+extern char*      Th_TokFileName        ( Th_Tok_t * );
+extern int        Th_TokFileSize        ( Th_Tok_t * );
+extern int        Th_TokLine            ( Th_Tok_t * );
+extern int        Th_TokNext            ( Th_Tok_t * , char ** , char ** );
+extern void       Th_TokSkipLine        ( Th_Tok_t * );
+extern int        Th_TokIsPrefix        ( char * , char * , char * );
+extern int        Th_TokReadInt         ( char * , char * , int * );
+
+//===threOut.c==================================//
+
+extern int        Th_OutFileMode        ( char * );
+extern Th_Out_t * Th_OutStart           ( char * , int );
+extern int        Th_OutStop            ( Th_Out_t * );
+extern void       Th_OutChar            ( Th_Out_t * , char );
+extern void       Th_OutStr             ( Th_Out_t * , const char * );
+extern void       Th_OutInt             ( Th_Out_t * , int );
+extern void       Th_OutCoef            ( Th_Out_t * , int );
+extern void       Th_OutTerm            ( Th_Out_t * , int , const char * , int );
+extern void       Th_OutClause          ( Th_Out_t * , int * , int );
+
 //===threEC.c===================================//
 
 extern void        func_EC_writePB(Abc_Ntk_t *, Vec_Ptr_t *, char*);
-extern Vec_Ptr_t*  thre_PB(FILE*, Vec_Ptr_t *);
-extern Vec_Ptr_t*  alan_PB(FILE*, Abc_Ntk_t *);
-extern void        miter_PB(FILE*, Vec_Ptr_t*, Vec_Ptr_t *);
+extern Vec_Ptr_t*  thre_PB(Th_Out_t*, Vec_Ptr_t *);
+extern Vec_Ptr_t*  alan_PB(Th_Out_t*, Abc_Ntk_t *);
+extern void        miter_PB(Th_Out_t*, Vec_Ptr_t*, Vec_Ptr_t *);
+extern Vec_Ptr_t*  Th_PBWriteList(Th_Out_t*, Vec_Ptr_t *, char *, char *);
+extern void        Th_PBWriteMiterOut(Th_Out_t*, char *, int, char *, int, int);
+extern void        Th_PBWriteMiterOr(Th_Out_t*, int);
 extern int         Max_Thre(Thre_S *);
 extern int         min_Thre(Thre_S *);
 
@@ -132,6 +271,11 @@ extern void aigThConnectFanin( Abc_Ntk_t * , Vec_Ptr_t * , Vec_Int_t * );
 extern void aigThConnectFanout( Abc_Ntk_t * , Vec_Ptr_t *  , Vec_Int_t * );
 extern Thre_S*    Th_CreateObj( Vec_Ptr_t * , Th_Gate_Type );
 extern void       Th_DeleteObj( Thre_S * );
+extern Thre_S*    Th_ObjAlloc( );
+extern void       Th_ObjRecycle( Thre_S * );
+extern Vec_Int_t* Th_VecIntFetch( );
+extern void       Th_VecIntRecycle( Vec_Int_t * );
+extern void       Th_ObjManStop( );
 extern Vec_Ptr_t* aig2Th( Abc_Ntk_t * ); 
 
 //===threKLMerge.c===================================//
@@ -159,11 +303,32 @@ extern int        Th_CountGate          ( Vec_Ptr_t * , Th_Gate_Type );
 extern int        Th_CountLevel         ( Vec_Ptr_t * );
 extern void       Th_SetLevel           ( Vec_Ptr_t * );
 extern void       Th_ComputeLevel       ( Vec_Ptr_t * );
-extern void       Th_ComputeLevel_rec   ( Vec_Ptr_t * , Thre_S * );
 extern int        Th_FindMaxLevel       ( Vec_Ptr_t * );
+extern void       Th_NtkLevelForward    ( Vec_Ptr_t * );
+extern void       Th_NtkLevelUpdate     ( Vec_Ptr_t * , int , Vec_Int_t * , Vec_Int_t * );
 extern Vec_Int_t* Th_CountFanio         ( Vec_Ptr_t * , int );
 extern void       Th_PrintData          ( int , int , int , int , Vec_Int_t * , Vec_Int_t * );
 
+//===threNtk.c===================================//
+
+extern Th_Ntk_t*  Th_NtkAlloc           ( int , int );
+extern void       Th_NtkFree            ( Th_Ntk_t * );
+extern Th_Ntk_t*  Th_NtkFromList        ( Vec_Ptr_t * );
+extern Vec_Ptr_t* Th_NtkToList          ( Th_Ntk_t * );
+extern double     Th_NtkMemory          ( Th_Ntk_t * );
+extern double     Th_ListMemory         ( Vec_Ptr_t * );
+extern int        Th_NtkCountGate       ( Th_Ntk_t * , Th_Gate_Type );
+extern Vec_Int_t* Th_NtkCountFanio      ( Th_Ntk_t * , int );
+extern int        Th_NtkCountLevel      ( Th_Ntk_t * );
+extern void       Th_NtkPrintStat       ( Th_Ntk_t * );
+extern void       Th_NtkWriteTh         ( Th_Ntk_t * , char * );
+
+//===threThb.c================================//
+
+extern int        Th_FileIsThb          ( char * );
+extern int        Th_NtkWriteThb        ( Th_Ntk_t * , char * , int );
+extern Th_Ntk_t*  Th_NtkReadThb         ( char * );
+
 //===threProfile.c================================//
 
 extern void       Th_ProfileInit        ();
@@ -171,24 +336,72 @@ extern void       Th_ProfilePrint       ();
 
 //===threCNF.c================================//
 
-extern void       func_EC_writeCNF      ( Abc_Ntk_t * , Vec_Ptr_t * , char * );
+extern int        func_EC_writeCNF      ( Abc_Ntk_t * , Vec_Ptr_t * , char * , int , int , int , int );
 extern void       delete_sortedNode     ( Thre_S * );
 extern void       my_Vec_StrPrintNum    ( Vec_Str_t * , int );
 extern Thre_S*    slow_sortByAbsWeights ( Thre_S* );
 extern int        Thre_LocalMax         (Thre_S* , int );
 extern int        Thre_LocalMin         (Thre_S* , int );
 
+//===threCnfEnc.c================================//
+
+extern Th_CnfMan_t* Th_CnfManStart      ( Th_Out_t * , int , int , int );
+extern void       Th_CnfManStop         ( Th_CnfMan_t * );
+extern int        Th_CnfManVarNum       ( Th_CnfMan_t * );
+extern int        Th_CnfManClauseNum    ( Th_CnfMan_t * );
+extern int        Th_CnfManConflictNum  ( Th_CnfMan_t * );
+extern void       Th_CnfManPrintStats   ( Th_CnfMan_t * );
+extern void       Th_CnfWriteObj        ( Th_CnfMan_t * , Thre_S * , Vec_Int_t * , int );
+extern void       Th_CnfWriteXor        ( Th_CnfMan_t * , int , int , int );
+extern void       Th_CnfManAddClause    ( Th_CnfMan_t * , int * , int );
+extern int        Th_CnfManSolve        ( Th_CnfMan_t * , int , int );
+extern int        Th_CnfManSolveAssume  ( Th_CnfMan_t * , int * , int , int );
+extern int        Th_CnfManVarValue     ( Th_CnfMan_t * , int );
+
 //===thresholdNZ.c================================//
 
-extern void       func_EC_compareTH     ( Vec_Ptr_t * , Vec_Ptr_t * );
-extern void       func_CNF_compareTH    ( Vec_Ptr_t * , Vec_Ptr_t * );
+extern int        func_EC_compareTH     ( Vec_Ptr_t * , Vec_Ptr_t * , char * , int , int , int );
+extern int        func_CNF_compareTH    ( Vec_Ptr_t * , Vec_Ptr_t * , char * , int , int , int , int );
+
+//===threSplit.c================================//
+
+extern int        Th_SplitCompare       ( Vec_Ptr_t * , Vec_Ptr_t * , Vec_Ptr_t * , int , int , int , int , int );
+
+//===threSim.c================================//
+
+extern Vec_Int_t* Th_SimOrder           ( Vec_Ptr_t * );
+extern void       Th_SimObj             ( Thre_S * , word * , int );
+extern void       Th_SimObjFans         ( Thre_S * , word ** , word * , int );
+extern Vec_Wrd_t* Th_SimNtk             ( Vec_Ptr_t * , word * , int );
+extern int        Th_SimCompare         ( Vec_Ptr_t * , Vec_Ptr_t * , char * , int , Vec_Ptr_t * );
+extern void       Th_SimPrintCex        ( Vec_Ptr_t * , Vec_Ptr_t * );
+extern int        Th_SimKernelAvail     ( int );
+extern char*      Th_SimKernelName      ( int );
+extern int        Th_SimCexCheck        ( Vec_Ptr_t * , Vec_Ptr_t * , char * , int );
+extern Vec_Wrd_t* Th_SimSignature       ( Vec_Ptr_t * , int );
+extern void       Th_SimBench           ( Vec_Ptr_t * , int , int , int );
+
+//===threCert.c================================//
+
+extern int        Th_CollapseCheck      ( const Thre_S * , const Thre_S * , const Thre_S * );
+
+//===threFraig.c================================//
+
+extern int        Th_NtkFraig           ( Vec_Ptr_t * , int , int , int , int );
 
 //===threKLCollapse.c================================//
 
-extern void       Th_CollapseNtk         ( Vec_Ptr_t * , int , int );
-extern void       Th_CollapseNtk_tcad    ( Vec_Ptr_t * , int , int );
+extern void       Th_CollapseNtk         ( Vec_Ptr_t * , int , int , int );
+extern void       Th_CollapseNtk_tcad    ( Vec_Ptr_t * , int , int , int );
+extern void       Th_CollapseNtkWorklist ( Vec_Ptr_t * , int , int , int );
+extern void       Th_CollapseNtkPriority ( Vec_Ptr_t * , int , int );
 extern void       Th_NtkDfs              ();
 extern int        Th_ObjIsFanin          ( const Thre_S * , int );
+extern void       Th_NtkBuildFanioIndex  ( Vec_Ptr_t * );
+extern void       Th_ObjFreeFanioIndex   ( Thre_S * );
+extern void       Th_ObjFaninMapStart    ( Vec_Int_t * , const Thre_S * );
+extern void       Th_ObjFaninMapStop     ( Vec_Int_t * , const Thre_S * );
+extern int        Th_ObjFaninMapFind     ( Vec_Int_t * , int );
 
 //===threTh2Blif.c===================================//
 
@@ -200,18 +413,18 @@ extern Abc_Ntk_t* Th_Ntk2Mux             ( Vec_Ptr_t * , int , int );
 
 //===threThPG.c====================================//
 
-extern void Th_PBPGEncoding              ( Vec_Ptr_t * , int );
+extern void Th_PBPGEncoding              ( Vec_Ptr_t * , int , char * );
 
 //===threCalKL.c====================================//
 
 extern Pair_S*    Th_CalKLIf             ( const Thre_S * , const Thre_S * , int , int , int );
-extern Pair_S*    Th_CalKLDP             ( const Thre_S * , const Thre_S * , int , int , int );
+extern Pair_S*    Th_CalKLDP             ( const Thre_S * , const Thre_S * , int , int , int , Vec_Wrd_t * );
 
 //===threMultiFout.c====================================//
 
-extern int Th_Check2FoutCollapse         ( const Thre_S * , const Thre_S * , int );
-extern int Th_CheckMultiFoutCollapse     ( const Thre_S * , int );
-extern int Th_CheckPairCollapse          ( const Thre_S * , const Thre_S * , int );
+extern int Th_Check2FoutCollapse         ( const Thre_S * , const Thre_S * , int , Vec_Wrd_t * , Vec_Int_t * );
+extern int Th_CheckMultiFoutCollapse     ( const Thre_S * , int , int , Vec_Wrd_t * , Vec_Int_t * );
+extern int Th_CheckPairCollapse          ( const Thre_S * , const Thre_S * , int , Vec_Wrd_t * , Vec_Int_t * );
 
 #endif
 
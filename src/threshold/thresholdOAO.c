@@ -64,6 +64,7 @@ void th_SimplifyNode( Thre_S* tObj )
                 for( j = i; j < size; ++j )
                     if( Vec_IntEntry( newGate->weights, j ) == current_w )
                         Vec_IntWriteEntry( newGate->weights, j, current_w -1 );
+                Th_ObjSumInvalidate( newGate );
             }
             else if( current_w < -1 ){
                 if(newGate->thre != 0)
@@ -71,6 +72,7 @@ void th_SimplifyNode( Thre_S* tObj )
                 for( j = i; j < size; ++j )
                     if( Vec_IntEntry( newGate->weights, j ) == current_w )
                         Vec_IntWriteEntry( newGate->weights, j, current_w +1 );
+                Th_ObjSumInvalidate( newGate );
             }
             else{
                 Vec_IntFree( w_backup );
@@ -82,6 +84,7 @@ void th_SimplifyNode( Thre_S* tObj )
                 newGate->thre = t_backup;
                 Vec_IntFree(newGate->weights);
                 newGate->weights = Vec_IntDup( w_backup );
+                Th_ObjSumInvalidate( newGate );
                 Vec_IntFree( w_backup );
                 break;
             }
@@ -92,6 +95,7 @@ void th_SimplifyNode( Thre_S* tObj )
         Vec_IntFree(tObj->weights);
         tObj->weights = Vec_IntDup(newGate->weights);
         tObj->thre    = newGate->thre;
+        Th_ObjSumInvalidate( tObj );
     }
     Th_DeleteObjNoInsert(newGate);  
     Vec_StrFree(onSet);